@@ -1,21 +1,64 @@
 #pragma once
 
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
 #include <fstream>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace Il2CppDumper {
 
+// Immutable after Load: any number of threads may query one instance concurrently without external locking.
+// index2 is read through a shared read-only mapping, or with positional reads plus a per-thread block cache.
 class RvaIndexLookup {
 public:
+    // Written to outLines by FindClosestLowerOrEqualLines when a query has no lower-or-equal record.
+    static constexpr uint32_t kNoLine = 0xFFFFFFFFu;
+
+    RvaIndexLookup() = default;
+    ~RvaIndexLookup();
+    RvaIndexLookup(const RvaIndexLookup&) = delete;
+    RvaIndexLookup& operator=(const RvaIndexLookup&) = delete;
+
     // Load index1/index2 files and prepare in-memory routing table from index1.
+    // index2 is memory-mapped where the platform allows it; otherwise blocks are read and decoded on demand.
+    // Not thread-safe with respect to concurrent queries on the same instance.
     bool Load(const std::string& index1Path, const std::string& index2Path, std::string* error = nullptr);
 
     // Finds the mapped value whose RVA is the greatest RVA <= queryRva.
     // v1/v2 indexes map to dump.cs line numbers, v3+ maps to dump.cs byte offsets.
     // Returns false if no such line exists.
     bool FindClosestLowerOrEqualLine(uint64_t queryRva, uint32_t* outLine) const;
+
+    // Batch variant of FindClosestLowerOrEqualLine. Queries are resolved in ascending RVA order in one pass over
+    // the blocks; outLines[i] receives the result for queryRvas[i], or kNoLine when there is none.
+    // Returns the number of queries that resolved.
+    size_t FindClosestLowerOrEqualLines(const uint64_t* queryRvas, size_t count, uint32_t* outLines) const;
+
+    // True when index2 carries the reverse section (after its last block, found through a trailer) that
+    // FindRvaForDumpOffset needs. Plain v3 files without it still answer RVA queries.
+    bool HasReverseIndex() const { return offsetRecords_ != nullptr; }
+    // True when index2 also carries the opt-in method name section used by FindRvasByMethodName.
+    bool HasMethodNames() const { return nameEntries_ != nullptr; }
+
+    // Finds the record whose dump.cs offset is the greatest offset <= dumpOffset, i.e. the method whose RVA line
+    // starts at or before that position, by binary search over the reverse section.
+    // outRecordOffset, when non-null, receives that record's dump.cs offset. Returns false if there is none.
+    bool FindRvaForDumpOffset(uint32_t dumpOffset, uint64_t* outRva, uint32_t* outRecordOffset = nullptr) const;
+
+    // Looks up a method by name: "Namespace.Type.Method" (with generic parameters as written in dump.cs, e.g.
+    // "Method<T>") or a generic instance line such as "List<T><int>.Add". Overloads and instances sharing a name
+    // all match. outRvas receives their RVAs in dump.cs order. Returns the number of matches, 0 without a name table.
+    size_t FindRvasByMethodName(std::string_view name, std::vector<uint64_t>* outRvas) const;
+
+    // Number of decoded blocks each thread keeps when index2 is not memory-resident (default 16, minimum 1).
+    // Call before sharing the instance between threads.
+    void SetBlockCacheCapacity(size_t blocks);
+    // True when index2 is memory-resident (mapped or fully loaded) and lookups decode nothing.
+    bool IsMapped() const { return mappedIndex2_ != nullptr; }
     uint32_t GetTotalDumpLines() const { return totalDumpLines_; }
 
 private:
@@ -30,9 +73,54 @@ private:
         std::vector<uint32_t> lines;
     };
 
-    bool EnsureIndex2Open(std::string* error) const;
+    struct CachedBlock {
+        size_t blockIndex = static_cast<size_t>(-1);
+        uint64_t lastUse = 0;
+        DecodedBlock block;
+    };
+
+    // One instance's blocks in a thread's cache; ownerId 0 marks an unused slot.
+    struct ThreadBlockCache {
+        uint64_t ownerId = 0;
+        uint64_t lastUse = 0;
+        std::vector<CachedBlock> blocks;
+    };
+
+    // Per-thread caches for this many instances, so a thread alternating between indexes keeps both warm.
+    static constexpr size_t kThreadCacheSlots = 4;
+
+    // Sequential reader over one block's records, either straight from the mapping or from a decoded block.
+    struct BlockCursor {
+        size_t blockIndex = static_cast<size_t>(-1);
+        const uint8_t* mappedRecords = nullptr;
+        const DecodedBlock* decoded = nullptr;
+        uint32_t recordCount = 0;
+        uint32_t startLine = 0;
+        uint64_t startRva = 0;
+        // Index and RVA of the last record known to be <= the current query, valid when position > 0.
+        uint32_t position = 0;
+        uint64_t rva = 0;
+        uint32_t line = 0;
+    };
+
+    size_t FindBlockForRva(uint64_t queryRva, size_t firstCandidate) const;
+    bool OpenBlock(size_t blockIndex, BlockCursor* cursor, std::string* error) const;
+    // Applies the decoded path's checks (RVAs never decrease) to a block read in place; done once per block.
+    bool CheckMappedBlock(size_t blockIndex, const uint8_t* records, uint32_t recordCount, uint64_t startRva,
+                          std::string* error) const;
+    bool FloorInBlock(BlockCursor* cursor, uint64_t queryRva, uint32_t* outLine) const;
+    bool LastLineOfBlock(size_t blockIndex, uint32_t* outLine) const;
+    bool Resolve(uint64_t queryRva, size_t* blockHint, BlockCursor* cursor, uint32_t* outLine) const;
+
+    bool LoadReverseSections(std::string* error);
+    bool OpenIndex2(std::string* error);
+    void CloseIndex2();
+    bool ReadAt(uint64_t offset, uint8_t* dst, size_t size) const;
+    const DecodedBlock* GetDecodedBlock(size_t blockIndex, std::string* error) const;
     bool LoadDecodedBlock(size_t blockIndex, DecodedBlock* outBlock, std::string* error) const;
 
+    // Same hash as SwitchPort::DefinitionCache::HashName, which the index writer uses for the name section.
+    static uint64_t HashName(std::string_view name);
     static uint16_t ReadLe16(const uint8_t* p);
     static uint32_t ReadLe32(const uint8_t* p);
     static uint64_t ReadLe64(const uint8_t* p);
@@ -44,14 +132,35 @@ private:
     std::string index2Path_;
     uint32_t totalDumpLines_ = 0;
 
-    // Mutable for cheap repeated lookups from a const query API.
-    mutable std::ifstream index2Stream_;
-    mutable bool index2OpenAttempted_ = false;
-    mutable std::string lastError_;
+    // Read-only view of the whole index2 file (a mapping, or index2Buffer_ where mmap is unavailable);
+    // records are scanned in place.
+    const uint8_t* mappedIndex2_ = nullptr;
+    size_t mappedIndex2Size_ = 0;
+    bool ownsMapping_ = false;
+    std::vector<char> index2Buffer_;
+    // Descriptor and size for positional reads when the file could not be mapped.
+    int index2Fd_ = -1;
+    uint64_t index2FileSize_ = 0;
+    // Per mapped block: 0 not checked yet, 1 valid, 2 corrupt. Relaxed atomics: a check is idempotent, so two
+    // threads racing on one block only repeat work.
+    std::unique_ptr<std::atomic<uint8_t>[]> blockChecks_;
+
+    // Trailer sections, pointing into the index2 view or into reverseBuffer_ when index2 is read on demand.
+    std::vector<uint8_t> reverseBuffer_;
+    const uint8_t* offsetRecords_ = nullptr;
+    uint32_t offsetCount_ = 0;
+    const uint8_t* nameBuckets_ = nullptr;
+    const uint8_t* nameEntries_ = nullptr;
+    const uint8_t* nameRefs_ = nullptr;
+    const uint8_t* nameStrings_ = nullptr;
+    uint32_t nameBucketBits_ = 0;
+    uint32_t nameCount_ = 0;
+    uint32_t nameRefCount_ = 0;
+    uint32_t nameStringBytes_ = 0;
 
-    // Single-block cache keeps hot queries fast with minimal memory.
-    mutable size_t cachedBlockIndex_ = static_cast<size_t>(-1);
-    mutable DecodedBlock cachedBlock_;
+    // Identifies this Load in the per-thread block caches; unique for the life of the process.
+    uint64_t instanceId_ = 0;
+    size_t blockCacheCapacity_ = 16;
 };
 
 } // namespace Il2CppDumper
@@ -2,7 +2,18 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <cstring>
 #include <limits>
+#include <numeric>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define IL2CPPDUMPER_HAVE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 namespace Il2CppDumper {
 
@@ -13,20 +24,31 @@ constexpr std::array<uint8_t, 4> kIndex2Magic = {'I', 'D', 'X', '2'};
 constexpr uint16_t kVersion1 = 1;
 constexpr uint16_t kVersion2 = 2;
 constexpr uint16_t kVersion3 = 3;
+constexpr size_t kBlockHeaderSize = 16;
+constexpr size_t kBlockRecordSize = 8;
+constexpr size_t kIndex2HeaderSize = 16;
+constexpr std::array<uint8_t, 4> kTrailerMagic = {'I', 'D', 'X', 'R'};
+constexpr size_t kTrailerSize = 48;
+constexpr size_t kOffsetRecordSize = 12; // u32 dump offset, u64 RVA
+constexpr size_t kNameEntrySize = 24;
+constexpr uint32_t kMaxNameBucketBits = 24;
+constexpr size_t kNoBlock = static_cast<size_t>(-1);
+
+std::atomic<uint64_t> gNextInstanceId{1};
 
 } // namespace
 
+RvaIndexLookup::~RvaIndexLookup() {
+    CloseIndex2();
+}
+
 bool RvaIndexLookup::Load(const std::string& index1Path, const std::string& index2Path, std::string* error) {
     index1Entries_.clear();
     index2Path_.clear();
-    if (index2Stream_.is_open()) {
-        index2Stream_.close();
-    }
-    index2OpenAttempted_ = false;
-    lastError_.clear();
     totalDumpLines_ = 0;
-    cachedBlockIndex_ = static_cast<size_t>(-1);
-    cachedBlock_ = {};
+    CloseIndex2();
+    // A fresh id invalidates every thread's cached blocks from a previous Load.
+    instanceId_ = gNextInstanceId.fetch_add(1, std::memory_order_relaxed);
 
     std::ifstream f(index1Path, std::ios::binary);
     if (!f) {
@@ -45,7 +67,7 @@ bool RvaIndexLookup::Load(const std::string& index1Path, const std::string& inde
     }
 
     const uint16_t version = ReadLe16(header.data() + 4);
-    if (version != kVersion1 && version != kVersion2 && version != kVersion3) {
+    if (version < kVersion1 || version > kVersion3) {
         SetError(error, "Unsupported index1 version");
         return false;
     }
@@ -81,22 +103,30 @@ bool RvaIndexLookup::Load(const std::string& index1Path, const std::string& inde
     }
 
     index2Path_ = index2Path;
-    if (!EnsureIndex2Open(error)) {
+    if (!OpenIndex2(error)) {
         index1Entries_.clear();
         index2Path_.clear();
         return false;
     }
 
+    if (mappedIndex2_ != nullptr) {
+        blockChecks_.reset(new std::atomic<uint8_t>[index1Entries_.size()]);
+        for (size_t i = 0; i < index1Entries_.size(); ++i) {
+            blockChecks_[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
     std::array<uint8_t, 12> idx2HeaderBase{};
-    index2Stream_.seekg(0, std::ios::beg);
-    if (!ReadFully(index2Stream_, idx2HeaderBase.data(), idx2HeaderBase.size())) {
+    if (!ReadAt(0, idx2HeaderBase.data(), idx2HeaderBase.size())) {
         SetError(error, "Failed to read index2 header");
+        CloseIndex2();
         index1Entries_.clear();
         index2Path_.clear();
         return false;
     }
     if (!std::equal(kIndex2Magic.begin(), kIndex2Magic.end(), idx2HeaderBase.begin())) {
         SetError(error, "index2 magic mismatch (expected IDX2)");
+        CloseIndex2();
         index1Entries_.clear();
         index2Path_.clear();
         return false;
@@ -104,16 +134,18 @@ bool RvaIndexLookup::Load(const std::string& index1Path, const std::string& inde
 
     const uint16_t idx2Version = ReadLe16(idx2HeaderBase.data() + 4);
     const uint32_t blockCount = ReadLe32(idx2HeaderBase.data() + 8);
-    if (idx2Version != kVersion1 && idx2Version != kVersion2 && idx2Version != kVersion3) {
+    if (idx2Version < kVersion1 || idx2Version > kVersion3) {
         SetError(error, "Unsupported index2 version");
+        CloseIndex2();
         index1Entries_.clear();
         index2Path_.clear();
         return false;
     }
     if (idx2Version >= kVersion2) {
         std::array<uint8_t, 4> totalLinesBuf{};
-        if (!ReadFully(index2Stream_, totalLinesBuf.data(), totalLinesBuf.size())) {
+        if (!ReadAt(idx2HeaderBase.size(), totalLinesBuf.data(), totalLinesBuf.size())) {
             SetError(error, "Failed to read index2 total_dump_lines");
+            CloseIndex2();
             index1Entries_.clear();
             index2Path_.clear();
             return false;
@@ -122,6 +154,13 @@ bool RvaIndexLookup::Load(const std::string& index1Path, const std::string& inde
     }
     if (blockCount != index1Entries_.size()) {
         SetError(error, "index1 entry count does not match index2 block count");
+        CloseIndex2();
+        index1Entries_.clear();
+        index2Path_.clear();
+        return false;
+    }
+    if (idx2Version >= kVersion3 && !LoadReverseSections(error)) {
+        CloseIndex2();
         index1Entries_.clear();
         index2Path_.clear();
         return false;
@@ -130,43 +169,222 @@ bool RvaIndexLookup::Load(const std::string& index1Path, const std::string& inde
     return true;
 }
 
-bool RvaIndexLookup::FindClosestLowerOrEqualLine(uint64_t queryRva, uint32_t* outLine) const {
-    if (outLine == nullptr || index1Entries_.empty()) {
+bool RvaIndexLookup::LoadReverseSections(std::string* error) {
+    // The sections are optional: a file without the trailer is a plain v3 index and only answers RVA queries.
+    const uint64_t fileSize = (mappedIndex2_ != nullptr) ? mappedIndex2Size_ : index2FileSize_;
+    if (fileSize < kIndex2HeaderSize + kTrailerSize) {
+        return true;
+    }
+    std::array<uint8_t, kTrailerSize> trailer{};
+    if (!ReadAt(fileSize - kTrailerSize, trailer.data(), trailer.size())) {
+        SetError(error, "Failed to read index2 trailer");
         return false;
     }
-    if (queryRva < index1Entries_.front().startRva) {
+    if (!std::equal(kTrailerMagic.begin(), kTrailerMagic.end(), trailer.end() - kTrailerMagic.size()) ||
+        ReadLe32(trailer.data() + 40) != kTrailerSize) {
+        return true;
+    }
+    const uint64_t offsetsAt = ReadLe64(trailer.data());
+    const uint32_t offsetCount = ReadLe32(trailer.data() + 8);
+    const uint32_t nameBucketBits = ReadLe32(trailer.data() + 12);
+    const uint64_t namesAt = ReadLe64(trailer.data() + 16);
+    const uint32_t nameCount = ReadLe32(trailer.data() + 24);
+    const uint32_t nameRefCount = ReadLe32(trailer.data() + 28);
+    const uint32_t nameStringBytes = ReadLe32(trailer.data() + 32);
+    if (nameBucketBits > kMaxNameBucketBits) {
+        SetError(error, "Corrupt index2: method name table is too large");
         return false;
     }
 
-    const auto it = std::upper_bound(
-        index1Entries_.begin(), index1Entries_.end(), queryRva,
-        [](uint64_t value, const Index1Entry& entry) { return value < entry.startRva; });
-    if (it == index1Entries_.begin()) {
+    // Everything is checked against the file before anything is sized from the trailer. Offsets are rejected
+    // first so that each later step can subtract from sectionsEnd without wrapping.
+    const uint64_t sectionsEnd = fileSize - kTrailerSize;
+    if (offsetsAt < kIndex2HeaderSize || offsetsAt > sectionsEnd || namesAt > sectionsEnd) {
+        SetError(error, "Corrupt index2: sections outside file");
         return false;
     }
+    const uint64_t offsetBytes = static_cast<uint64_t>(offsetCount) * kOffsetRecordSize;
+    if (offsetBytes > sectionsEnd - offsetsAt) {
+        SetError(error, "Corrupt index2: sections outside file");
+        return false;
+    }
+    const uint64_t offsetsEnd = offsetsAt + offsetBytes;
+    uint64_t entriesAt = 0;
+    uint64_t refsAt = 0;
+    uint64_t stringsAt = 0;
+    uint64_t namesEnd = offsetsEnd;
+    if (namesAt != 0) {
+        if (namesAt < offsetsEnd) {
+            SetError(error, "Corrupt index2: overlapping sections");
+            return false;
+        }
+        const uint64_t bucketBytes = ((uint64_t{1} << nameBucketBits) + 1) * 4;
+        const uint64_t entryBytes = static_cast<uint64_t>(nameCount) * kNameEntrySize;
+        const uint64_t refBytes = static_cast<uint64_t>(nameRefCount) * 4;
+        if (bucketBytes > sectionsEnd - namesAt || entryBytes > sectionsEnd - (namesAt + bucketBytes) ||
+            refBytes > sectionsEnd - (namesAt + bucketBytes + entryBytes) ||
+            nameStringBytes > sectionsEnd - (namesAt + bucketBytes + entryBytes + refBytes)) {
+            SetError(error, "Corrupt index2: sections outside file");
+            return false;
+        }
+        entriesAt = namesAt + bucketBytes;
+        refsAt = entriesAt + entryBytes;
+        stringsAt = refsAt + refBytes;
+        namesEnd = stringsAt + nameStringBytes;
+    } else if (nameCount != 0 || nameRefCount != 0 || nameStringBytes != 0) {
+        SetError(error, "Corrupt index2: method name counts without a name table");
+        return false;
+    }
+
+    // The sections are compact and sit at the end of index2, so read them whole when index2 is not mapped.
+    const uint8_t* sections = nullptr; // the byte at offsetsAt
+    if (mappedIndex2_ != nullptr) {
+        sections = mappedIndex2_ + offsetsAt;
+    } else {
+        reverseBuffer_.resize(static_cast<size_t>(namesEnd - offsetsAt));
+        if (!ReadAt(offsetsAt, reverseBuffer_.data(), reverseBuffer_.size())) {
+            reverseBuffer_.clear();
+            SetError(error, "Failed reading index2 sections");
+            return false;
+        }
+        sections = reverseBuffer_.data();
+    }
+    offsetRecords_ = sections;
+    offsetCount_ = offsetCount;
+    if (namesAt != 0) {
+        nameBuckets_ = sections + (namesAt - offsetsAt);
+        nameEntries_ = sections + (entriesAt - offsetsAt);
+        nameRefs_ = sections + (refsAt - offsetsAt);
+        nameStrings_ = sections + (stringsAt - offsetsAt);
+        nameBucketBits_ = nameBucketBits;
+        nameCount_ = nameCount;
+        nameRefCount_ = nameRefCount;
+        nameStringBytes_ = nameStringBytes;
+    }
+    return true;
+}
 
-    size_t blockIndex = static_cast<size_t>(std::distance(index1Entries_.begin(), it) - 1);
+void RvaIndexLookup::SetBlockCacheCapacity(size_t blocks) {
+    blockCacheCapacity_ = std::max<size_t>(1, blocks);
+    // Threads trim their caches to the new capacity on their next miss; cached blocks stay valid.
+}
 
-    std::string error;
-    DecodedBlock block;
-    if (!LoadDecodedBlock(blockIndex, &block, &error)) {
+bool RvaIndexLookup::FindClosestLowerOrEqualLine(uint64_t queryRva, uint32_t* outLine) const {
+    if (outLine == nullptr) {
+        return false;
+    }
+    size_t blockHint = 0;
+    BlockCursor cursor;
+    return Resolve(queryRva, &blockHint, &cursor, outLine);
+}
+
+size_t RvaIndexLookup::FindClosestLowerOrEqualLines(const uint64_t* queryRvas, size_t count, uint32_t* outLines) const {
+    if (queryRvas == nullptr || outLines == nullptr || count == 0) {
+        return 0;
+    }
+    std::vector<size_t> order(count);
+    std::iota(order.begin(), order.end(), size_t{0});
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return queryRvas[a] < queryRvas[b]; });
+
+    // Sorted queries only ever move forward through index1 and through each block's records.
+    size_t resolved = 0;
+    size_t blockHint = 0;
+    BlockCursor cursor;
+    for (size_t i : order) {
+        uint32_t line = 0;
+        if (Resolve(queryRvas[i], &blockHint, &cursor, &line)) {
+            outLines[i] = line;
+            ++resolved;
+        } else {
+            outLines[i] = kNoLine;
+        }
+    }
+    return resolved;
+}
+
+bool RvaIndexLookup::FindRvaForDumpOffset(uint32_t dumpOffset, uint64_t* outRva, uint32_t* outRecordOffset) const {
+    if (outRva == nullptr || offsetRecords_ == nullptr) {
+        return false;
+    }
+    // Count of records at or before dumpOffset; the last of them is the answer.
+    uint32_t lo = 0;
+    uint32_t hi = offsetCount_;
+    while (lo < hi) {
+        const uint32_t mid = lo + (hi - lo) / 2;
+        if (ReadLe32(offsetRecords_ + static_cast<size_t>(mid) * kOffsetRecordSize) <= dumpOffset) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo == 0) {
         return false;
     }
+    const uint8_t* record = offsetRecords_ + static_cast<size_t>(lo - 1) * kOffsetRecordSize;
+    *outRva = ReadLe64(record + 4);
+    if (outRecordOffset != nullptr) {
+        *outRecordOffset = ReadLe32(record);
+    }
+    return true;
+}
 
-    auto floorInBlock = [&](const DecodedBlock& b, uint32_t* out) -> bool {
-        if (b.rvas.empty()) {
-            return false;
+size_t RvaIndexLookup::FindRvasByMethodName(std::string_view name, std::vector<uint64_t>* outRvas) const {
+    if (outRvas == nullptr) {
+        return 0;
+    }
+    outRvas->clear();
+    if (nameEntries_ == nullptr) {
+        return 0;
+    }
+    const uint64_t hash = HashName(name);
+    const uint32_t bucket = nameBucketBits_ == 0 ? 0 : static_cast<uint32_t>(hash >> (64 - nameBucketBits_));
+    const uint32_t first = ReadLe32(nameBuckets_ + static_cast<size_t>(bucket) * 4);
+    const uint32_t last = std::min(ReadLe32(nameBuckets_ + (static_cast<size_t>(bucket) + 1) * 4), nameCount_);
+    for (uint32_t i = first; i < last; ++i) {
+        const uint8_t* entry = nameEntries_ + static_cast<size_t>(i) * kNameEntrySize;
+        const uint64_t entryHash = ReadLe64(entry);
+        if (entryHash > hash) {
+            break;
+        }
+        const uint32_t nameOffset = ReadLe32(entry + 8);
+        const uint32_t nameLength = ReadLe32(entry + 12);
+        if (entryHash != hash || nameLength != name.size() ||
+            static_cast<uint64_t>(nameOffset) + nameLength > nameStringBytes_ ||
+            std::memcmp(nameStrings_ + nameOffset, name.data(), name.size()) != 0) {
+            continue;
         }
-        const auto bit = std::upper_bound(b.rvas.begin(), b.rvas.end(), queryRva);
-        if (bit == b.rvas.begin()) {
+        const uint32_t firstRef = ReadLe32(entry + 16);
+        const uint32_t refCount = ReadLe32(entry + 20);
+        if (static_cast<uint64_t>(firstRef) + refCount > nameRefCount_) {
+            return 0;
+        }
+        for (uint32_t r = 0; r < refCount; ++r) {
+            const uint32_t position = ReadLe32(nameRefs_ + static_cast<size_t>(firstRef + r) * 4);
+            if (position < offsetCount_) {
+                outRvas->push_back(ReadLe64(offsetRecords_ + static_cast<size_t>(position) * kOffsetRecordSize + 4));
+            }
+        }
+        return outRvas->size();
+    }
+    return 0;
+}
+
+bool RvaIndexLookup::Resolve(uint64_t queryRva, size_t* blockHint, BlockCursor* cursor, uint32_t* outLine) const {
+    if (index1Entries_.empty() || queryRva < index1Entries_.front().startRva) {
+        return false;
+    }
+
+    const size_t blockIndex = FindBlockForRva(queryRva, *blockHint);
+    *blockHint = blockIndex;
+    if (cursor->blockIndex != blockIndex) {
+        std::string error;
+        if (!OpenBlock(blockIndex, cursor, &error)) {
+            cursor->blockIndex = kNoBlock;
             return false;
         }
-        const size_t i = static_cast<size_t>(std::distance(b.rvas.begin(), bit) - 1);
-        *out = b.lines[i];
-        return true;
-    };
+    }
 
-    if (floorInBlock(block, outLine)) {
+    if (FloorInBlock(cursor, queryRva, outLine)) {
         return true;
     }
 
@@ -175,37 +393,245 @@ bool RvaIndexLookup::FindClosestLowerOrEqualLine(uint64_t queryRva, uint32_t* ou
     if (blockIndex == 0) {
         return false;
     }
+    const bool found = LastLineOfBlock(blockIndex - 1, outLine);
+    if (mappedIndex2_ == nullptr) {
+        // Loading the previous block may have evicted the one the cursor points into.
+        cursor->blockIndex = kNoBlock;
+    }
+    return found;
+}
 
-    DecodedBlock prevBlock;
-    if (!LoadDecodedBlock(blockIndex - 1, &prevBlock, &error)) {
+size_t RvaIndexLookup::FindBlockForRva(uint64_t queryRva, size_t firstCandidate) const {
+    if (firstCandidate >= index1Entries_.size() || queryRva < index1Entries_[firstCandidate].startRva) {
+        firstCandidate = 0;
+    }
+    const auto it = std::upper_bound(
+        index1Entries_.begin() + static_cast<std::ptrdiff_t>(firstCandidate), index1Entries_.end(), queryRva,
+        [](uint64_t value, const Index1Entry& entry) { return value < entry.startRva; });
+    return static_cast<size_t>(std::distance(index1Entries_.begin(), it) - 1);
+}
+
+bool RvaIndexLookup::OpenBlock(size_t blockIndex, BlockCursor* cursor, std::string* error) const {
+    if (blockIndex >= index1Entries_.size()) {
+        SetError(error, "Block index out of range");
         return false;
     }
-    if (prevBlock.lines.empty()) {
+    *cursor = BlockCursor{};
+    if (mappedIndex2_ != nullptr) {
+        const Index1Entry& e = index1Entries_[blockIndex];
+        if (e.index2Size < kBlockHeaderSize || e.index2Offset > mappedIndex2Size_ ||
+            e.index2Size > mappedIndex2Size_ - e.index2Offset) {
+            SetError(error, "Corrupt block: outside index2 file");
+            return false;
+        }
+        const uint8_t* block = mappedIndex2_ + e.index2Offset;
+        const uint32_t recordCount = ReadLe32(block + 12);
+        if (kBlockHeaderSize + static_cast<uint64_t>(recordCount) * kBlockRecordSize != e.index2Size) {
+            SetError(error, "Corrupt block: record count does not match block size");
+            return false;
+        }
+        if (!CheckMappedBlock(blockIndex, block + kBlockHeaderSize, recordCount, ReadLe64(block), error)) {
+            return false;
+        }
+        cursor->mappedRecords = block + kBlockHeaderSize;
+        cursor->startRva = ReadLe64(block);
+        cursor->startLine = ReadLe32(block + 8);
+        cursor->recordCount = recordCount;
+    } else {
+        const DecodedBlock* decoded = GetDecodedBlock(blockIndex, error);
+        if (decoded == nullptr) {
+            return false;
+        }
+        cursor->decoded = decoded;
+        cursor->recordCount = static_cast<uint32_t>(decoded->rvas.size());
+    }
+    cursor->blockIndex = blockIndex;
+    return true;
+}
+
+bool RvaIndexLookup::CheckMappedBlock(size_t blockIndex, const uint8_t* records, uint32_t recordCount,
+                                      uint64_t startRva, std::string* error) const {
+    constexpr uint8_t kUnchecked = 0;
+    constexpr uint8_t kValid = 1;
+    constexpr uint8_t kCorrupt = 2;
+    std::atomic<uint8_t>& state = blockChecks_[blockIndex];
+    uint8_t known = state.load(std::memory_order_relaxed);
+    if (known == kUnchecked) {
+        known = kValid;
+        uint64_t rva = startRva;
+        for (uint32_t i = 0; i < recordCount; ++i) {
+            const uint64_t next = rva + ReadLe32(records + static_cast<size_t>(i) * kBlockRecordSize);
+            if (next < rva) {
+                known = kCorrupt;
+                break;
+            }
+            rva = next;
+        }
+        state.store(known, std::memory_order_relaxed);
+    }
+    if (known == kCorrupt) {
+        SetError(error, "Corrupt block: RVAs are not sorted");
         return false;
     }
+    return true;
+}
+
+bool RvaIndexLookup::FloorInBlock(BlockCursor* cursor, uint64_t queryRva, uint32_t* outLine) const {
+    if (cursor->decoded != nullptr) {
+        const auto& rvas = cursor->decoded->rvas;
+        const auto begin = rvas.begin() + static_cast<std::ptrdiff_t>(cursor->position);
+        const auto it = std::upper_bound(begin, rvas.end(), queryRva);
+        cursor->position = static_cast<uint32_t>(std::distance(rvas.begin(), it));
+        if (cursor->position == 0) {
+            return false;
+        }
+        *outLine = cursor->decoded->lines[cursor->position - 1];
+        return true;
+    }
 
-    *outLine = prevBlock.lines.back();
+    // Records are delta-encoded, so walk them in place from the last position instead of decoding the block.
+    while (cursor->position < cursor->recordCount) {
+        const uint8_t* record = cursor->mappedRecords + static_cast<size_t>(cursor->position) * kBlockRecordSize;
+        const uint64_t base = (cursor->position == 0) ? cursor->startRva : cursor->rva;
+        const uint64_t nextRva = base + ReadLe32(record); // OpenBlock checked that the deltas do not wrap
+        if (nextRva > queryRva) {
+            break;
+        }
+        const uint32_t absoluteLine = ReadLe32(record + 4);
+        // first record line can be written either as startLine or absolute value
+        cursor->line = (cursor->position == 0 && absoluteLine == 0) ? cursor->startLine : absoluteLine;
+        cursor->rva = nextRva;
+        ++cursor->position;
+    }
+    if (cursor->position == 0) {
+        return false;
+    }
+    *outLine = cursor->line;
     return true;
 }
 
-bool RvaIndexLookup::EnsureIndex2Open(std::string* error) const {
-    if (index2Stream_.is_open()) {
+bool RvaIndexLookup::LastLineOfBlock(size_t blockIndex, uint32_t* outLine) const {
+    if (mappedIndex2_ != nullptr) {
+        BlockCursor cursor;
+        std::string error;
+        if (!OpenBlock(blockIndex, &cursor, &error) || cursor.recordCount == 0) {
+            return false;
+        }
+        const uint8_t* last = cursor.mappedRecords + static_cast<size_t>(cursor.recordCount - 1) * kBlockRecordSize;
+        const uint32_t absoluteLine = ReadLe32(last + 4);
+        *outLine = (cursor.recordCount == 1 && absoluteLine == 0) ? cursor.startLine : absoluteLine;
         return true;
     }
-    if (index2OpenAttempted_) {
-        SetError(error, lastError_);
+    std::string error;
+    const DecodedBlock* block = GetDecodedBlock(blockIndex, &error);
+    if (block == nullptr || block->lines.empty()) {
         return false;
     }
+    *outLine = block->lines.back();
+    return true;
+}
 
-    index2OpenAttempted_ = true;
-    index2Stream_.open(index2Path_, std::ios::binary);
-    if (!index2Stream_) {
-        lastError_ = "Failed to open index2 file: " + index2Path_;
-        SetError(error, lastError_);
+bool RvaIndexLookup::OpenIndex2(std::string* error) {
+#ifdef IL2CPPDUMPER_HAVE_MMAP
+    const int fd = ::open(index2Path_.c_str(), O_RDONLY);
+    if (fd < 0) {
+        SetError(error, "Failed to open index2 file: " + index2Path_);
         return false;
     }
+    struct stat st {};
+    if (::fstat(fd, &st) != 0 || st.st_size < 0) {
+        ::close(fd);
+        SetError(error, "Failed to query index2 file size: " + index2Path_);
+        return false;
+    }
+    void* mapping = (st.st_size > 0)
+                        ? ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0)
+                        : MAP_FAILED;
+    if (mapping != MAP_FAILED) {
+        ::close(fd);
+        mappedIndex2_ = static_cast<const uint8_t*>(mapping);
+        mappedIndex2Size_ = static_cast<size_t>(st.st_size);
+        ownsMapping_ = true;
+        return true;
+    }
+    // Keep the descriptor for positional reads; pread does not share a file position between threads.
+    index2Fd_ = fd;
+    index2FileSize_ = static_cast<uint64_t>(st.st_size);
+    return true;
+#else
+    // No mmap here: index2 is compact (8 bytes per RVA), so hold it in memory and scan it like a mapping.
+    std::ifstream f(index2Path_, std::ios::binary);
+    if (!f) {
+        SetError(error, "Failed to open index2 file: " + index2Path_);
+        return false;
+    }
+    index2Buffer_.assign(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+    if (f.bad()) {
+        index2Buffer_.clear();
+        SetError(error, "Failed to read index2 file: " + index2Path_);
+        return false;
+    }
+    mappedIndex2_ = reinterpret_cast<const uint8_t*>(index2Buffer_.data());
+    mappedIndex2Size_ = index2Buffer_.size();
+    return true;
+#endif
+}
+
+void RvaIndexLookup::CloseIndex2() {
+#ifdef IL2CPPDUMPER_HAVE_MMAP
+    if (ownsMapping_ && mappedIndex2_ != nullptr) {
+        ::munmap(const_cast<uint8_t*>(mappedIndex2_), mappedIndex2Size_);
+    }
+    if (index2Fd_ >= 0) {
+        ::close(index2Fd_);
+    }
+#endif
+    index2Fd_ = -1;
+    index2FileSize_ = 0;
+    blockChecks_.reset();
+    ownsMapping_ = false;
+    mappedIndex2_ = nullptr;
+    mappedIndex2Size_ = 0;
+    index2Buffer_.clear();
+    index2Buffer_.shrink_to_fit();
+    reverseBuffer_.clear();
+    reverseBuffer_.shrink_to_fit();
+    offsetRecords_ = nullptr;
+    offsetCount_ = 0;
+    nameBuckets_ = nullptr;
+    nameEntries_ = nullptr;
+    nameRefs_ = nullptr;
+    nameStrings_ = nullptr;
+    nameBucketBits_ = 0;
+    nameCount_ = 0;
+    nameRefCount_ = 0;
+    nameStringBytes_ = 0;
+}
 
+bool RvaIndexLookup::ReadAt(uint64_t offset, uint8_t* dst, size_t size) const {
+    if (mappedIndex2_ != nullptr) {
+        if (offset > mappedIndex2Size_ || size > mappedIndex2Size_ - offset) {
+            return false;
+        }
+        std::memcpy(dst, mappedIndex2_ + offset, size);
+        return true;
+    }
+#ifdef IL2CPPDUMPER_HAVE_MMAP
+    if (index2Fd_ < 0) {
+        return false;
+    }
+    size_t done = 0;
+    while (done < size) {
+        const ssize_t got = ::pread(index2Fd_, dst + done, size - done, static_cast<off_t>(offset + done));
+        if (got <= 0) {
+            return false;
+        }
+        done += static_cast<size_t>(got);
+    }
     return true;
+#else
+    return false;
+#endif
 }
 
 bool RvaIndexLookup::LoadDecodedBlock(size_t blockIndex, DecodedBlock* outBlock, std::string* error) const {
@@ -217,14 +643,6 @@ bool RvaIndexLookup::LoadDecodedBlock(size_t blockIndex, DecodedBlock* outBlock,
         SetError(error, "Block index out of range");
         return false;
     }
-    if (!EnsureIndex2Open(error)) {
-        return false;
-    }
-
-    if (cachedBlockIndex_ == blockIndex) {
-        *outBlock = cachedBlock_;
-        return true;
-    }
 
     const Index1Entry& e = index1Entries_[blockIndex];
     if (e.index2Size < 16) {
@@ -233,9 +651,7 @@ bool RvaIndexLookup::LoadDecodedBlock(size_t blockIndex, DecodedBlock* outBlock,
     }
 
     std::vector<uint8_t> buf(e.index2Size);
-    index2Stream_.clear();
-    index2Stream_.seekg(static_cast<std::streamoff>(e.index2Offset), std::ios::beg);
-    if (!ReadFully(index2Stream_, buf.data(), buf.size())) {
+    if (!ReadAt(e.index2Offset, buf.data(), buf.size())) {
         SetError(error, "Failed reading index2 block");
         return false;
     }
@@ -277,12 +693,73 @@ bool RvaIndexLookup::LoadDecodedBlock(size_t blockIndex, DecodedBlock* outBlock,
         return false;
     }
 
-    cachedBlockIndex_ = blockIndex;
-    cachedBlock_ = decoded;
-    *outBlock = decoded;
+    *outBlock = std::move(decoded);
     return true;
 }
 
+const RvaIndexLookup::DecodedBlock* RvaIndexLookup::GetDecodedBlock(size_t blockIndex, std::string* error) const {
+    // Each thread keeps its own LRU per instance, so concurrent lookups never share mutable state.
+    thread_local std::array<ThreadBlockCache, kThreadCacheSlots> caches;
+    thread_local uint64_t clock = 0;
+    ++clock;
+    ThreadBlockCache* owner = nullptr;
+    for (auto& candidate : caches) {
+        if (candidate.ownerId == instanceId_) {
+            owner = &candidate;
+            break;
+        }
+    }
+    if (owner == nullptr) {
+        // Take over the slot used least recently; it may belong to an instance that no longer exists.
+        owner = &*std::min_element(caches.begin(), caches.end(),
+                                   [](const ThreadBlockCache& a, const ThreadBlockCache& b) {
+                                       return a.lastUse < b.lastUse;
+                                   });
+        owner->ownerId = instanceId_;
+        owner->blocks.clear();
+    }
+    ThreadBlockCache& cache = *owner;
+    cache.lastUse = clock;
+    for (auto& slot : cache.blocks) {
+        if (slot.blockIndex == blockIndex) {
+            slot.lastUse = clock;
+            return &slot.block;
+        }
+    }
+
+    DecodedBlock decoded;
+    if (!LoadDecodedBlock(blockIndex, &decoded, error)) {
+        return nullptr;
+    }
+    if (cache.blocks.size() > blockCacheCapacity_) {
+        cache.blocks.resize(blockCacheCapacity_);
+    }
+    CachedBlock* slot = nullptr;
+    if (cache.blocks.size() < blockCacheCapacity_) {
+        cache.blocks.emplace_back();
+        slot = &cache.blocks.back();
+    } else {
+        slot = &*std::min_element(cache.blocks.begin(), cache.blocks.end(),
+                                  [](const CachedBlock& a, const CachedBlock& b) { return a.lastUse < b.lastUse; });
+    }
+    slot->blockIndex = blockIndex;
+    slot->lastUse = clock;
+    slot->block = std::move(decoded);
+    return &slot->block;
+}
+
+uint64_t RvaIndexLookup::HashName(std::string_view name) {
+    uint64_t hash = 1469598103934665603ull;
+    for (const char c : name) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 1099511628211ull;
+    }
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdull;
+    hash ^= hash >> 33;
+    return hash;
+}
+
 uint16_t RvaIndexLookup::ReadLe16(const uint8_t* p) {
     return static_cast<uint16_t>(p[0] | (static_cast<uint16_t>(p[1]) << 8));
 }
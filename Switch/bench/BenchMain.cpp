@@ -0,0 +1,479 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "Il2CppDumper/RvaIndexLookup.h"
+#include "SwitchPort/DefinitionCache.h"
+#include "SwitchPort/DumpWriter.h"
+#include "SwitchPort/ElfImage.h"
+#include "SwitchPort/MetadataFile.h"
+#include "SwitchPort/RegistrationFinder.h"
+#include "SwitchPort/RuntimeTypeSystem.h"
+#include "SwitchPort/TypeIndex.h"
+#include "SyntheticCorpus.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+void PrintUsage() {
+    std::printf(
+        "usage:\n"
+        "  switch_il2cpp_bench generate <dir> [--images N] [--types-per-image N] [--methods-per-type N]\n"
+        "                                     [--fields-per-type N] [--generic-insts N] [--seed N]\n"
+        "  switch_il2cpp_bench run <dir> [--iterations N] [--only NAME] [--workers N] [--csv PATH]\n"
+        "\n"
+        "<dir> holds global-metadata.dat and main.elf (from generate, or copied from a real title).\n");
+}
+
+bool ParseNumber(const char* text, uint64_t* out) {
+    char* end = nullptr;
+    const unsigned long long value = std::strtoull(text, &end, 0);
+    if (end == text || *end != '\0') {
+        return false;
+    }
+    *out = value;
+    return true;
+}
+
+// Everything one stage needs, built outside the timed region.
+struct BenchContext {
+    fs::path inputDir;
+    fs::path scratchDir;
+    fs::path metadataPath;
+    fs::path elfPath;
+    unsigned workers = 1;
+    SwitchPort::MetadataFile metadata;
+    SwitchPort::ElfImage elf;
+    SwitchPort::RegistrationResult regs;
+    std::unique_ptr<SwitchPort::RuntimeTypeSystem> runtimeTypes;
+    SwitchPort::DumpIndex dumpIndex;
+    std::vector<uint64_t> queries;
+    // Paths of one full set of outputs in scratchDir.
+    fs::path dumpPath;
+    fs::path index1Path;
+    fs::path index2Path;
+    fs::path definitionCachePath;
+    fs::path definitionIndexPath;
+    fs::path namespaceOffsetsPath;
+    fs::path typeIndexPath;
+    fs::path typeIndex3Path;
+};
+
+struct BenchCase {
+    const char* name;
+    // Run before every timed iteration; not measured.
+    std::function<bool(BenchContext&, std::string*)> setup;
+    std::function<bool(BenchContext&, std::string*)> body;
+};
+
+struct BenchResult {
+    std::string name;
+    std::vector<double> samplesMs;
+    double MinMs() const { return *std::min_element(samplesMs.begin(), samplesMs.end()); }
+    double MedianMs() const {
+        std::vector<double> sorted = samplesMs;
+        std::sort(sorted.begin(), sorted.end());
+        const size_t mid = sorted.size() / 2;
+        return (sorted.size() % 2 != 0) ? sorted[mid] : (sorted[mid - 1] + sorted[mid]) / 2.0;
+    }
+    double MeanMs() const {
+        double sum = 0.0;
+        for (const double s : samplesMs) {
+            sum += s;
+        }
+        return sum / static_cast<double>(samplesMs.size());
+    }
+};
+
+bool WriteDump(BenchContext& ctx, SwitchPort::DumpIndex* index, std::string* error) {
+    return SwitchPort::WriteDumpCs(ctx.metadata, ctx.runtimeTypes.get(), &ctx.elf, ctx.regs.codeRegistration,
+                                   ctx.dumpPath.string(), ctx.workers, index, nullptr, nullptr, error);
+}
+
+bool WriteAuxiliary(BenchContext& ctx, SwitchPort::DumpIndex& index, std::string* error) {
+    return SwitchPort::WriteDumpAuxiliaryFiles(index, ctx.dumpPath.string(), ctx.index1Path.string(),
+                                               ctx.index2Path.string(), ctx.definitionCachePath.string(),
+                                               ctx.definitionIndexPath.string(), ctx.namespaceOffsetsPath.string(),
+                                               ctx.typeIndexPath.string(), ctx.typeIndex3Path.string(), error);
+}
+
+// WriteDumpAuxiliaryFiles sorts the index in place, so every run works on a copy of the entries. Their names stay in
+// source's arena, which outlives the copy.
+void CopyIndexEntries(const SwitchPort::DumpIndex& source, SwitchPort::DumpIndex* copy) {
+    copy->definitions = source.definitions;
+    copy->namespaceOffsets = source.namespaceOffsets;
+    copy->typeInfos = source.typeInfos;
+    copy->rvaRecords = source.rvaRecords;
+    copy->methodNames = source.methodNames;
+    copy->totalDumpLines = source.totalDumpLines;
+    copy->collectMethodNames = source.collectMethodNames;
+}
+
+// Loads the corpus once and produces the outputs later stages consume, so every case can run on its own.
+bool PrepareContext(BenchContext& ctx, std::string* error) {
+    if (!ctx.metadata.Load(ctx.metadataPath.string(), error) || !ctx.elf.Load(ctx.elfPath.string(), error)) {
+        return false;
+    }
+    const double version = static_cast<double>(ctx.metadata.Header().version);
+    SwitchPort::RegistrationFinder finder(ctx.elf);
+    ctx.regs = finder.Find(version, static_cast<int>(ctx.metadata.Types().size()),
+                           static_cast<int>(ctx.metadata.Images().size()));
+    if (ctx.regs.codeRegistration == 0 || ctx.regs.metadataRegistration == 0) {
+        *error = "CodeRegistration/MetadataRegistration not found in " + ctx.elfPath.string();
+        return false;
+    }
+    ctx.runtimeTypes = std::make_unique<SwitchPort::RuntimeTypeSystem>();
+    if (!ctx.runtimeTypes->Load(ctx.elf, ctx.regs.metadataRegistration, version, error)) {
+        return false;
+    }
+    std::error_code ec;
+    fs::create_directories(ctx.scratchDir, ec);
+    ctx.dumpPath = ctx.scratchDir / "dump.cs";
+    ctx.index1Path = ctx.scratchDir / "index1.bin";
+    ctx.index2Path = ctx.scratchDir / "index2.bin";
+    ctx.definitionCachePath = ctx.scratchDir / "dumpcs_definition_cache.txt";
+    ctx.definitionIndexPath = ctx.scratchDir / "dumpcs_definition_cache.bin";
+    ctx.namespaceOffsetsPath = ctx.scratchDir / "dumpcs_namespace_offsets.bin";
+    ctx.typeIndexPath = ctx.scratchDir / "dumpcs_type_index.bin";
+    ctx.typeIndex3Path = ctx.scratchDir / "dumpcs_type_index3.bin";
+    // The method_name_lookup case needs the opt-in method name section.
+    ctx.dumpIndex.collectMethodNames = true;
+    if (!WriteDump(ctx, &ctx.dumpIndex, error)) {
+        return false;
+    }
+    SwitchPort::DumpIndex index;
+    CopyIndexEntries(ctx.dumpIndex, &index);
+    if (!WriteAuxiliary(ctx, index, error)) {
+        return false;
+    }
+
+    // Every indexed RVA, plus one just past it, in a fixed shuffled order so single lookups do not walk
+    // the blocks sequentially.
+    for (const auto& record : ctx.dumpIndex.rvaRecords) {
+        ctx.queries.push_back(record.rva);
+        ctx.queries.push_back(record.rva + 2);
+    }
+    uint64_t state = 0x2545f4914f6cdd1dull;
+    for (size_t i = ctx.queries.size(); i > 1; --i) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        std::swap(ctx.queries[i - 1], ctx.queries[static_cast<size_t>(state % i)]);
+    }
+    return true;
+}
+
+std::vector<BenchCase> BuildCases() {
+    auto none = [](BenchContext&, std::string*) { return true; };
+    std::vector<BenchCase> cases;
+    cases.push_back({"metadata_load", none, [](BenchContext& ctx, std::string* error) {
+                         SwitchPort::MetadataFile metadata;
+                         return metadata.Load(ctx.metadataPath.string(), error);
+                     }});
+    cases.push_back({"elf_load", none, [](BenchContext& ctx, std::string* error) {
+                         SwitchPort::ElfImage elf;
+                         return elf.Load(ctx.elfPath.string(), error);
+                     }});
+    cases.push_back({"registration_find", none, [](BenchContext& ctx, std::string* error) {
+                         SwitchPort::RegistrationFinder finder(ctx.elf);
+                         const SwitchPort::RegistrationResult regs =
+                             finder.Find(static_cast<double>(ctx.metadata.Header().version),
+                                         static_cast<int>(ctx.metadata.Types().size()),
+                                         static_cast<int>(ctx.metadata.Images().size()), ctx.workers);
+                         if (regs.codeRegistration != ctx.regs.codeRegistration ||
+                             regs.metadataRegistration != ctx.regs.metadataRegistration) {
+                             *error = "registration search returned a different result";
+                             return false;
+                         }
+                         return true;
+                     }});
+    cases.push_back({"runtime_types_load", none, [](BenchContext& ctx, std::string* error) {
+                         SwitchPort::RuntimeTypeSystem runtimeTypes;
+                         return runtimeTypes.Load(ctx.elf, ctx.regs.metadataRegistration,
+                                                  static_cast<double>(ctx.metadata.Header().version), error);
+                     }});
+    cases.push_back({"write_dump_cs", none, [](BenchContext& ctx, std::string* error) {
+                         SwitchPort::DumpIndex index;
+                         return WriteDump(ctx, &index, error);
+                     }});
+    cases.push_back({"write_aux_files", none, [](BenchContext& ctx, std::string* error) {
+                         SwitchPort::DumpIndex index;
+                         CopyIndexEntries(ctx.dumpIndex, &index);
+                         return WriteAuxiliary(ctx, index, error);
+                     }});
+    cases.push_back({"build_aux_files", none, [](BenchContext& ctx, std::string* error) {
+                         return SwitchPort::BuildDumpAuxiliaryFiles(
+                             ctx.dumpPath.string(), ctx.index1Path.string(), ctx.index2Path.string(),
+                             ctx.definitionCachePath.string(), ctx.definitionIndexPath.string(),
+                             ctx.namespaceOffsetsPath.string(), ctx.typeIndexPath.string(),
+                             ctx.typeIndex3Path.string(), ctx.dumpIndex.collectMethodNames, error);
+                     }});
+    cases.push_back({"definition_lookup", none, [](BenchContext& ctx, std::string* error) {
+                         SwitchPort::DefinitionCache cache;
+                         if (!cache.Open(ctx.definitionIndexPath.string(), error)) {
+                             return false;
+                         }
+                         size_t missing = 0;
+                         for (const auto& definition : ctx.dumpIndex.definitions) {
+                             missing += cache.Find(definition.first).empty() ? 1u : 0u;
+                         }
+                         if (missing != 0) {
+                             *error = "Definition lookups missed " + std::to_string(missing) + " names";
+                             return false;
+                         }
+                         return true;
+                     }});
+    cases.push_back({"type_lookup", none, [](BenchContext& ctx, std::string* error) {
+                         SwitchPort::TypeIndex types;
+                         if (!types.Open(ctx.typeIndex3Path.string(), error)) {
+                             return false;
+                         }
+                         size_t missing = 0;
+                         size_t unlinked = 0;
+                         for (const auto& info : ctx.dumpIndex.typeInfos) {
+                             const auto found = types.FindByFullName(info.fullName);
+                             if (found.empty()) {
+                                 ++missing;
+                                 continue;
+                             }
+                             const auto derived = types.DerivedTypes(found[0]);
+                             for (size_t i = 0; i < derived.size(); ++i) {
+                                 unlinked += types.GetType(derived[i]).baseType != found[0] ? 1u : 0u;
+                             }
+                         }
+                         if (missing != 0 || unlinked != 0) {
+                             *error = "Type lookups missed " + std::to_string(missing) + " names and " +
+                                      std::to_string(unlinked) + " base links";
+                             return false;
+                         }
+                         return true;
+                     }});
+    cases.push_back({"rva_lookup_single", none, [](BenchContext& ctx, std::string* error) {
+                         Il2CppDumper::RvaIndexLookup lookup;
+                         if (!lookup.Load(ctx.index1Path.string(), ctx.index2Path.string(), error)) {
+                             return false;
+                         }
+                         size_t resolved = 0;
+                         for (const uint64_t rva : ctx.queries) {
+                             uint32_t line = 0;
+                             resolved += lookup.FindClosestLowerOrEqualLine(rva, &line) ? 1u : 0u;
+                         }
+                         if (resolved != ctx.queries.size()) {
+                             *error = "RVA lookups left " + std::to_string(ctx.queries.size() - resolved) + " unresolved";
+                             return false;
+                         }
+                         return true;
+                     }});
+    cases.push_back({"rva_lookup_batch", none, [](BenchContext& ctx, std::string* error) {
+                         Il2CppDumper::RvaIndexLookup lookup;
+                         if (!lookup.Load(ctx.index1Path.string(), ctx.index2Path.string(), error)) {
+                             return false;
+                         }
+                         std::vector<uint32_t> lines(ctx.queries.size());
+                         const size_t resolved =
+                             lookup.FindClosestLowerOrEqualLines(ctx.queries.data(), ctx.queries.size(), lines.data());
+                         if (resolved != ctx.queries.size()) {
+                             *error = "RVA lookups left " + std::to_string(ctx.queries.size() - resolved) + " unresolved";
+                             return false;
+                         }
+                         return true;
+                     }});
+    cases.push_back({"rva_reverse_lookup", none, [](BenchContext& ctx, std::string* error) {
+                         Il2CppDumper::RvaIndexLookup lookup;
+                         if (!lookup.Load(ctx.index1Path.string(), ctx.index2Path.string(), error)) {
+                             return false;
+                         }
+                         size_t resolved = 0;
+                         for (const auto& record : ctx.dumpIndex.rvaRecords) {
+                             uint64_t rva = 0;
+                             resolved += lookup.FindRvaForDumpOffset(record.dumpOffset + 4, &rva) ? 1u : 0u;
+                         }
+                         if (resolved != ctx.dumpIndex.rvaRecords.size()) {
+                             *error = "Offset lookups left " +
+                                      std::to_string(ctx.dumpIndex.rvaRecords.size() - resolved) + " unresolved";
+                             return false;
+                         }
+                         return true;
+                     }});
+    cases.push_back({"method_name_lookup", none, [](BenchContext& ctx, std::string* error) {
+                         Il2CppDumper::RvaIndexLookup lookup;
+                         if (!lookup.Load(ctx.index1Path.string(), ctx.index2Path.string(), error)) {
+                             return false;
+                         }
+                         size_t missing = 0;
+                         std::vector<uint64_t> rvas;
+                         for (const auto& method : ctx.dumpIndex.methodNames) {
+                             missing += lookup.FindRvasByMethodName(method.first, &rvas) == 0 ? 1u : 0u;
+                         }
+                         if (missing != 0) {
+                             *error = "Method name lookups missed " + std::to_string(missing) + " names";
+                             return false;
+                         }
+                         return true;
+                     }});
+    return cases;
+}
+
+int RunGenerate(int argc, char** argv) {
+    if (argc < 3) {
+        PrintUsage();
+        return 2;
+    }
+    SwitchPort::SyntheticCorpusOptions options;
+    for (int i = 3; i < argc; i += 2) {
+        const std::string flag = argv[i];
+        uint64_t value = 0;
+        if (i + 1 >= argc || !ParseNumber(argv[i + 1], &value)) {
+            std::fprintf(stderr, "missing or invalid value for %s\n", flag.c_str());
+            return 2;
+        }
+        if (flag == "--images") {
+            options.images = static_cast<uint32_t>(value);
+        } else if (flag == "--types-per-image") {
+            options.typesPerImage = static_cast<uint32_t>(value);
+        } else if (flag == "--methods-per-type") {
+            options.methodsPerType = static_cast<uint32_t>(value);
+        } else if (flag == "--fields-per-type") {
+            options.fieldsPerType = static_cast<uint32_t>(value);
+        } else if (flag == "--generic-insts") {
+            options.genericInsts = static_cast<uint32_t>(value);
+        } else if (flag == "--seed") {
+            options.seed = value;
+        } else {
+            std::fprintf(stderr, "unknown option %s\n", flag.c_str());
+            return 2;
+        }
+    }
+    SwitchPort::SyntheticCorpusInfo info;
+    std::string error;
+    if (!SwitchPort::GenerateSyntheticCorpus(argv[2], options, &info, &error)) {
+        std::fprintf(stderr, "generate failed: %s\n", error.c_str());
+        return 1;
+    }
+    std::printf("types=%zu methods=%zu fields=%zu runtime_types=%zu method_specs=%zu\n", info.types, info.methods,
+                info.fields, info.runtimeTypes, info.methodSpecs);
+    std::printf("CodeRegistration=0x%llX MetadataRegistration=0x%llX\n",
+                static_cast<unsigned long long>(info.codeRegistration),
+                static_cast<unsigned long long>(info.metadataRegistration));
+    return 0;
+}
+
+int RunBench(int argc, char** argv) {
+    if (argc < 3) {
+        PrintUsage();
+        return 2;
+    }
+    BenchContext ctx;
+    ctx.inputDir = argv[2];
+    ctx.metadataPath = ctx.inputDir / "global-metadata.dat";
+    ctx.elfPath = ctx.inputDir / "main.elf";
+    ctx.scratchDir = ctx.inputDir / "bench_out";
+    ctx.workers = SwitchPort::DefaultDumpWorkerCount();
+    uint64_t iterations = 5;
+    std::string only;
+    std::string csvPath;
+    for (int i = 3; i < argc; i += 2) {
+        const std::string flag = argv[i];
+        if (i + 1 >= argc) {
+            std::fprintf(stderr, "missing value for %s\n", flag.c_str());
+            return 2;
+        }
+        uint64_t value = 0;
+        if (flag == "--only") {
+            only = argv[i + 1];
+        } else if (flag == "--csv") {
+            csvPath = argv[i + 1];
+        } else if ((flag == "--iterations" || flag == "--workers") && ParseNumber(argv[i + 1], &value) && value > 0) {
+            if (flag == "--iterations") {
+                iterations = value;
+            } else {
+                ctx.workers = static_cast<unsigned>(value);
+            }
+        } else {
+            std::fprintf(stderr, "unknown or invalid option %s\n", flag.c_str());
+            return 2;
+        }
+    }
+
+    std::vector<BenchCase> cases;
+    for (BenchCase& benchCase : BuildCases()) {
+        if (only.empty() || only == benchCase.name) {
+            cases.push_back(std::move(benchCase));
+        }
+    }
+    if (cases.empty()) {
+        std::fprintf(stderr, "no benchmark named %s\n", only.c_str());
+        return 2;
+    }
+
+    std::string error;
+    if (!PrepareContext(ctx, &error)) {
+        std::fprintf(stderr, "setup failed: %s\n", error.c_str());
+        return 1;
+    }
+    std::printf("corpus: %zu types, %zu methods, %zu indexed RVAs, %zu queries; %llu iterations, %u workers\n",
+                ctx.metadata.Types().size(), ctx.metadata.Methods().size(), ctx.dumpIndex.rvaRecords.size(),
+                ctx.queries.size(), static_cast<unsigned long long>(iterations), ctx.workers);
+
+    std::vector<BenchResult> results;
+    for (const BenchCase& benchCase : cases) {
+        BenchResult result;
+        result.name = benchCase.name;
+        for (uint64_t i = 0; i < iterations; ++i) {
+            if (!benchCase.setup(ctx, &error)) {
+                std::fprintf(stderr, "%s setup failed: %s\n", benchCase.name, error.c_str());
+                return 1;
+            }
+            const auto start = std::chrono::steady_clock::now();
+            const bool ok = benchCase.body(ctx, &error);
+            const auto end = std::chrono::steady_clock::now();
+            if (!ok) {
+                std::fprintf(stderr, "%s failed: %s\n", benchCase.name, error.c_str());
+                return 1;
+            }
+            result.samplesMs.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+        }
+        std::printf("%-24s min %10.3f ms  median %10.3f ms  mean %10.3f ms\n", result.name.c_str(), result.MinMs(),
+                    result.MedianMs(), result.MeanMs());
+        results.push_back(std::move(result));
+    }
+
+    if (!csvPath.empty()) {
+        std::ofstream csv(csvPath, std::ios::binary | std::ios::trunc);
+        csv << "name,iterations,min_ms,median_ms,mean_ms\n";
+        for (const BenchResult& result : results) {
+            char line[160];
+            std::snprintf(line, sizeof(line), "%s,%zu,%.3f,%.3f,%.3f\n", result.name.c_str(), result.samplesMs.size(),
+                          result.MinMs(), result.MedianMs(), result.MeanMs());
+            csv << line;
+        }
+        if (!csv) {
+            std::fprintf(stderr, "failed to write %s\n", csvPath.c_str());
+            return 1;
+        }
+    }
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc >= 2 && std::string(argv[1]) == "generate") {
+        return RunGenerate(argc, argv);
+    }
+    if (argc >= 2 && std::string(argv[1]) == "run") {
+        return RunBench(argc, argv);
+    }
+    PrintUsage();
+    return 2;
+}
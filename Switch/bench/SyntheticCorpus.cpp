@@ -0,0 +1,1369 @@
+#include "SyntheticCorpus.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <set>
+#include <system_error>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace SwitchPort {
+
+namespace {
+
+constexpr int32_t kMetadataVersion = 29;
+constexpr uint32_t kMetadataMagic = 0xFAB11BAFu;
+constexpr size_t kMetadataHeaderBytes = 8 + 8 * 33;
+
+constexpr uint8_t kTypeVoid = 0x01;
+constexpr uint8_t kTypeBoolean = 0x02;
+constexpr uint8_t kTypeChar = 0x03;
+constexpr uint8_t kTypeI1 = 0x04;
+constexpr uint8_t kTypeU1 = 0x05;
+constexpr uint8_t kTypeI2 = 0x06;
+constexpr uint8_t kTypeU2 = 0x07;
+constexpr uint8_t kTypeI4 = 0x08;
+constexpr uint8_t kTypeU4 = 0x09;
+constexpr uint8_t kTypeI8 = 0x0a;
+constexpr uint8_t kTypeU8 = 0x0b;
+constexpr uint8_t kTypeR4 = 0x0c;
+constexpr uint8_t kTypeR8 = 0x0d;
+constexpr uint8_t kTypeString = 0x0e;
+constexpr uint8_t kTypePtr = 0x0f;
+constexpr uint8_t kTypeValueType = 0x11;
+constexpr uint8_t kTypeClass = 0x12;
+constexpr uint8_t kTypeArray = 0x14;
+constexpr uint8_t kTypeGenericInst = 0x15;
+constexpr uint8_t kTypeObject = 0x1c;
+constexpr uint8_t kTypeSzArray = 0x1d;
+constexpr uint8_t kTypeMVar = 0x1e;
+
+constexpr uint32_t kTextBaseBytes = 0x40000;
+constexpr uint32_t kPageBytes = 0x1000;
+constexpr uint32_t kArm64Ret = 0xd65f03c0u;
+
+// splitmix64: tiny, and unlike <random> distributions it yields the same sequence with every standard library.
+class Rng {
+public:
+    explicit Rng(uint64_t seed) : state_(seed) {}
+
+    uint64_t Next() {
+        uint64_t z = (state_ += 0x9e3779b97f4a7c15ull);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+    // Uniform in [0, bound); bound must be nonzero.
+    uint64_t Below(uint64_t bound) { return Next() % bound; }
+    // Uniform in [lo, hi].
+    int64_t Range(int64_t lo, int64_t hi) { return lo + static_cast<int64_t>(Below(static_cast<uint64_t>(hi - lo) + 1)); }
+    double Unit() { return static_cast<double>(Next() >> 11) * (1.0 / 9007199254740992.0); }
+    bool Chance(double p) { return Unit() < p; }
+    template <typename T>
+    const T& Pick(const std::vector<T>& values) {
+        return values[static_cast<size_t>(Below(values.size()))];
+    }
+
+private:
+    uint64_t state_;
+};
+
+void PutU8(std::vector<uint8_t>* out, uint8_t v) {
+    out->push_back(v);
+}
+
+void PutU16(std::vector<uint8_t>* out, uint16_t v) {
+    out->push_back(static_cast<uint8_t>(v & 0xffu));
+    out->push_back(static_cast<uint8_t>(v >> 8));
+}
+
+void PutU32(std::vector<uint8_t>* out, uint32_t v) {
+    for (int i = 0; i < 4; ++i) {
+        out->push_back(static_cast<uint8_t>((v >> (8 * i)) & 0xffu));
+    }
+}
+
+void PutI32(std::vector<uint8_t>* out, int32_t v) {
+    PutU32(out, static_cast<uint32_t>(v));
+}
+
+void PutU64(std::vector<uint8_t>* out, uint64_t v) {
+    for (int i = 0; i < 8; ++i) {
+        out->push_back(static_cast<uint8_t>((v >> (8 * i)) & 0xffu));
+    }
+}
+
+void StoreU32(std::vector<uint8_t>* out, size_t offset, uint32_t v) {
+    for (int i = 0; i < 4; ++i) {
+        (*out)[offset + static_cast<size_t>(i)] = static_cast<uint8_t>((v >> (8 * i)) & 0xffu);
+    }
+}
+
+void StoreU64(std::vector<uint8_t>* out, size_t offset, uint64_t v) {
+    for (int i = 0; i < 8; ++i) {
+        (*out)[offset + static_cast<size_t>(i)] = static_cast<uint8_t>((v >> (8 * i)) & 0xffu);
+    }
+}
+
+// ECMA-335 style compressed integers as used by il2cpp v29 attribute blobs and default values.
+void PutCompressedU32(std::vector<uint8_t>* out, uint32_t v) {
+    if (v < 0x80u) {
+        PutU8(out, static_cast<uint8_t>(v));
+    } else if (v < 0x4000u) {
+        PutU8(out, static_cast<uint8_t>(0x80u | (v >> 8)));
+        PutU8(out, static_cast<uint8_t>(v & 0xffu));
+    } else if (v < 0x20000000u) {
+        PutU8(out, static_cast<uint8_t>(0xC0u | (v >> 24)));
+        PutU8(out, static_cast<uint8_t>((v >> 16) & 0xffu));
+        PutU8(out, static_cast<uint8_t>((v >> 8) & 0xffu));
+        PutU8(out, static_cast<uint8_t>(v & 0xffu));
+    } else {
+        PutU8(out, 0xF0u);
+        PutU32(out, v);
+    }
+}
+
+void PutCompressedI32(std::vector<uint8_t>* out, int32_t v) {
+    const uint32_t encoded = (v >= 0) ? (static_cast<uint32_t>(v) << 1)
+                                      : ((static_cast<uint32_t>(-(v + 1)) << 1) | 1u);
+    PutCompressedU32(out, encoded);
+}
+
+void PutBlobString(std::vector<uint8_t>* out, const std::string& value) {
+    PutCompressedI32(out, static_cast<int32_t>(value.size()));
+    out->insert(out->end(), value.begin(), value.end());
+}
+
+class StringTable {
+public:
+    uint32_t Add(const std::string& value) {
+        const auto found = offsets_.find(value);
+        if (found != offsets_.end()) {
+            return found->second;
+        }
+        const uint32_t offset = static_cast<uint32_t>(bytes_.size());
+        bytes_.insert(bytes_.end(), value.begin(), value.end());
+        bytes_.push_back(0);
+        offsets_.emplace(value, offset);
+        return offset;
+    }
+    std::string At(uint32_t offset) const { return std::string(reinterpret_cast<const char*>(bytes_.data() + offset)); }
+    const std::vector<uint8_t>& Bytes() const { return bytes_; }
+
+private:
+    std::vector<uint8_t> bytes_;
+    std::unordered_map<std::string, uint32_t> offsets_;
+};
+
+enum class TypeKind { Core, Class, Struct, Enum, Interface, Generic, Nested };
+
+// Where an Il2CppType's data field points.
+enum class TypeDataKind { Value, Element, ArrayOf, GenericClass };
+
+struct TypeData {
+    TypeDataKind kind = TypeDataKind::Value;
+    uint64_t value = 0; // Value: raw data (type definition / generic parameter index)
+    size_t ref = 0;     // Element/ArrayOf: extra type; GenericClass: type definition
+    uint32_t extra = 0; // ArrayOf: rank; GenericClass: generic inst
+
+    auto Key() const { return std::make_tuple(static_cast<int>(kind), value, ref, extra); }
+};
+
+struct RuntimeTypeSpec {
+    uint8_t type = 0;
+    TypeData data;
+    uint16_t attrs = 0;
+    uint8_t byref = 0;
+};
+
+struct TypeDefSpec {
+    size_t image = 0;
+    TypeKind kind = TypeKind::Class;
+    uint32_t name = 0;
+    uint32_t ns = 0;
+    int32_t byvalType = -1;
+    int32_t declaring = -1;
+    int32_t parent = -1;
+    int32_t element = -1;
+    int32_t genericContainer = -1;
+    uint32_t flags = 0;
+    uint32_t bitfield = 0;
+    uint32_t token = 0;
+    int32_t fieldStart = 0;
+    int32_t methodStart = 0;
+    int32_t propertyStart = 0;
+    int32_t nestedStart = 0;
+    int32_t interfaceStart = 0;
+    uint16_t fieldCount = 0;
+    uint16_t methodCount = 0;
+    uint16_t propertyCount = 0;
+    uint16_t nestedCount = 0;
+    uint16_t interfaceCount = 0;
+    uint32_t genericArgc = 0;
+};
+
+struct ImageSpec {
+    uint32_t name = 0;
+    int32_t typeStart = 0;
+    uint32_t typeCount = 0;
+    int32_t attributeStart = 0;
+    uint32_t attributeCount = 0;
+};
+
+struct MethodSpecDef {
+    uint32_t name = 0;
+    int32_t declaring = 0;
+    int32_t returnType = 0;
+    int32_t parameterStart = -1;
+    int32_t genericContainer = -1;
+    uint32_t token = 0;
+    uint16_t flags = 0;
+    uint16_t slot = 0xFFFF;
+    uint16_t parameterCount = 0;
+    size_t image = 0;
+};
+
+struct FieldSpec {
+    uint32_t name = 0;
+    int32_t type = 0;
+    uint32_t token = 0;
+};
+
+struct ParameterSpec {
+    uint32_t name = 0;
+    int32_t type = 0;
+};
+
+struct PropertySpec {
+    uint32_t name = 0;
+    int32_t get = -1;
+    int32_t set = -1;
+    uint32_t token = 0;
+};
+
+struct GenericParameterSpec {
+    int32_t owner = 0;
+    uint32_t name = 0;
+    uint16_t num = 0;
+};
+
+struct GenericContainerSpec {
+    int32_t owner = 0;
+    int32_t argc = 0;
+    int32_t isMethod = 0;
+    int32_t parameterStart = 0;
+};
+
+struct DefaultValueSpec {
+    int32_t owner = 0; // field or parameter index
+    int32_t type = 0;
+    int32_t dataIndex = 0;
+};
+
+struct AttributeRangeSpec {
+    uint32_t token = 0;
+    uint32_t start = 0;
+};
+
+struct GenericMethodSpec {
+    int32_t method = 0;
+    int32_t classInst = -1;
+    int32_t methodInst = -1;
+};
+
+enum class AttributeKind { CompilerGenerated, SerializeField };
+
+class CorpusBuilder {
+public:
+    explicit CorpusBuilder(const SyntheticCorpusOptions& options) : options_(options), rng_(options.seed) {}
+
+    void Build();
+    std::vector<uint8_t> SerializeMetadata() const;
+    std::vector<uint8_t> SerializeElf(uint64_t* codeRegistration, uint64_t* metadataRegistration);
+
+    size_t TypeCount() const { return typeDefs_.size(); }
+    size_t MethodCount() const { return methods_.size(); }
+    size_t FieldCount() const { return fields_.size(); }
+    size_t RuntimeTypeCount() const { return runtimeTypes_.size(); }
+    size_t MethodSpecCount() const { return methodSpecs_.size(); }
+
+private:
+    int32_t IndexedType(uint8_t type, TypeData data = {}, uint16_t attrs = 0, uint8_t byref = 0);
+    size_t ExtraType(uint8_t type, TypeData data);
+    int32_t ValueData(uint8_t type, uint64_t value, uint16_t attrs = 0, uint8_t byref = 0) {
+        TypeData data;
+        data.value = value;
+        return IndexedType(type, data, attrs, byref);
+    }
+    int32_t AddGenericInst(std::vector<int32_t> args);
+    std::vector<int32_t> RandomArgs(uint32_t count);
+    int32_t RandomType(uint16_t attrs);
+    size_t AddField(const std::string& name, int32_t type);
+    void AddDefault(std::vector<DefaultValueSpec>* table, int32_t owner, int32_t type, const std::vector<uint8_t>& data);
+    size_t AddRandomField();
+    size_t AddMethod(int32_t declaring, const std::string& name, int32_t returnType, uint16_t flags,
+                     const std::vector<std::pair<std::string, int32_t>>& params, size_t image, int32_t genericContainer);
+    size_t AddRandomMethod(int32_t declaring, size_t image, bool isInterface);
+    void BuildTypeDefinition(size_t index, std::vector<std::vector<std::pair<uint32_t, AttributeKind>>>* imageAttributes);
+    void BuildAttributes(const std::vector<std::vector<std::pair<uint32_t, AttributeKind>>>& imageAttributes);
+    void BuildGenericMethodSpecs();
+    void PadRuntimeTypes();
+
+    SyntheticCorpusOptions options_;
+    Rng rng_;
+    StringTable strings_;
+    std::vector<ImageSpec> images_;
+    std::vector<TypeDefSpec> typeDefs_;
+    std::vector<MethodSpecDef> methods_;
+    std::vector<FieldSpec> fields_;
+    std::vector<ParameterSpec> parameters_;
+    std::vector<PropertySpec> properties_;
+    std::vector<GenericParameterSpec> genericParameters_;
+    std::vector<GenericContainerSpec> genericContainers_;
+    std::vector<int32_t> nestedTypes_;
+    std::vector<int32_t> interfaces_;
+    std::vector<DefaultValueSpec> fieldDefaults_;
+    std::vector<DefaultValueSpec> parameterDefaults_;
+    std::vector<uint8_t> defaultValueData_;
+    std::vector<AttributeRangeSpec> attributeRanges_;
+    std::vector<uint8_t> attributeData_;
+
+    std::vector<RuntimeTypeSpec> runtimeTypes_;
+    std::map<std::tuple<uint8_t, std::tuple<int, uint64_t, size_t, uint32_t>, uint16_t, uint8_t>, int32_t> runtimeTypeKeys_;
+    std::vector<RuntimeTypeSpec> extraTypes_;
+    std::vector<std::vector<int32_t>> genericInsts_;
+    std::vector<GenericMethodSpec> methodSpecs_;
+    std::vector<std::pair<int32_t, int32_t>> genericMethodTable_; // {method spec, pointer index}
+    std::vector<bool> genericMethodPointerPresent_;
+
+    std::unordered_map<uint8_t, int32_t> primitive_;
+    std::vector<int32_t> classType_;
+    std::vector<int32_t> typePool_;
+    std::vector<int32_t> parentPool_;
+    std::vector<std::pair<int32_t, int32_t>> genericInstTypes_; // {generic type definition, generic inst}
+    std::map<int32_t, std::vector<int32_t>> nestedChildren_;
+    std::vector<size_t> imageMethodCount_;
+    int32_t objectType_ = 0;
+    int32_t valueTypeType_ = 0;
+    int32_t enumType_ = 0;
+    int32_t attributeCtorCompilerGenerated_ = 0;
+    int32_t attributeCtorSerializeField_ = 0;
+};
+
+// Core mscorlib definitions every corpus starts with; later types pick their roles at random.
+const char* const kCoreTypeNames[] = {"Object",  "ValueType", "Enum",       "CompilerGeneratedAttribute",
+                                      "SerializeFieldAttribute", "List`1", "Dictionary`2", "IDisposable"};
+constexpr size_t kCoreTypeCount = sizeof(kCoreTypeNames) / sizeof(kCoreTypeNames[0]);
+constexpr size_t kCoreCompilerGenerated = 3;
+constexpr size_t kCoreSerializeField = 4;
+constexpr size_t kCoreDisposable = 7;
+
+int32_t CorpusBuilder::IndexedType(uint8_t type, TypeData data, uint16_t attrs, uint8_t byref) {
+    const auto key = std::make_tuple(type, data.Key(), attrs, byref);
+    const auto found = runtimeTypeKeys_.find(key);
+    if (found != runtimeTypeKeys_.end()) {
+        return found->second;
+    }
+    RuntimeTypeSpec spec;
+    spec.type = type;
+    spec.data = data;
+    spec.attrs = attrs;
+    spec.byref = byref;
+    runtimeTypes_.push_back(spec);
+    const int32_t index = static_cast<int32_t>(runtimeTypes_.size() - 1);
+    runtimeTypeKeys_.emplace(key, index);
+    return index;
+}
+
+size_t CorpusBuilder::ExtraType(uint8_t type, TypeData data) {
+    RuntimeTypeSpec spec;
+    spec.type = type;
+    spec.data = data;
+    extraTypes_.push_back(spec);
+    return extraTypes_.size() - 1;
+}
+
+int32_t CorpusBuilder::AddGenericInst(std::vector<int32_t> args) {
+    genericInsts_.push_back(std::move(args));
+    return static_cast<int32_t>(genericInsts_.size() - 1);
+}
+
+std::vector<int32_t> CorpusBuilder::RandomArgs(uint32_t count) {
+    std::vector<int32_t> args;
+    for (uint32_t i = 0; i < count; ++i) {
+        args.push_back(rng_.Pick(typePool_));
+    }
+    return args;
+}
+
+int32_t CorpusBuilder::RandomType(uint16_t attrs) {
+    const double roll = rng_.Unit();
+    const RuntimeTypeSpec base = runtimeTypes_[static_cast<size_t>(rng_.Pick(typePool_))];
+    if (roll < 0.6) {
+        return IndexedType(base.type, base.data, attrs);
+    }
+    if (roll < 0.85) {
+        TypeData data;
+        data.ref = ExtraType(base.type, base.data);
+        if (roll < 0.75) {
+            data.kind = TypeDataKind::Element;
+            return IndexedType(kTypeSzArray, data, attrs);
+        }
+        if (roll < 0.8) {
+            data.kind = TypeDataKind::Element;
+            return IndexedType(kTypePtr, data, attrs);
+        }
+        data.kind = TypeDataKind::ArrayOf;
+        data.extra = static_cast<uint32_t>(rng_.Range(2, 3));
+        return IndexedType(kTypeArray, data, attrs);
+    }
+    if (!genericInstTypes_.empty()) {
+        const auto& [definition, inst] = rng_.Pick(genericInstTypes_);
+        TypeData data;
+        data.kind = TypeDataKind::GenericClass;
+        data.ref = static_cast<size_t>(definition);
+        data.extra = static_cast<uint32_t>(inst);
+        return IndexedType(kTypeGenericInst, data, attrs);
+    }
+    return ValueData(kTypeI4, 0, attrs);
+}
+
+size_t CorpusBuilder::AddField(const std::string& name, int32_t type) {
+    const size_t index = fields_.size();
+    fields_.push_back({strings_.Add(name), type, 0x04000000u | static_cast<uint32_t>(index + 1)});
+    return index;
+}
+
+void CorpusBuilder::AddDefault(std::vector<DefaultValueSpec>* table, int32_t owner, int32_t type,
+                               const std::vector<uint8_t>& data) {
+    table->push_back({owner, type, static_cast<int32_t>(defaultValueData_.size())});
+    defaultValueData_.insert(defaultValueData_.end(), data.begin(), data.end());
+}
+
+size_t CorpusBuilder::AddRandomField() {
+    static const std::vector<uint16_t> kAccess = {0x1, 0x6, 0x6, 0x4, 0x3};
+    uint16_t attrs = rng_.Pick(kAccess);
+    const double roll = rng_.Unit();
+    const size_t index = fields_.size();
+    if (roll < 0.1) {
+        static const std::vector<uint8_t> kConstTypes = {kTypeI4, kTypeString, kTypeBoolean, kTypeR4, kTypeU1, kTypeI8};
+        static const std::vector<std::string> kConstStrings = {"hello", "a\"b", "c\\d", ""};
+        attrs |= 0x10 | 0x40;
+        const uint8_t type = rng_.Pick(kConstTypes);
+        AddField("CONST_" + std::to_string(index), ValueData(type, 0, attrs));
+        std::vector<uint8_t> data;
+        if (type == kTypeI4) {
+            PutCompressedI32(&data, static_cast<int32_t>(rng_.Range(-100000, 100000)));
+        } else if (type == kTypeString) {
+            PutBlobString(&data, rng_.Pick(kConstStrings));
+        } else if (type == kTypeBoolean) {
+            PutU8(&data, static_cast<uint8_t>(rng_.Below(2)));
+        } else if (type == kTypeR4) {
+            const float value = static_cast<float>(rng_.Unit() * 100.0);
+            uint32_t bits = 0;
+            std::memcpy(&bits, &value, sizeof(bits));
+            PutU32(&data, bits);
+        } else if (type == kTypeU1) {
+            PutU8(&data, static_cast<uint8_t>(rng_.Below(256)));
+        } else {
+            PutU64(&data, static_cast<uint64_t>(rng_.Range(-(int64_t{1} << 40), int64_t{1} << 40)));
+        }
+        AddDefault(&fieldDefaults_, static_cast<int32_t>(index), primitive_[type], data);
+        return index;
+    }
+    if (roll < 0.25) {
+        attrs |= 0x10;
+    }
+    if (rng_.Chance(0.1)) {
+        attrs |= 0x20;
+    }
+    AddField("field" + std::to_string(index), RandomType(attrs));
+    return index;
+}
+
+size_t CorpusBuilder::AddMethod(int32_t declaring, const std::string& name, int32_t returnType, uint16_t flags,
+                                const std::vector<std::pair<std::string, int32_t>>& params, size_t image,
+                                int32_t genericContainer) {
+    const size_t index = methods_.size();
+    const int32_t parameterStart = static_cast<int32_t>(parameters_.size());
+    for (const auto& [paramName, paramType] : params) {
+        parameters_.push_back({strings_.Add(paramName), paramType});
+    }
+    MethodSpecDef method;
+    method.name = strings_.Add(name);
+    method.declaring = declaring;
+    method.returnType = returnType;
+    method.parameterStart = params.empty() ? -1 : parameterStart;
+    method.genericContainer = genericContainer;
+    method.token = 0x06000000u | static_cast<uint32_t>(++imageMethodCount_[image]);
+    method.flags = flags;
+    method.slot = (flags & 0x40) != 0 ? static_cast<uint16_t>(rng_.Range(0, 30)) : static_cast<uint16_t>(0xFFFF);
+    method.parameterCount = static_cast<uint16_t>(params.size());
+    method.image = image;
+    methods_.push_back(method);
+    return index;
+}
+
+size_t CorpusBuilder::AddRandomMethod(int32_t declaring, size_t image, bool isInterface) {
+    static const std::vector<uint16_t> kAccess = {0x6, 0x6, 0x1, 0x4, 0x3, 0x5};
+    static const std::vector<uint16_t> kModifiers = {0, 0, 0x10, 0x40, 0x40 | 0x100, 0x20 | 0x40, 0x2000};
+    static const std::vector<uint16_t> kParamAttrs = {0, 0, 0, 0x1, 0x2};
+    uint16_t flags = static_cast<uint16_t>(rng_.Pick(kAccess) | rng_.Pick(kModifiers));
+    if (isInterface) {
+        flags = 0x6 | 0x40 | 0x100 | 0x400;
+    } else if (rng_.Chance(0.05)) {
+        flags |= 0x400 | 0x40;
+    }
+    std::vector<std::pair<std::string, int32_t>> params;
+    const int64_t paramCount = rng_.Range(0, 4);
+    for (int64_t p = 0; p < paramCount; ++p) {
+        const uint16_t paramAttrs = rng_.Pick(kParamAttrs);
+        int32_t type = RandomType(paramAttrs);
+        if (rng_.Chance(0.1)) {
+            const RuntimeTypeSpec base = runtimeTypes_[static_cast<size_t>(type)];
+            type = IndexedType(base.type, base.data, static_cast<uint16_t>(paramAttrs | rng_.Range(1, 3)), 1);
+        }
+        params.emplace_back(rng_.Chance(0.9) ? "p" + std::to_string(p) : std::string(), type);
+    }
+    int32_t genericContainer = -1;
+    if (rng_.Chance(0.1)) {
+        genericContainer = static_cast<int32_t>(genericContainers_.size());
+        const int32_t parameterStart = static_cast<int32_t>(genericParameters_.size());
+        genericParameters_.push_back({genericContainer, strings_.Add("TM"), 0});
+        genericContainers_.push_back({static_cast<int32_t>(methods_.size()), 1, 1, parameterStart});
+        params.emplace_back("gen", ValueData(kTypeMVar, static_cast<uint64_t>(parameterStart)));
+    }
+    int32_t returnType = rng_.Chance(0.6) ? RandomType(0) : primitive_[kTypeVoid];
+    if (rng_.Chance(0.05)) {
+        const RuntimeTypeSpec base = runtimeTypes_[static_cast<size_t>(returnType)];
+        returnType = IndexedType(base.type, base.data, 0, 1);
+    }
+    const int32_t firstParameter = static_cast<int32_t>(parameters_.size());
+    const size_t index = AddMethod(declaring, "Method" + std::to_string(methods_.size()), returnType, flags, params,
+                                   image, genericContainer);
+    if (!params.empty() && rng_.Chance(0.2)) {
+        std::vector<uint8_t> data;
+        PutCompressedI32(&data, static_cast<int32_t>(rng_.Range(-5, 5)));
+        AddDefault(&parameterDefaults_, firstParameter + static_cast<int32_t>(params.size()) - 1,
+                   primitive_[kTypeI4], data);
+    }
+    return index;
+}
+
+void CorpusBuilder::BuildTypeDefinition(size_t index,
+                                        std::vector<std::vector<std::pair<uint32_t, AttributeKind>>>* imageAttributes) {
+    static const std::vector<std::string> kNamespaces = {"", "Game", "Game.Logic", "UnityEngine", "System"};
+    static const std::vector<uint32_t> kNestedVisibility = {0x2, 0x3, 0x4, 0x5, 0x7};
+    static const char* const kGenericParamNames[] = {"T", "TKey", "TValue"};
+    TypeDefSpec& td = typeDefs_[index];
+    const size_t image = td.image;
+    const int32_t typeIndex = static_cast<int32_t>(index);
+
+    std::string name;
+    std::string ns;
+    if (index < kCoreTypeCount) {
+        name = kCoreTypeNames[index];
+        ns = (index == kCoreSerializeField) ? "UnityEngine" : "System";
+    } else {
+        switch (td.kind) {
+        case TypeKind::Nested: name = "Inner" + std::to_string(index); break;
+        case TypeKind::Generic: name = "Gen" + std::to_string(index) + "`1"; break;
+        case TypeKind::Interface: name = "IThing" + std::to_string(index); break;
+        case TypeKind::Struct: name = "Vec" + std::to_string(index); break;
+        case TypeKind::Enum: name = "Mode" + std::to_string(index); break;
+        default: name = "Klass" + std::to_string(index); break;
+        }
+        ns = (td.kind == TypeKind::Nested) ? std::string() : rng_.Pick(kNamespaces);
+    }
+    td.name = strings_.Add(name);
+    td.ns = strings_.Add(ns);
+
+    uint32_t flags = (td.kind == TypeKind::Nested) ? rng_.Pick(kNestedVisibility) : 0x1u;
+    if (rng_.Chance(0.2)) {
+        flags |= 0x2000;
+    }
+    if (td.kind == TypeKind::Interface) {
+        flags |= 0x20 | 0x80;
+    } else if (rng_.Chance(0.1)) {
+        flags |= 0x80 | 0x100;
+    } else if (rng_.Chance(0.1)) {
+        flags |= 0x100;
+    }
+    td.flags = flags;
+    const bool isValueType = td.kind == TypeKind::Struct || td.kind == TypeKind::Enum;
+    td.bitfield = (isValueType ? 1u : 0u) | (td.kind == TypeKind::Enum ? 2u : 0u);
+    if (td.kind == TypeKind::Struct) {
+        td.parent = valueTypeType_;
+    } else if (td.kind == TypeKind::Enum) {
+        td.parent = enumType_;
+    } else if (td.kind == TypeKind::Interface || index == 0) {
+        td.parent = -1;
+    } else {
+        td.parent = rng_.Pick(parentPool_);
+    }
+    td.element = (td.kind == TypeKind::Enum) ? primitive_[kTypeI4] : -1;
+    td.token = 0x02000000u | static_cast<uint32_t>(index - static_cast<size_t>(images_[image].typeStart) + 1);
+
+    if (td.genericArgc > 0) {
+        const int32_t container = static_cast<int32_t>(genericContainers_.size());
+        const int32_t parameterStart = static_cast<int32_t>(genericParameters_.size());
+        for (uint32_t a = 0; a < td.genericArgc; ++a) {
+            const char* paramName = kGenericParamNames[td.genericArgc == 1 ? 0 : a + 1];
+            genericParameters_.push_back({container, strings_.Add(paramName), static_cast<uint16_t>(a)});
+        }
+        genericContainers_.push_back({typeIndex, static_cast<int32_t>(td.genericArgc), 0, parameterStart});
+        td.genericContainer = container;
+    }
+
+    td.fieldStart = static_cast<int32_t>(fields_.size());
+    if (td.kind == TypeKind::Enum) {
+        AddField("value__", ValueData(kTypeI4, 0, 0x6 | 0x800 | 0x400));
+        const int64_t valueCount = rng_.Range(2, 5);
+        for (int64_t e = 0; e < valueCount; ++e) {
+            const size_t field = AddField("Val" + std::to_string(e),
+                                          ValueData(kTypeValueType, index, 0x6 | 0x10 | 0x40));
+            std::vector<uint8_t> data;
+            PutCompressedI32(&data, static_cast<int32_t>(e * 3 - 2));
+            AddDefault(&fieldDefaults_, static_cast<int32_t>(field), primitive_[kTypeI4], data);
+        }
+    } else if (td.kind != TypeKind::Interface) {
+        const int64_t fieldCount = rng_.Range(0, options_.fieldsPerType);
+        for (int64_t f = 0; f < fieldCount; ++f) {
+            const size_t field = AddRandomField();
+            if (rng_.Chance(0.15)) {
+                (*imageAttributes)[image].emplace_back(fields_[field].token, AttributeKind::SerializeField);
+            }
+        }
+    }
+    td.fieldCount = static_cast<uint16_t>(fields_.size() - static_cast<size_t>(td.fieldStart));
+
+    td.methodStart = static_cast<int32_t>(methods_.size());
+    if (td.kind != TypeKind::Enum) {
+        if (td.kind != TypeKind::Interface) {
+            const size_t ctor = AddMethod(typeIndex, ".ctor", primitive_[kTypeVoid], 0x1886, {}, image, -1);
+            if (index == kCoreCompilerGenerated) {
+                attributeCtorCompilerGenerated_ = static_cast<int32_t>(ctor);
+            } else if (index == kCoreSerializeField) {
+                attributeCtorSerializeField_ = static_cast<int32_t>(ctor);
+            }
+        }
+        const int64_t methodCount = rng_.Range(1, std::max<uint32_t>(1, options_.methodsPerType));
+        for (int64_t m = 0; m < methodCount; ++m) {
+            AddRandomMethod(typeIndex, image, td.kind == TypeKind::Interface);
+            if (rng_.Chance(0.1)) {
+                (*imageAttributes)[image].emplace_back(methods_.back().token, AttributeKind::CompilerGenerated);
+            }
+        }
+    }
+    td.methodCount = static_cast<uint16_t>(methods_.size() - static_cast<size_t>(td.methodStart));
+
+    td.propertyStart = static_cast<int32_t>(properties_.size());
+    const bool canHaveProperties = td.kind == TypeKind::Class || td.kind == TypeKind::Struct ||
+                                   td.kind == TypeKind::Generic || td.kind == TypeKind::Nested;
+    if (canHaveProperties && td.methodCount >= 2) {
+        const int64_t propertyCount = rng_.Range(0, 2);
+        for (int64_t p = 0; p < propertyCount; ++p) {
+            const int32_t relative = static_cast<int32_t>(rng_.Range(1, td.methodCount - 1));
+            const bool hasGetter = rng_.Chance(0.7);
+            PropertySpec property;
+            property.name = strings_.Add("Prop" + std::to_string(p));
+            property.get = hasGetter ? relative : -1;
+            property.set = (hasGetter && rng_.Chance(0.5)) ? -1 : relative;
+            property.token = 0x17000000u | static_cast<uint32_t>(properties_.size() + 1);
+            properties_.push_back(property);
+        }
+    }
+    td.propertyCount = static_cast<uint16_t>(properties_.size() - static_cast<size_t>(td.propertyStart));
+
+    td.interfaceStart = static_cast<int32_t>(interfaces_.size());
+    if ((td.kind == TypeKind::Class || td.kind == TypeKind::Struct) && rng_.Chance(0.3)) {
+        interfaces_.push_back(classType_[kCoreDisposable]);
+    }
+    td.interfaceCount = static_cast<uint16_t>(interfaces_.size() - static_cast<size_t>(td.interfaceStart));
+    if (rng_.Chance(0.2)) {
+        (*imageAttributes)[image].emplace_back(td.token, AttributeKind::CompilerGenerated);
+    }
+}
+
+void CorpusBuilder::BuildAttributes(const std::vector<std::vector<std::pair<uint32_t, AttributeKind>>>& imageAttributes) {
+    for (size_t image = 0; image < images_.size(); ++image) {
+        auto entries = imageAttributes[image];
+        std::stable_sort(entries.begin(), entries.end(),
+                         [](const auto& a, const auto& b) { return a.first < b.first; });
+        images_[image].attributeStart = static_cast<int32_t>(attributeRanges_.size());
+        std::set<uint32_t> seen;
+        for (const auto& [token, kind] : entries) {
+            if (!seen.insert(token).second) {
+                continue;
+            }
+            const uint32_t start = static_cast<uint32_t>(attributeData_.size());
+            const bool compilerGenerated = kind == AttributeKind::CompilerGenerated;
+            std::vector<int32_t> ctors = {compilerGenerated ? attributeCtorCompilerGenerated_ : attributeCtorSerializeField_};
+            if (rng_.Chance(0.3)) {
+                ctors.push_back(compilerGenerated ? attributeCtorSerializeField_ : attributeCtorCompilerGenerated_);
+            }
+            PutCompressedU32(&attributeData_, static_cast<uint32_t>(ctors.size()));
+            for (const int32_t ctor : ctors) {
+                PutI32(&attributeData_, ctor);
+            }
+            for (size_t c = 0; c < ctors.size(); ++c) {
+                if (rng_.Chance(0.5)) {
+                    PutCompressedU32(&attributeData_, 0);
+                    PutCompressedU32(&attributeData_, 0);
+                    PutCompressedU32(&attributeData_, 0);
+                    continue;
+                }
+                // Two constructor arguments (a string and an int), no named fields or properties.
+                PutCompressedU32(&attributeData_, 2);
+                PutCompressedU32(&attributeData_, 0);
+                PutCompressedU32(&attributeData_, 0);
+                PutU8(&attributeData_, kTypeString);
+                PutBlobString(&attributeData_, "attr-" + std::to_string(rng_.Range(0, 99)));
+                PutU8(&attributeData_, kTypeI4);
+                PutCompressedI32(&attributeData_, static_cast<int32_t>(rng_.Range(-50, 50)));
+            }
+            attributeRanges_.push_back({token, start});
+        }
+        images_[image].attributeCount =
+            static_cast<uint32_t>(attributeRanges_.size() - static_cast<size_t>(images_[image].attributeStart));
+    }
+}
+
+void CorpusBuilder::BuildGenericMethodSpecs() {
+    std::vector<int32_t> genericMethods;
+    for (size_t i = 0; i < methods_.size(); ++i) {
+        if (methods_[i].genericContainer >= 0) {
+            genericMethods.push_back(static_cast<int32_t>(i));
+        }
+    }
+    std::vector<int32_t> genericTypes;
+    for (size_t i = 0; i < typeDefs_.size(); ++i) {
+        if (typeDefs_[i].genericContainer >= 0) {
+            genericTypes.push_back(static_cast<int32_t>(i));
+        }
+    }
+    auto classArgc = [this](int32_t type) {
+        return static_cast<uint32_t>(genericContainers_[static_cast<size_t>(typeDefs_[static_cast<size_t>(type)].genericContainer)].argc);
+    };
+    for (uint32_t n = 0; n < options_.genericInsts; ++n) {
+        GenericMethodSpec spec;
+        if (!genericMethods.empty() && rng_.Chance(0.5)) {
+            spec.method = rng_.Pick(genericMethods);
+            const int32_t declaring = methods_[static_cast<size_t>(spec.method)].declaring;
+            if (typeDefs_[static_cast<size_t>(declaring)].genericContainer >= 0) {
+                spec.classInst = AddGenericInst(RandomArgs(classArgc(declaring)));
+            }
+            spec.methodInst = AddGenericInst(RandomArgs(1));
+        } else {
+            if (genericTypes.empty()) {
+                break;
+            }
+            const int32_t declaring = rng_.Pick(genericTypes);
+            const TypeDefSpec& td = typeDefs_[static_cast<size_t>(declaring)];
+            if (td.methodCount == 0) {
+                continue;
+            }
+            spec.method = td.methodStart + static_cast<int32_t>(rng_.Below(td.methodCount));
+            spec.classInst = AddGenericInst(RandomArgs(classArgc(declaring)));
+        }
+        methodSpecs_.push_back(spec);
+        // Shared generic code: some specs reuse an earlier pointer slot.
+        int32_t pointerIndex = static_cast<int32_t>(genericMethodPointerPresent_.size());
+        if (!genericMethodPointerPresent_.empty() && rng_.Chance(0.3)) {
+            pointerIndex = static_cast<int32_t>(rng_.Below(genericMethodPointerPresent_.size()));
+        } else {
+            genericMethodPointerPresent_.push_back(rng_.Below(4) != 0);
+        }
+        genericMethodTable_.emplace_back(static_cast<int32_t>(methodSpecs_.size() - 1), pointerIndex);
+    }
+}
+
+// The MetadataRegistration heuristic keys on typesCount == typeDefinitionsCount, so both tables get the same length:
+// spare runtime type slots are filled with I4 variants, spare runtime types get filler type definitions.
+void CorpusBuilder::PadRuntimeTypes() {
+    while (runtimeTypes_.size() < typeDefs_.size()) {
+        RuntimeTypeSpec spec;
+        spec.type = kTypeI4;
+        spec.attrs = static_cast<uint16_t>(runtimeTypes_.size() & 0x7u);
+        runtimeTypes_.push_back(spec);
+    }
+    const size_t last = images_.size() - 1;
+    while (typeDefs_.size() < runtimeTypes_.size()) {
+        const size_t index = typeDefs_.size();
+        TypeDefSpec td;
+        td.image = last;
+        td.kind = TypeKind::Class;
+        td.name = strings_.Add("Filler" + std::to_string(index));
+        td.ns = strings_.Add("Filler");
+        td.byvalType = objectType_;
+        td.parent = objectType_;
+        td.flags = 0x1;
+        td.token = 0x02000000u | static_cast<uint32_t>(index - static_cast<size_t>(images_[last].typeStart) + 1);
+        td.fieldStart = static_cast<int32_t>(fields_.size());
+        td.methodStart = static_cast<int32_t>(methods_.size());
+        td.propertyStart = static_cast<int32_t>(properties_.size());
+        td.interfaceStart = static_cast<int32_t>(interfaces_.size());
+        typeDefs_.push_back(td);
+        ++images_[last].typeCount;
+    }
+}
+
+void CorpusBuilder::Build() {
+    std::vector<std::string> imageNames = {"mscorlib.dll", "UnityEngine.CoreModule.dll"};
+    for (uint32_t i = 0; imageNames.size() < options_.images; ++i) {
+        imageNames.push_back("Assembly-" + std::to_string(i) + ".dll");
+    }
+    imageNames.resize(std::max<uint32_t>(1, options_.images));
+    imageMethodCount_.assign(imageNames.size(), 0);
+
+    static const std::vector<TypeKind> kKinds = {TypeKind::Class,     TypeKind::Class,   TypeKind::Class,
+                                                 TypeKind::Struct,    TypeKind::Enum,    TypeKind::Interface,
+                                                 TypeKind::Generic,   TypeKind::Nested};
+    for (size_t image = 0; image < imageNames.size(); ++image) {
+        ImageSpec spec;
+        spec.name = strings_.Add(imageNames[image]);
+        spec.typeStart = static_cast<int32_t>(typeDefs_.size());
+        spec.typeCount = options_.typesPerImage;
+        images_.push_back(spec);
+        for (uint32_t t = 0; t < options_.typesPerImage; ++t) {
+            TypeDefSpec td;
+            td.image = image;
+            const size_t index = typeDefs_.size();
+            td.kind = (index < kCoreTypeCount) ? TypeKind::Core : rng_.Pick(kKinds);
+            if (index == 5) {
+                td.genericArgc = 1;
+            } else if (index == 6) {
+                td.genericArgc = 2;
+            } else if (td.kind == TypeKind::Generic) {
+                td.genericArgc = 1;
+            }
+            typeDefs_.push_back(td);
+        }
+    }
+    const size_t typeCount = typeDefs_.size();
+
+    for (const uint8_t type : {kTypeVoid, kTypeBoolean, kTypeChar, kTypeI1, kTypeU1, kTypeI2, kTypeU2, kTypeI4, kTypeU4,
+                               kTypeI8, kTypeU8, kTypeR4, kTypeR8, kTypeString, kTypeObject}) {
+        primitive_[type] = ValueData(type, 0);
+    }
+    objectType_ = ValueData(kTypeClass, 0);
+    valueTypeType_ = ValueData(kTypeClass, 1);
+    enumType_ = ValueData(kTypeClass, 2);
+    classType_.resize(typeCount);
+    for (size_t i = 0; i < typeCount; ++i) {
+        const bool isValueType = typeDefs_[i].kind == TypeKind::Struct || typeDefs_[i].kind == TypeKind::Enum;
+        classType_[i] = ValueData(isValueType ? kTypeValueType : kTypeClass, i);
+        typeDefs_[i].byvalType = classType_[i];
+    }
+
+    // Nested types hang off a recent class of the same image.
+    for (size_t i = 0; i < typeCount; ++i) {
+        if (typeDefs_[i].kind != TypeKind::Nested) {
+            continue;
+        }
+        const size_t imageStart = static_cast<size_t>(images_[typeDefs_[i].image].typeStart);
+        std::vector<int32_t> candidates;
+        for (size_t j = std::max(imageStart, i >= 40 ? i - 40 : 0); j < i; ++j) {
+            if (typeDefs_[j].kind == TypeKind::Class) {
+                candidates.push_back(static_cast<int32_t>(j));
+            }
+        }
+        if (candidates.empty()) {
+            typeDefs_[i].kind = TypeKind::Class;
+            continue;
+        }
+        const int32_t parent = rng_.Pick(candidates);
+        nestedChildren_[parent].push_back(static_cast<int32_t>(i));
+        typeDefs_[i].declaring = parent;
+    }
+
+    std::vector<int32_t> genericDefinitions;
+    typePool_ = {primitive_[kTypeI4], primitive_[kTypeString], primitive_[kTypeBoolean], primitive_[kTypeR4],
+                 primitive_[kTypeObject]};
+    for (size_t i = 0, pooled = 0; i < typeCount; ++i) {
+        const TypeKind kind = typeDefs_[i].kind;
+        if (typeDefs_[i].genericArgc > 0) {
+            genericDefinitions.push_back(static_cast<int32_t>(i));
+        }
+        if ((kind == TypeKind::Class || kind == TypeKind::Struct || kind == TypeKind::Enum) && pooled < 64) {
+            typePool_.push_back(classType_[i]);
+            ++pooled;
+        }
+    }
+    for (uint32_t g = 0; g < std::max<uint32_t>(1, options_.genericInsts / 4) && !genericDefinitions.empty(); ++g) {
+        const int32_t definition = rng_.Pick(genericDefinitions);
+        genericInstTypes_.emplace_back(definition, AddGenericInst(RandomArgs(typeDefs_[static_cast<size_t>(definition)].genericArgc)));
+    }
+    parentPool_ = {primitive_[kTypeObject], objectType_};
+    for (size_t i = 0; i < typeCount && parentPool_.size() < 12; ++i) {
+        if (typeDefs_[i].kind == TypeKind::Class) {
+            parentPool_.push_back(classType_[i]);
+        }
+    }
+
+    std::vector<std::vector<std::pair<uint32_t, AttributeKind>>> imageAttributes(images_.size());
+    for (size_t i = 0; i < typeCount; ++i) {
+        BuildTypeDefinition(i, &imageAttributes);
+    }
+    for (const auto& [parent, children] : nestedChildren_) {
+        typeDefs_[static_cast<size_t>(parent)].nestedStart = static_cast<int32_t>(nestedTypes_.size());
+        typeDefs_[static_cast<size_t>(parent)].nestedCount = static_cast<uint16_t>(children.size());
+        nestedTypes_.insert(nestedTypes_.end(), children.begin(), children.end());
+    }
+    BuildAttributes(imageAttributes);
+    BuildGenericMethodSpecs();
+    PadRuntimeTypes();
+}
+
+std::vector<uint8_t> CorpusBuilder::SerializeMetadata() const {
+    struct Section {
+        uint32_t offset = 0;
+        uint32_t size = 0;
+    };
+    std::vector<uint8_t> body;
+    auto place = [&body](const std::vector<uint8_t>& data, size_t align) {
+        while ((kMetadataHeaderBytes + body.size()) % align != 0) {
+            body.push_back(0);
+        }
+        Section section{static_cast<uint32_t>(kMetadataHeaderBytes + body.size()), static_cast<uint32_t>(data.size())};
+        body.insert(body.end(), data.begin(), data.end());
+        return section;
+    };
+
+    const Section strings = place(strings_.Bytes(), 1);
+    const Section events = place({}, 4);
+    std::vector<uint8_t> b;
+    for (const auto& p : properties_) {
+        PutU32(&b, p.name);
+        PutI32(&b, p.get);
+        PutI32(&b, p.set);
+        PutU32(&b, 0);
+        PutU32(&b, p.token);
+    }
+    const Section properties = place(b, 4);
+    b.clear();
+    for (const auto& m : methods_) {
+        PutU32(&b, m.name);
+        PutI32(&b, m.declaring);
+        PutI32(&b, m.returnType);
+        PutI32(&b, m.parameterStart);
+        PutI32(&b, m.genericContainer);
+        PutU32(&b, m.token);
+        PutU16(&b, m.flags);
+        PutU16(&b, 0);
+        PutU16(&b, m.slot);
+        PutU16(&b, m.parameterCount);
+    }
+    const Section methods = place(b, 4);
+    auto defaults = [](const std::vector<DefaultValueSpec>& table) {
+        std::vector<uint8_t> out;
+        for (const auto& d : table) {
+            PutI32(&out, d.owner);
+            PutI32(&out, d.type);
+            PutI32(&out, d.dataIndex);
+        }
+        return out;
+    };
+    const Section parameterDefaults = place(defaults(parameterDefaults_), 4);
+    const Section fieldDefaults = place(defaults(fieldDefaults_), 4);
+    const Section defaultData = place(defaultValueData_, 1);
+    b.clear();
+    for (size_t i = 0; i < parameters_.size(); ++i) {
+        PutU32(&b, parameters_[i].name);
+        PutU32(&b, 0x08000000u | static_cast<uint32_t>(i + 1));
+        PutI32(&b, parameters_[i].type);
+    }
+    const Section parameters = place(b, 4);
+    b.clear();
+    for (const auto& f : fields_) {
+        PutU32(&b, f.name);
+        PutI32(&b, f.type);
+        PutU32(&b, f.token);
+    }
+    const Section fields = place(b, 4);
+    b.clear();
+    for (const auto& g : genericParameters_) {
+        PutI32(&b, g.owner);
+        PutU32(&b, g.name);
+        PutU16(&b, 0);
+        PutU16(&b, 0);
+        PutU16(&b, g.num);
+        PutU16(&b, 0);
+    }
+    const Section genericParameters = place(b, 4);
+    b.clear();
+    for (const auto& g : genericContainers_) {
+        PutI32(&b, g.owner);
+        PutI32(&b, g.argc);
+        PutI32(&b, g.isMethod);
+        PutI32(&b, g.parameterStart);
+    }
+    const Section genericContainers = place(b, 4);
+    b.clear();
+    for (const int32_t n : nestedTypes_) {
+        PutI32(&b, n);
+    }
+    const Section nested = place(b, 4);
+    b.clear();
+    for (const int32_t n : interfaces_) {
+        PutI32(&b, n);
+    }
+    const Section interfaces = place(b, 4);
+    b.clear();
+    for (const auto& t : typeDefs_) {
+        PutU32(&b, t.name);
+        PutU32(&b, t.ns);
+        PutI32(&b, t.byvalType);
+        PutI32(&b, t.declaring);
+        PutI32(&b, t.parent);
+        PutI32(&b, t.element);
+        PutI32(&b, t.genericContainer);
+        PutU32(&b, t.flags);
+        PutI32(&b, t.fieldStart);
+        PutI32(&b, t.methodStart);
+        PutI32(&b, 0); // eventStart
+        PutI32(&b, t.propertyStart);
+        PutI32(&b, t.nestedStart);
+        PutI32(&b, t.interfaceStart);
+        PutI32(&b, 0); // vtableStart
+        PutI32(&b, 0); // interfaceOffsetsStart
+        PutU16(&b, t.methodCount);
+        PutU16(&b, t.propertyCount);
+        PutU16(&b, t.fieldCount);
+        PutU16(&b, 0); // eventCount
+        PutU16(&b, t.nestedCount);
+        PutU16(&b, 0); // vtableCount
+        PutU16(&b, t.interfaceCount);
+        PutU16(&b, 0); // interfaceOffsetsCount
+        PutU32(&b, t.bitfield);
+        PutU32(&b, t.token);
+    }
+    const Section typeDefinitions = place(b, 4);
+    b.clear();
+    for (size_t i = 0; i < images_.size(); ++i) {
+        const ImageSpec& im = images_[i];
+        PutU32(&b, im.name);
+        PutI32(&b, static_cast<int32_t>(i));
+        PutI32(&b, im.typeStart);
+        PutU32(&b, im.typeCount);
+        PutI32(&b, 0);
+        PutU32(&b, 0);
+        PutI32(&b, -1);
+        PutU32(&b, 1);
+        PutI32(&b, im.attributeStart);
+        PutU32(&b, im.attributeCount);
+    }
+    const Section images = place(b, 4);
+    const Section attributeData = place(attributeData_, 1);
+    b.clear();
+    for (const auto& a : attributeRanges_) {
+        PutU32(&b, a.token);
+        PutU32(&b, a.start);
+    }
+    const Section attributeRanges = place(b, 4);
+
+    // v29 header: magic, version, then (offset, size) pairs in table order; unused tables are empty.
+    std::vector<uint8_t> out;
+    PutU32(&out, kMetadataMagic);
+    PutI32(&out, kMetadataVersion);
+    const Section none{};
+    for (const Section& s : {none, none, strings, events, properties, methods, parameterDefaults, fieldDefaults,
+                             defaultData, none, parameters, fields, genericParameters, none, genericContainers, nested,
+                             interfaces, none, none, typeDefinitions, images, none, none, none, attributeData,
+                             attributeRanges}) {
+        PutU32(&out, s.offset);
+        PutU32(&out, s.size);
+    }
+    out.resize(kMetadataHeaderBytes, 0);
+    out.insert(out.end(), body.begin(), body.end());
+    return out;
+}
+
+std::vector<uint8_t> CorpusBuilder::SerializeElf(uint64_t* codeRegistration, uint64_t* metadataRegistration) {
+    const uint64_t textBytes = (kTextBaseBytes + 16u * methods_.size() + kPageBytes - 1) & ~uint64_t{kPageBytes - 1};
+    const uint64_t dataVa = textBytes;
+    std::vector<uint8_t> data;
+    auto alloc = [&data, dataVa](size_t size, size_t align) {
+        while (data.size() % align != 0) {
+            data.push_back(0);
+        }
+        const uint64_t va = dataVa + data.size();
+        data.resize(data.size() + size, 0);
+        return va;
+    };
+    auto at = [dataVa](uint64_t va) { return static_cast<size_t>(va - dataVa); };
+    auto w64 = [&](uint64_t va, uint64_t v) { StoreU64(&data, at(va), v); };
+    auto w32 = [&](uint64_t va, uint32_t v) { StoreU32(&data, at(va), v); };
+
+    std::vector<uint64_t> imageNameVas;
+    for (const auto& im : images_) {
+        const std::string name = strings_.At(im.name);
+        const uint64_t va = alloc(name.size() + 1, 1);
+        std::memcpy(data.data() + at(va), name.data(), name.size());
+        imageNameVas.push_back(va);
+    }
+    std::vector<uint64_t> typeVas;
+    for (size_t i = 0; i < runtimeTypes_.size(); ++i) {
+        typeVas.push_back(alloc(16, 8));
+    }
+    std::vector<uint64_t> extraVas;
+    for (size_t i = 0; i < extraTypes_.size(); ++i) {
+        extraVas.push_back(alloc(16, 8));
+    }
+    std::vector<uint64_t> genericInstVas;
+    for (const auto& args : genericInsts_) {
+        const uint64_t argv = alloc(8 * args.size(), 8);
+        for (size_t k = 0; k < args.size(); ++k) {
+            w64(argv + 8 * k, typeVas[static_cast<size_t>(args[k])]);
+        }
+        const uint64_t inst = alloc(16, 8);
+        w64(inst, args.size());
+        w64(inst + 8, argv);
+        genericInstVas.push_back(inst);
+    }
+    std::map<std::pair<size_t, uint32_t>, uint64_t> genericClasses;
+    auto resolveData = [&](const TypeData& d) -> uint64_t {
+        switch (d.kind) {
+        case TypeDataKind::Element:
+            return extraVas[d.ref];
+        case TypeDataKind::ArrayOf: {
+            const uint64_t arrayType = alloc(16, 8);
+            w64(arrayType, extraVas[d.ref]);
+            data[at(arrayType) + 8] = static_cast<uint8_t>(d.extra);
+            return arrayType;
+        }
+        case TypeDataKind::GenericClass: {
+            const auto key = std::make_pair(d.ref, d.extra);
+            const auto found = genericClasses.find(key);
+            if (found != genericClasses.end()) {
+                return found->second;
+            }
+            const uint64_t genericClass = alloc(24, 8);
+            w64(genericClass, typeVas[static_cast<size_t>(classType_[d.ref])]);
+            w64(genericClass + 8, genericInstVas[d.extra]);
+            genericClasses.emplace(key, genericClass);
+            return genericClass;
+        }
+        default:
+            return d.value;
+        }
+    };
+    auto writeType = [&](const RuntimeTypeSpec& t, uint64_t va) {
+        w64(va, resolveData(t.data));
+        w32(va + 8, static_cast<uint32_t>(t.attrs) | (static_cast<uint32_t>(t.type) << 16) |
+                        (static_cast<uint32_t>(t.byref) << 29));
+    };
+    for (size_t i = 0; i < runtimeTypes_.size(); ++i) {
+        writeType(runtimeTypes_[i], typeVas[i]);
+    }
+    for (size_t i = 0; i < extraTypes_.size(); ++i) {
+        writeType(extraTypes_[i], extraVas[i]);
+    }
+    const uint64_t typesArray = alloc(8 * typeVas.size(), 8);
+    for (size_t k = 0; k < typeVas.size(); ++k) {
+        w64(typesArray + 8 * k, typeVas[k]);
+    }
+
+    const uint64_t fieldOffsets = alloc(8 * typeDefs_.size(), 8);
+    for (size_t i = 0; i < typeDefs_.size(); ++i) {
+        if (typeDefs_[i].fieldCount == 0) {
+            continue;
+        }
+        const uint64_t offsets = alloc(4u * typeDefs_[i].fieldCount, 4);
+        uint32_t offset = 16;
+        for (size_t f = 0; f < typeDefs_[i].fieldCount; ++f) {
+            w32(offsets + 4 * f, offset);
+            offset += rng_.Chance(0.5) ? 4u : 8u;
+        }
+        w64(fieldOffsets + 8 * i, offsets);
+    }
+    const uint64_t methodSpecs = alloc(12 * std::max<size_t>(1, methodSpecs_.size()), 4);
+    for (size_t k = 0; k < methodSpecs_.size(); ++k) {
+        w32(methodSpecs + 12 * k, static_cast<uint32_t>(methodSpecs_[k].method));
+        w32(methodSpecs + 12 * k + 4, static_cast<uint32_t>(methodSpecs_[k].classInst));
+        w32(methodSpecs + 12 * k + 8, static_cast<uint32_t>(methodSpecs_[k].methodInst));
+    }
+    const uint64_t genericMethodTable = alloc(16 * std::max<size_t>(1, genericMethodTable_.size()), 4);
+    for (size_t k = 0; k < genericMethodTable_.size(); ++k) {
+        w32(genericMethodTable + 16 * k, static_cast<uint32_t>(genericMethodTable_[k].first));
+        w32(genericMethodTable + 16 * k + 4, static_cast<uint32_t>(genericMethodTable_[k].second));
+    }
+    const uint64_t genericInsts = alloc(8 * std::max<size_t>(1, genericInstVas.size()), 8);
+    for (size_t k = 0; k < genericInstVas.size(); ++k) {
+        w64(genericInsts + 8 * k, genericInstVas[k]);
+    }
+
+    uint64_t codeCursor = kPageBytes;
+    auto nextCodePointer = [&codeCursor]() {
+        const uint64_t pointer = codeCursor;
+        codeCursor += 16;
+        return pointer;
+    };
+    const uint64_t genericMethodPointers = alloc(8 * std::max<size_t>(1, genericMethodPointerPresent_.size()), 8);
+    for (size_t k = 0; k < genericMethodPointerPresent_.size(); ++k) {
+        w64(genericMethodPointers + 8 * k, genericMethodPointerPresent_[k] ? nextCodePointer() : 0);
+    }
+    std::vector<std::vector<size_t>> imageMethods(images_.size());
+    for (size_t i = 0; i < methods_.size(); ++i) {
+        imageMethods[methods_[i].image].push_back(i);
+    }
+    std::vector<uint64_t> modules;
+    for (size_t image = 0; image < images_.size(); ++image) {
+        const auto& list = imageMethods[image];
+        const uint64_t pointers = alloc(8 * std::max<size_t>(1, list.size()), 8);
+        for (size_t k = 0; k < list.size(); ++k) {
+            const bool isAbstract = (methods_[list[k]].flags & 0x400) != 0;
+            w64(pointers + 8 * k, (isAbstract || rng_.Chance(0.05)) ? 0 : nextCodePointer());
+        }
+        const uint64_t module = alloc(8 * 12, 8);
+        w64(module, imageNameVas[image]);
+        w64(module + 8, list.size());
+        w64(module + 16, pointers);
+        modules.push_back(module);
+    }
+    // Module order in CodeRegistration is unrelated to image order in real binaries.
+    std::vector<size_t> order(modules.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    for (size_t i = order.size(); i > 1; --i) {
+        std::swap(order[i - 1], order[static_cast<size_t>(rng_.Below(i))]);
+    }
+    const uint64_t moduleArray = alloc(8 * modules.size(), 8);
+    for (size_t k = 0; k < order.size(); ++k) {
+        w64(moduleArray + 8 * k, modules[order[k]]);
+    }
+
+    // Il2CppCodeRegistration (v29): genericMethodPointers at [2]/[3], codeGenModules at [13]/[14].
+    const uint64_t codeReg = alloc(8 * 16, 8);
+    w64(codeReg + 2 * 8, genericMethodPointerPresent_.size());
+    w64(codeReg + 3 * 8, genericMethodPointers);
+    w64(codeReg + 13 * 8, modules.size());
+    w64(codeReg + 14 * 8, moduleArray);
+    alloc(0x200, 8);
+    const uint64_t metaReg = alloc(8 * 16, 8);
+    const uint64_t metaValues[] = {0,
+                                   0,
+                                   genericInstVas.size(),
+                                   genericInsts,
+                                   genericMethodTable_.size(),
+                                   genericMethodTable,
+                                   typeVas.size(),
+                                   typesArray,
+                                   methodSpecs_.size(),
+                                   methodSpecs,
+                                   typeDefs_.size(),
+                                   fieldOffsets,
+                                   typeDefs_.size(),
+                                   0,
+                                   0,
+                                   0};
+    for (size_t k = 0; k < 16; ++k) {
+        w64(metaReg + 8 * k, metaValues[k]);
+    }
+    alloc(0x200, 8);
+    while (data.size() % kPageBytes != 0) {
+        data.push_back(0);
+    }
+
+    // ELF header and two PT_LOAD program headers: RX text at 0, RW data right after it.
+    std::vector<uint8_t> image(static_cast<size_t>(textBytes), 0);
+    std::vector<uint8_t> header;
+    header.insert(header.end(), {0x7f, 'E', 'L', 'F', 2, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0});
+    PutU16(&header, 3);   // ET_DYN
+    PutU16(&header, 183); // EM_AARCH64
+    PutU32(&header, 1);
+    PutU64(&header, 0);  // entry
+    PutU64(&header, 64); // phoff
+    PutU64(&header, 0);  // shoff
+    PutU32(&header, 0);
+    PutU16(&header, 64);
+    PutU16(&header, 56);
+    PutU16(&header, 2);
+    PutU16(&header, 0);
+    PutU16(&header, 0);
+    PutU16(&header, 0);
+    auto programHeader = [&header](uint32_t flags, uint64_t offset, uint64_t va, uint64_t filesz, uint64_t memsz) {
+        PutU32(&header, 1);
+        PutU32(&header, flags);
+        PutU64(&header, offset);
+        PutU64(&header, va);
+        PutU64(&header, va);
+        PutU64(&header, filesz);
+        PutU64(&header, memsz);
+        PutU64(&header, kPageBytes);
+    };
+    programHeader(5, 0, 0, textBytes, textBytes);
+    programHeader(6, textBytes, dataVa, data.size(), data.size() + kPageBytes);
+    std::copy(header.begin(), header.end(), image.begin());
+    for (uint64_t k = kPageBytes; k < codeCursor; k += 4) {
+        StoreU32(&image, static_cast<size_t>(k), kArm64Ret);
+    }
+    image.insert(image.end(), data.begin(), data.end());
+    *codeRegistration = codeReg;
+    *metadataRegistration = metaReg;
+    return image;
+}
+
+bool WriteFile(const std::filesystem::path& path, const std::vector<uint8_t>& bytes, std::string* error) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (out) {
+        out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    }
+    if (!out) {
+        if (error != nullptr) {
+            *error = "Failed to write " + path.string();
+        }
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+bool GenerateSyntheticCorpus(const std::string& directory, const SyntheticCorpusOptions& options,
+                             SyntheticCorpusInfo* info, std::string* error) {
+    if (options.images == 0 || options.typesPerImage == 0 ||
+        static_cast<uint64_t>(options.images) * options.typesPerImage < kCoreTypeCount) {
+        if (error != nullptr) {
+            *error = "Corpus needs at least " + std::to_string(kCoreTypeCount) + " types";
+        }
+        return false;
+    }
+    std::error_code ec;
+    std::filesystem::create_directories(directory, ec);
+    if (ec) {
+        if (error != nullptr) {
+            *error = "Failed to create " + directory + ": " + ec.message();
+        }
+        return false;
+    }
+
+    CorpusBuilder builder(options);
+    builder.Build();
+    uint64_t codeRegistration = 0;
+    uint64_t metadataRegistration = 0;
+    const std::vector<uint8_t> metadata = builder.SerializeMetadata();
+    const std::vector<uint8_t> elf = builder.SerializeElf(&codeRegistration, &metadataRegistration);
+    const std::filesystem::path root(directory);
+    if (!WriteFile(root / "global-metadata.dat", metadata, error) || !WriteFile(root / "main.elf", elf, error)) {
+        return false;
+    }
+    if (info != nullptr) {
+        info->types = builder.TypeCount();
+        info->methods = builder.MethodCount();
+        info->fields = builder.FieldCount();
+        info->runtimeTypes = builder.RuntimeTypeCount();
+        info->methodSpecs = builder.MethodSpecCount();
+        info->codeRegistration = codeRegistration;
+        info->metadataRegistration = metadataRegistration;
+    }
+    return true;
+}
+
+} // namespace SwitchPort
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace SwitchPort {
+
+// Scale knobs for a generated global-metadata.dat (v29) + ELF64 pair. The same options and seed always produce
+// byte-identical files, so runs on different machines measure the same input.
+struct SyntheticCorpusOptions {
+    uint32_t images = 4;
+    uint32_t typesPerImage = 60;
+    uint32_t methodsPerType = 6;
+    uint32_t fieldsPerType = 6;
+    uint32_t genericInsts = 60;
+    uint64_t seed = 1;
+};
+
+struct SyntheticCorpusInfo {
+    size_t types = 0;
+    size_t methods = 0;
+    size_t fields = 0;
+    size_t runtimeTypes = 0;
+    size_t methodSpecs = 0;
+    uint64_t codeRegistration = 0;
+    uint64_t metadataRegistration = 0;
+};
+
+// Writes global-metadata.dat and main.elf into directory (created if missing). The binary contains real
+// CodeRegistration/MetadataRegistration structures, runtime types, generic instances and method pointers, so every
+// stage of the native dumper has work to do.
+bool GenerateSyntheticCorpus(const std::string& directory, const SyntheticCorpusOptions& options,
+                             SyntheticCorpusInfo* info, std::string* error);
+
+} // namespace SwitchPort
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <ostream>
+#include <thread>
+#include <vector>
+
+#include "SwitchPort/TextBuffer.h"
+
+namespace SwitchPort {
+
+// Writes filled TextBuffers to a stream on a background thread, so rendering the next batch overlaps the file I/O
+// of the previous one. At most kMaxPending buffers wait in the queue; Submit blocks beyond that, which bounds the
+// memory held to a few batches. Emptied buffers are handed back to the producer to reuse their allocations.
+class AsyncBufferWriter {
+public:
+    static constexpr size_t kMaxPending = 2;
+
+    explicit AsyncBufferWriter(std::ostream& out);
+    // Waits for queued buffers to be written.
+    ~AsyncBufferWriter();
+    AsyncBufferWriter(const AsyncBufferWriter&) = delete;
+    AsyncBufferWriter& operator=(const AsyncBufferWriter&) = delete;
+
+    // Queues buffer's contents for writing and leaves buffer empty, holding a recycled allocation when one is free.
+    void Submit(TextBuffer& buffer);
+    // Writes everything queued and stops the thread. Returns false when the stream reported a failure.
+    bool Finish();
+
+private:
+    void Run();
+
+    std::ostream& out_;
+    std::mutex mutex_;
+    std::condition_variable queued_;
+    std::condition_variable drained_;
+    std::deque<TextBuffer> pending_;
+    std::vector<TextBuffer> spare_;
+    bool stop_ = false;
+    bool failed_ = false;
+    std::thread thread_;
+};
+
+} // namespace SwitchPort
@@ -10,10 +10,12 @@ namespace SwitchPort {
 
 class BinaryReader {
 public:
-    explicit BinaryReader(const std::vector<uint8_t>& data, size_t pos = 0) : data_(data), pos_(pos) {}
+    explicit BinaryReader(const std::vector<uint8_t>& data, size_t pos = 0)
+        : data_(data.data()), size_(data.size()), pos_(pos) {}
+    BinaryReader(const uint8_t* data, size_t size, size_t pos = 0) : data_(data), size_(size), pos_(pos) {}
 
     void Seek(size_t pos) {
-        if (pos > data_.size()) {
+        if (pos > size_) {
             throw std::out_of_range("Seek out of range");
         }
         pos_ = pos;
@@ -65,12 +67,12 @@ public:
     }
 
     std::string ReadCStringAt(size_t absOffset) const {
-        if (absOffset >= data_.size()) {
+        if (absOffset >= size_) {
             throw std::out_of_range("String offset out of range");
         }
         std::string out;
         size_t cursor = absOffset;
-        while (cursor < data_.size() && data_[cursor] != 0) {
+        while (cursor < size_ && data_[cursor] != 0) {
             out.push_back(static_cast<char>(data_[cursor]));
             ++cursor;
         }
@@ -79,12 +81,13 @@ public:
 
 private:
     void EnsureAvailable(size_t n) const {
-        if (pos_ + n > data_.size()) {
+        if (pos_ + n > size_) {
             throw std::out_of_range("Read past end of buffer");
         }
     }
 
-    const std::vector<uint8_t>& data_;
+    const uint8_t* data_;
+    size_t size_;
     size_t pos_;
 };
 
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <atomic>
+#include <thread>
+
+namespace SwitchPort {
+
+namespace detail {
+
+inline std::atomic<bool> cancelRequested{false};
+
+} // namespace detail
+
+// Process-wide request to abandon the current run. Requested() is a relaxed atomic load, so long loops and worker
+// threads can poll it per item; nothing on the polling side touches input devices.
+class Cancellation {
+public:
+    static bool Requested() { return detail::cancelRequested.load(std::memory_order_relaxed); }
+    static void Request() { detail::cancelRequested.store(true, std::memory_order_relaxed); }
+    static void Reset() { detail::cancelRequested.store(false, std::memory_order_relaxed); }
+};
+
+// While alive, a background thread scans controller input a few times per second and calls Cancellation::Request()
+// when MINUS is pressed. Does nothing off Switch. Other threads must not scan input while a poller is running.
+class CancelInputPoller {
+public:
+    CancelInputPoller();
+    ~CancelInputPoller();
+    CancelInputPoller(const CancelInputPoller&) = delete;
+    CancelInputPoller& operator=(const CancelInputPoller&) = delete;
+
+private:
+    std::atomic<bool> stop_{false};
+    std::thread thread_;
+};
+
+} // namespace SwitchPort
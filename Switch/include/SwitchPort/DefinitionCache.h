@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "SwitchPort/FileBacking.h"
+
+namespace SwitchPort {
+
+// DEF1: binary form of the definition cache, mapping each public definition word of dump.cs to the byte offsets
+// of the lines that define it. All integers are little-endian.
+//
+//   header   "DEF1", u16 version, u16 reserved, u32 dumpSize, u32 dumpMtime, u32 bucketBits,
+//            u32 nameCount, u32 offsetCount, u32 stringBytes
+//   buckets  u32[2^bucketBits + 1]   first entry of each bucket (the top bucketBits bits of the name hash)
+//   entries  {u64 hash, u32 nameOffset, u32 nameLength, u32 firstOffset, u32 offsetCount}[nameCount],
+//            sorted by hash, then name
+//   offsets  u32[offsetCount]        ascending per name
+//   strings  u8[stringBytes]         names, not terminated
+//
+// A lookup hashes the name, jumps to its bucket and compares the few entries there, so it touches O(1) pages of
+// the mapped file.
+class DefinitionCache {
+public:
+    static constexpr uint16_t kVersion = 1;
+
+    // Offsets of one name's definition lines, read in place from the file.
+    class Offsets {
+    public:
+        Offsets() = default;
+        Offsets(const uint8_t* data, uint32_t count) : data_(data), count_(count) {}
+
+        size_t size() const { return count_; }
+        bool empty() const { return count_ == 0; }
+        uint32_t operator[](size_t index) const;
+
+    private:
+        const uint8_t* data_ = nullptr;
+        uint32_t count_ = 0;
+    };
+
+    // Opens a DEF1 file and checks that its tables fit inside it. Nothing is decoded up front.
+    bool Open(const std::string& path, std::string* error);
+    void Reset();
+
+    uint32_t DumpSize() const { return dumpSize_; }
+    uint32_t DumpMtime() const { return dumpMtime_; }
+    size_t NameCount() const { return nameCount_; }
+
+    // Offsets of the lines defining name; empty when the name has no definition.
+    Offsets Find(std::string_view name) const;
+
+    static uint64_t HashName(std::string_view name);
+
+private:
+    FileBacking file_;
+    uint32_t dumpSize_ = 0;
+    uint32_t dumpMtime_ = 0;
+    uint32_t bucketBits_ = 0;
+    uint32_t nameCount_ = 0;
+    uint32_t offsetCount_ = 0;
+    const uint8_t* buckets_ = nullptr;
+    const uint8_t* entries_ = nullptr;
+    const uint8_t* offsets_ = nullptr;
+    const uint8_t* strings_ = nullptr;
+    uint32_t stringBytes_ = 0;
+};
+
+// Writes definitions ({name, dump.cs offset} pairs, sorted by name then offset, without duplicates) as a DEF1 file.
+// Offsets above 4 GiB cannot be stored and are dropped, as in the namespace index.
+bool WriteDefinitionCache(const std::string& path, const std::vector<std::pair<std::string_view, uint64_t>>& definitions,
+                          uint64_t dumpSize, uint64_t dumpMtime, std::string* error);
+
+} // namespace SwitchPort
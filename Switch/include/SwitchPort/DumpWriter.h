@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "SwitchPort/ElfImage.h"
+#include "SwitchPort/MetadataFile.h"
+#include "SwitchPort/MonotonicArena.h"
+#include "SwitchPort/RuntimeTypeSystem.h"
+
+namespace SwitchPort {
+
+using DumpProgressCallback = void (*)(const char* phase, size_t done, size_t total, void* user);
+
+// (size, mtime) of a file, used to tell whether a cache written next to it is still current.
+struct DumpSignature {
+    uint64_t size = 0;
+    uint64_t mtime = 0;
+};
+
+DumpSignature GetDumpSignature(const std::string& dumpPath);
+
+// Names point into the strings arena of the DumpIndexChunk or DumpIndex that collected the record.
+struct TypeInfoRecord {
+    uint64_t offset = 0;
+    std::string_view typeName;
+    std::string_view fullName;
+    std::string_view baseName;
+    std::string_view namespaceName;
+};
+
+struct RvaRecord {
+    uint64_t rva = 0;
+    uint32_t dumpOffset = 0;
+};
+
+// Index entries for one rendered piece of dump.cs. Offsets are relative to the start of that piece and are
+// rebased when the piece is appended to a DumpIndex. Names live in strings, whose blocks move to the DumpIndex
+// with the entries.
+struct DumpIndexChunk {
+    MonotonicArena strings;
+    std::vector<uint64_t> namespaceOffsets;
+    std::vector<std::pair<std::string_view, uint64_t>> definitions;
+    std::vector<TypeInfoRecord> typeInfos;
+    std::vector<std::pair<uint64_t, uint64_t>> rvas; // {rva, offset}
+    std::vector<std::pair<std::string_view, uint64_t>> methodNames; // {qualified name, offset of its RVA line}
+    uint32_t lines = 0;
+
+    void Clear() {
+        strings.Reset();
+        namespaceOffsets.clear();
+        definitions.clear();
+        typeInfos.clear();
+        rvas.clear();
+        methodNames.clear();
+        lines = 0;
+    }
+};
+
+// Everything the auxiliary files (definition caches, NIS1, TYP2/TYP3, IDX1/IDX2) are built from. The names of all
+// entries live in strings and are released together with the index.
+struct DumpIndex {
+    MonotonicArena strings;
+    std::vector<std::pair<std::string_view, uint64_t>> definitions; // {word, offset}, in collection order
+    std::vector<uint32_t> namespaceOffsets;
+    std::vector<TypeInfoRecord> typeInfos;
+    std::vector<RvaRecord> rvaRecords;
+    // {Type.Method or generic instance name, dump offset of its RVA line}; names the IDX2 method name section.
+    std::vector<std::pair<std::string_view, uint32_t>> methodNames;
+    uint32_t totalDumpLines = 0;
+    // Opt-in: collect methodNames and write the method name section, which makes index2 several times larger.
+    bool collectMethodNames = false;
+
+    bool AddRva(uint64_t rva, uint64_t offset, std::string* error);
+    // Moves chunk's entries in, rebased by baseOffset, and clears chunk.
+    bool Append(DumpIndexChunk& chunk, uint64_t baseOffset, std::string* error);
+};
+
+// Number of render workers WriteDumpCs should use on this platform.
+unsigned DefaultDumpWorkerCount();
+
+// Renders dump.cs to outputPath. runtimeTypes and elfImage may be null for a metadata-only dump. index and
+// progressCb are optional.
+bool WriteDumpCs(const MetadataFile& metadata, const RuntimeTypeSystem* runtimeTypes, const ElfImage* elfImage,
+                 uint64_t codeRegistration, const std::string& outputPath, unsigned workerCount, DumpIndex* index,
+                 DumpProgressCallback progressCb, void* progressUser, std::string* error);
+
+// Writes the text and DEF1 definition caches, NIS1, TYP2, TYP3, IDX2 and IDX1 files for dumpPath from the collected
+// index. IDX1/IDX2 keep the v3 layout; IDX2 carries its reverse section, and the method name section when
+// index.collectMethodNames is set, after the last block.
+bool WriteDumpAuxiliaryFiles(DumpIndex& index, const std::string& dumpPath, const std::string& index1Path,
+                             const std::string& index2Path, const std::string& definitionCachePath,
+                             const std::string& definitionIndexPath,
+                             const std::string& namespaceOffsetsPath, const std::string& typeIndexPath,
+                             const std::string& typeIndex3Path, std::string* error);
+
+// Rescans an existing dump.cs and writes the same auxiliary files as WriteDumpAuxiliaryFiles.
+bool BuildDumpAuxiliaryFiles(const std::string& dumpPath, const std::string& index1Path, const std::string& index2Path,
+                             const std::string& definitionCachePath, const std::string& definitionIndexPath,
+                             const std::string& namespaceOffsetsPath, const std::string& typeIndexPath,
+                             const std::string& typeIndex3Path, bool withMethodNames, std::string* error);
+
+} // namespace SwitchPort
@@ -1,10 +1,13 @@
 #pragma once
 
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <string>
 #include <vector>
 
+#include "SwitchPort/FileBacking.h"
+
 namespace SwitchPort {
 
 class ElfImage {
@@ -18,13 +21,25 @@ public:
     };
 
     bool Load(const std::string& path, std::string* error);
+    // Takes ownership of an ELF already in memory (e.g. converted from NSO) instead of reading a file.
+    bool LoadFromMemory(std::vector<uint8_t>&& bytes, std::string* error);
 
     // Map a virtual address to file offset. Returns false when unmapped.
     bool TryMapVaddrToOffset(uint64_t vaddr, uint64_t* outOffset) const;
     bool TryMapOffsetToVaddr(uint64_t offset, uint64_t* outVaddr) const;
 
+    // Zero-copy views into the loaded image (nullptr when out of range). Pointers stay valid until the next Load.
+    const uint8_t* ViewBytesAtVaddr(uint64_t vaddr, size_t size) const;
+    const uint8_t* ViewBytesAtOffset(uint64_t offset, size_t size) const;
+
     bool ReadBytesAtVaddr(uint64_t vaddr, size_t size, std::vector<uint8_t>* out) const;
     bool ReadBytesAtOffset(uint64_t offset, size_t size, std::vector<uint8_t>* out) const;
+    // View of count*stride bytes at vaddr, or nullptr unless the whole table lies in one segment's file bytes.
+    const uint8_t* ViewTableAtVaddr(uint64_t vaddr, uint64_t count, uint64_t stride) const;
+    // Bulk little-endian table reads: one address translation and bounds check for the whole array. Tables that
+    // leave their segment are read element by element; unreadable elements are 0 and make the call return false.
+    bool ReadU64ArrayAtVaddr(uint64_t vaddr, size_t count, std::vector<uint64_t>* out) const;
+    bool ReadU32ArrayAtVaddr(uint64_t vaddr, size_t count, std::vector<uint32_t>* out) const;
     bool ReadU8AtVaddr(uint64_t vaddr, uint8_t* out) const;
     bool ReadI32AtVaddr(uint64_t vaddr, int32_t* out) const;
     bool ReadU64AtOffset(uint64_t offset, uint64_t* out) const;
@@ -36,13 +51,32 @@ public:
     bool Is64Bit() const { return is64Bit_; }
     bool IsLittleEndian() const { return isLittleEndian_; }
     size_t LoadSegmentCount() const { return segments_.size(); }
+    // Size of the whole loaded ELF; ViewBytesAtOffset(0, ImageSize()) views all of it.
+    size_t ImageSize() const { return data_.size(); }
     const std::vector<Segment>& Segments() const { return segments_; }
 
 private:
+    // Non-overlapping vaddr ranges in ascending order, each resolved to the first segment that covers it.
+    struct VaddrRange {
+        uint64_t begin = 0;
+        uint64_t end = 0;
+        size_t segment = 0;
+    };
+
+    void Reset();
+    bool Parse(std::string* error);
+    void BuildVaddrRanges();
+    static uint64_t SegmentVaddrEnd(const Segment& seg);
+    const Segment* FindSegmentForVaddr(uint64_t vaddr) const;
+
     bool is64Bit_ = false;
     bool isLittleEndian_ = false;
-    std::vector<uint8_t> data_;
+    FileBacking data_;
     std::vector<Segment> segments_;
+    std::vector<VaddrRange> vaddrRanges_;
+    // Index into vaddrRanges_ of the last successful lookup on this image. Shared by the threads using the image;
+    // a stale value only costs the search it would have saved.
+    mutable std::atomic<size_t> lastHit_{0};
 };
 
 } // namespace SwitchPort
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace SwitchPort {
+
+// Read-only view of a whole input file. On POSIX hosts the file is mapped
+// copy-on-write so pages are faulted in on demand; on Switch (and when the
+// mapping fails) the contents are read into an owned buffer instead.
+class FileBacking {
+public:
+    FileBacking() = default;
+    ~FileBacking();
+
+    FileBacking(const FileBacking&) = delete;
+    FileBacking& operator=(const FileBacking&) = delete;
+    FileBacking(FileBacking&& other) noexcept;
+    FileBacking& operator=(FileBacking&& other) noexcept;
+
+    // Opens path and exposes its bytes. Files larger than maxBytes are rejected.
+    // label is used as the noun in error messages (e.g. "ELF file").
+    bool Open(const std::string& path, uint64_t maxBytes, const char* label, std::string* error);
+    // Takes ownership of an in-memory image instead of opening a file.
+    void Adopt(std::vector<uint8_t>&& bytes);
+    void Reset();
+
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    uint8_t operator[](size_t index) const { return data_[index]; }
+    bool IsMapped() const { return mapped_; }
+
+    // Writable pointer to the bytes. Mapped files are private mappings, so writes
+    // (e.g. applied relocations) never reach the file on disk.
+    uint8_t* MutableData() { return data_; }
+
+private:
+    uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    bool mapped_ = false;
+    std::vector<uint8_t> owned_;
+};
+
+} // namespace SwitchPort
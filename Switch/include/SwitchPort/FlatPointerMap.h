@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace SwitchPort {
+
+// Open-addressing map from nonzero 64-bit addresses to 32-bit values: keys and values live in two flat arrays and
+// collisions probe linearly, so a lookup touches one or two cache lines instead of chasing bucket nodes.
+// Key 0 marks an empty slot and cannot be stored.
+class FlatPointerMap {
+public:
+    static constexpr uint32_t kNotFound = 0xFFFFFFFFu;
+
+    void Clear();
+    // Sizes the table so count keys fit without rehashing.
+    void Reserve(size_t count);
+    // Inserts key, or replaces its value when already present.
+    void Set(uint64_t key, uint32_t value);
+
+    uint32_t Find(uint64_t key) const {
+        if (key == 0 || keys_.empty()) {
+            return kNotFound;
+        }
+        const size_t mask = keys_.size() - 1;
+        for (size_t slot = SlotFor(key); ; slot = (slot + 1) & mask) {
+            const uint64_t stored = keys_[slot];
+            if (stored == key) {
+                return values_[slot];
+            }
+            if (stored == 0) {
+                return kNotFound;
+            }
+        }
+    }
+
+    size_t Size() const { return size_; }
+
+private:
+    // Fibonacci hashing: the multiply spreads aligned addresses, the top bits select the slot.
+    size_t SlotFor(uint64_t key) const { return static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> shift_); }
+    void Rehash(size_t capacity);
+
+    std::vector<uint64_t> keys_;
+    std::vector<uint32_t> values_;
+    size_t size_ = 0;
+    unsigned shift_ = 64;
+};
+
+} // namespace SwitchPort
@@ -1,16 +1,26 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
+#include <mutex>
 #include <string>
-#include <unordered_map>
+#include <string_view>
 #include <vector>
 
+#include "SwitchPort/FileBacking.h"
 #include "SwitchPort/MetadataFormat.h"
 
 namespace SwitchPort {
 
+// Load maps the file, parses the header and image table, and bounds-checks every other table. The remaining tables
+// are decoded on first access; accessors are safe to call from several threads.
 class MetadataFile {
 public:
+    MetadataFile();
+    ~MetadataFile();
+    MetadataFile(const MetadataFile&) = delete;
+    MetadataFile& operator=(const MetadataFile&) = delete;
+
     bool Load(const std::string& path, std::string* error);
 
     const MetadataHeader& Header() const { return header_; }
@@ -35,17 +45,31 @@ public:
     }
 
     const std::vector<ImageDefinition>& Images() const { return images_; }
-    const std::vector<TypeDefinition>& Types() const { return types_; }
-    const std::vector<MethodDefinition>& Methods() const { return methods_; }
-    const std::vector<FieldDefinition>& Fields() const { return fields_; }
-    const std::vector<ParameterDefinition>& Parameters() const { return parameters_; }
-    const std::vector<GenericContainer>& GenericContainers() const { return genericContainers_; }
-    const std::vector<GenericParameter>& GenericParameters() const { return genericParameters_; }
-    const std::vector<PropertyDefinition>& Properties() const { return properties_; }
-    const std::vector<EventDefinition>& Events() const { return events_; }
-    const std::vector<CustomAttributeDataRange>& AttributeDataRanges() const { return attributeDataRanges_; }
-    const std::vector<int32_t>& NestedTypeIndices() const { return nestedTypeIndices_; }
-    const std::vector<int32_t>& InterfaceIndices() const { return interfaceIndices_; }
+    const std::vector<TypeDefinition>& Types() const { return Table(tables_->types, &MetadataFile::ParseTypes); }
+    const std::vector<MethodDefinition>& Methods() const { return Table(tables_->methods, &MetadataFile::ParseMethods); }
+    const std::vector<FieldDefinition>& Fields() const { return Table(tables_->fields, &MetadataFile::ParseFields); }
+    const std::vector<ParameterDefinition>& Parameters() const {
+        return Table(tables_->parameters, &MetadataFile::ParseParameters);
+    }
+    const std::vector<GenericContainer>& GenericContainers() const {
+        return Table(tables_->genericContainers, &MetadataFile::ParseGenericContainers);
+    }
+    const std::vector<GenericParameter>& GenericParameters() const {
+        return Table(tables_->genericParameters, &MetadataFile::ParseGenericParameters);
+    }
+    const std::vector<PropertyDefinition>& Properties() const {
+        return Table(tables_->properties, &MetadataFile::ParseProperties);
+    }
+    const std::vector<EventDefinition>& Events() const { return Table(tables_->events, &MetadataFile::ParseEvents); }
+    const std::vector<CustomAttributeDataRange>& AttributeDataRanges() const {
+        return Table(tables_->attributeDataRanges, &MetadataFile::ParseAttributeDataRanges);
+    }
+    const std::vector<int32_t>& NestedTypeIndices() const {
+        return Table(tables_->nestedTypeIndices, &MetadataFile::ParseNestedTypes);
+    }
+    const std::vector<int32_t>& InterfaceIndices() const {
+        return Table(tables_->interfaceIndices, &MetadataFile::ParseInterfaces);
+    }
     bool TryGetFieldDefaultValue(int32_t fieldIndex, FieldDefaultValue* out) const;
     bool TryGetParameterDefaultValue(int32_t parameterIndex, ParameterDefaultValue* out) const;
 
@@ -61,47 +85,71 @@ public:
     bool ReadF64AtMetadataOffset(uint32_t absOffset, double* out) const;
     bool ReadStringBlobAtMetadataOffset(uint32_t absOffset, std::string* out) const;
 
+    // size bytes at absOffset, viewed in place; empty when the range is outside the file.
+    std::string_view GetBytesView(uint32_t absOffset, uint32_t size) const;
+
     std::string GetString(uint32_t index) const;
+    // Zero-copy variant of GetString; the view points into the file backing and lives as long as this object.
+    std::string_view GetStringView(uint32_t index) const;
 
 private:
+    template <typename T>
+    struct LazyTable {
+        std::once_flag once;
+        std::vector<T> rows;
+    };
+
+    // Recreated by every Load, since a once_flag cannot be reset.
+    struct Tables {
+        LazyTable<TypeDefinition> types;
+        LazyTable<MethodDefinition> methods;
+        LazyTable<FieldDefinition> fields;
+        LazyTable<ParameterDefinition> parameters;
+        LazyTable<GenericContainer> genericContainers;
+        LazyTable<GenericParameter> genericParameters;
+        LazyTable<PropertyDefinition> properties;
+        LazyTable<EventDefinition> events;
+        LazyTable<CustomAttributeDataRange> attributeDataRanges;
+        LazyTable<int32_t> nestedTypeIndices;
+        LazyTable<int32_t> interfaceIndices;
+        // Sorted by field/parameter index for binary search.
+        LazyTable<FieldDefaultValue> fieldDefaultValues;
+        LazyTable<ParameterDefaultValue> parameterDefaultValues;
+    };
+
+    template <typename T>
+    const std::vector<T>& Table(LazyTable<T>& table, void (MetadataFile::*parse)(std::vector<T>*) const) const {
+        std::call_once(table.once, [&]() { (this->*parse)(&table.rows); });
+        return table.rows;
+    }
+
     bool ParseHeader(std::string* error);
     bool ParseImages(std::string* error);
-    bool ParseTypes(std::string* error);
-    bool ParseMethods(std::string* error);
-    bool ParseFields(std::string* error);
-    bool ParseParameters(std::string* error);
-    bool ParseGenericParameters(std::string* error);
-    bool ParseGenericContainers(std::string* error);
-    bool ParseProperties(std::string* error);
-    bool ParseEvents(std::string* error);
-    bool ParseNestedTypes(std::string* error);
-    bool ParseInterfaces(std::string* error);
-    bool ParseFieldDefaultValues(std::string* error);
-    bool ParseParameterDefaultValues(std::string* error);
-    bool ParseAttributeDataRanges(std::string* error);
+    // Table decoders. Load has already bounds-checked each table against the file, so they cannot run past it.
+    void ParseTypes(std::vector<TypeDefinition>* out) const;
+    void ParseMethods(std::vector<MethodDefinition>* out) const;
+    void ParseFields(std::vector<FieldDefinition>* out) const;
+    void ParseParameters(std::vector<ParameterDefinition>* out) const;
+    void ParseGenericParameters(std::vector<GenericParameter>* out) const;
+    void ParseGenericContainers(std::vector<GenericContainer>* out) const;
+    void ParseProperties(std::vector<PropertyDefinition>* out) const;
+    void ParseEvents(std::vector<EventDefinition>* out) const;
+    void ParseNestedTypes(std::vector<int32_t>* out) const;
+    void ParseInterfaces(std::vector<int32_t>* out) const;
+    void ParseFieldDefaultValues(std::vector<FieldDefaultValue>* out) const;
+    void ParseParameterDefaultValues(std::vector<ParameterDefaultValue>* out) const;
+    void ParseAttributeDataRanges(std::vector<CustomAttributeDataRange>* out) const;
 
     void SetError(std::string* error, const std::string& message) const;
 
-    std::vector<uint8_t> data_;
+    FileBacking data_;
     MetadataHeader header_;
     int typeIndexSize_ = 4;
     int typeDefinitionIndexSize_ = 4;
     int genericContainerIndexSize_ = 4;
     int parameterIndexSize_ = 4;
     std::vector<ImageDefinition> images_;
-    std::vector<TypeDefinition> types_;
-    std::vector<MethodDefinition> methods_;
-    std::vector<FieldDefinition> fields_;
-    std::vector<ParameterDefinition> parameters_;
-    std::vector<GenericContainer> genericContainers_;
-    std::vector<GenericParameter> genericParameters_;
-    std::vector<PropertyDefinition> properties_;
-    std::vector<EventDefinition> events_;
-    std::vector<CustomAttributeDataRange> attributeDataRanges_;
-    std::vector<int32_t> nestedTypeIndices_;
-    std::vector<int32_t> interfaceIndices_;
-    std::unordered_map<int32_t, FieldDefaultValue> fieldDefaultValues_;
-    std::unordered_map<int32_t, ParameterDefaultValue> parameterDefaultValues_;
+    std::unique_ptr<Tables> tables_;
 };
 
 } // namespace SwitchPort
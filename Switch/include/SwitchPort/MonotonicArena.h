@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace SwitchPort {
+
+// Bump allocator for data that lives as long as one phase of a dump run (type names, index strings). Allocations
+// are carved from large blocks and never freed one by one; Reset() or destruction releases every block at once, so
+// a phase does not leave thousands of small strings scattered over the heap. Memory handed out stays where it is
+// until then, which keeps views into it valid while the arena grows.
+//
+// Not thread-safe: each worker fills its own arena, and Adopt() moves the blocks to whoever keeps the data.
+class MonotonicArena {
+public:
+    static constexpr size_t kDefaultBlockBytes = 256u * 1024u;
+
+    explicit MonotonicArena(size_t blockBytes = kDefaultBlockBytes) : blockBytes_(blockBytes) {}
+    MonotonicArena(const MonotonicArena&) = delete;
+    MonotonicArena& operator=(const MonotonicArena&) = delete;
+    MonotonicArena(MonotonicArena&& other) noexcept;
+    MonotonicArena& operator=(MonotonicArena&& other) noexcept;
+
+    void* Allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+    // Copies text into the arena; the view stays valid until the arena holding the block is reset or destroyed.
+    std::string_view Copy(std::string_view text);
+
+    // Takes over other's blocks, leaving it empty. Views into other's memory stay valid and now live as long as
+    // this arena.
+    void Adopt(MonotonicArena& other);
+    // Frees every block.
+    void Reset();
+
+    size_t BytesReserved() const { return reserved_; }
+
+private:
+    uint8_t* AllocateBlock(size_t bytes);
+
+    std::vector<std::unique_ptr<uint8_t[]>> blocks_;
+    uint8_t* cursor_ = nullptr;
+    uint8_t* limit_ = nullptr;
+    size_t blockBytes_ = kDefaultBlockBytes;
+    size_t reserved_ = 0;
+};
+
+} // namespace SwitchPort
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
+#include <vector>
 
 namespace SwitchPort {
 
@@ -8,4 +10,7 @@ namespace SwitchPort {
 // containing PT_LOAD + PT_DYNAMIC program headers.
 bool ConvertNsoLikeToElf(const std::string& inputPath, const std::string& outputElfPath, std::string* error);
 
+// Same conversion without the file round-trip: the ELF bytes are returned for ElfImage::LoadFromMemory.
+bool ConvertNsoLikeToElfImage(const std::string& inputPath, std::vector<uint8_t>* outElf, std::string* error);
+
 } // namespace SwitchPort
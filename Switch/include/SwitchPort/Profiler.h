@@ -0,0 +1,91 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace SwitchPort {
+
+// Counters collected during a run. Names used in reports are listed in Profiler.cpp in the same order.
+enum class ProfileCounter : size_t {
+    InputBytesRead,
+    DumpBytesRendered,
+    MetadataStringsAllocated,
+    TypeNameCacheHits,
+    TypeNameCacheMisses,
+    PointerTypeCacheHits,
+    PointerTypeCacheMisses,
+    ElfVaddrSearches,
+    RegistrationCandidates,
+    Count
+};
+
+constexpr size_t kProfileCounterCount = static_cast<size_t>(ProfileCounter::Count);
+
+namespace detail {
+
+// Per-thread counter slots. Only the owning thread writes them, so increments need no read-modify-write; the
+// atomics only make concurrent report reads well-defined.
+struct ThreadProfileCounters {
+    ThreadProfileCounters();
+    ~ThreadProfileCounters();
+    std::array<std::atomic<uint64_t>, kProfileCounterCount> values{};
+};
+
+inline thread_local ThreadProfileCounters tlsProfileCounters;
+
+} // namespace detail
+
+// Phase timers, counters and peak memory for one process run, written out as JSON or CSV. Counters may be bumped
+// from any thread. Phases may be timed on any thread but must end on the thread that began them.
+class Profiler {
+public:
+    static void Count(ProfileCounter counter, uint64_t amount = 1) {
+        auto& slot = detail::tlsProfileCounters.values[static_cast<size_t>(counter)];
+        slot.store(slot.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+    static uint64_t CounterValue(ProfileCounter counter);
+
+    // Phases nest: a phase begun while another is open on the same thread records it as its parent.
+    static size_t BeginPhase(const std::string& name);
+    // Returns the phase duration in milliseconds.
+    static long long EndPhase(size_t phase);
+    // Innermost phase open on the calling thread (or its parent phase, see below); -1 when there is none.
+    static long long CurrentPhase();
+    // Phases begun on the calling thread while it has none open nest under phase. Worker threads call this with
+    // the spawning thread's CurrentPhase() so their phases appear inside the step that started them.
+    static void SetThreadParentPhase(long long phase);
+
+    // Peak resident memory where the platform reports it, otherwise the highest usage sampled at phase ends.
+    static uint64_t PeakMemoryBytes();
+
+    static bool WriteJson(const std::string& path, std::string* error);
+    static bool WriteCsv(const std::string& path, std::string* error);
+};
+
+// Times the enclosing scope as a profiler phase.
+class ScopedPhase {
+public:
+    explicit ScopedPhase(const std::string& name) : phase_(Profiler::BeginPhase(name)) {}
+    ~ScopedPhase() { End(); }
+    ScopedPhase(const ScopedPhase&) = delete;
+    ScopedPhase& operator=(const ScopedPhase&) = delete;
+
+    // Ends the phase before the scope does; later calls return the same duration.
+    long long End() {
+        if (!ended_) {
+            ended_ = true;
+            elapsedMs_ = Profiler::EndPhase(phase_);
+        }
+        return elapsedMs_;
+    }
+
+private:
+    size_t phase_;
+    bool ended_ = false;
+    long long elapsedMs_ = 0;
+};
+
+} // namespace SwitchPort
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <vector>
 
 #include "SwitchPort/ElfImage.h"
 
@@ -16,22 +17,61 @@ class RegistrationFinder {
 public:
     explicit RegistrationFinder(const ElfImage& elf) : elf_(elf) {}
 
-    RegistrationResult Find(double il2cppVersion, int typeDefinitionsCount, int imageCount) const;
+    // With workerCount > 1 every scan is split into segment chunks that run on that many threads, and the
+    // fallback strategies are tried speculatively in the same pass; the result is the same as the sequential search.
+    RegistrationResult Find(double il2cppVersion, int typeDefinitionsCount, int imageCount,
+                            unsigned workerCount = 1) const;
 
 private:
+    // First hit of each MetadataRegistration strategy, in segment/offset scan order; 0 when it found nothing.
+    struct MetadataRegistrationCandidates {
+        uint64_t execTypes = 0; // v21 layout, type pointers into executable segments
+        uint64_t dataTypes = 0; // v21 layout, type pointers into data segments
+        uint64_t heuristic = 0;
+    };
+
     bool IsInDataOffset(uint64_t offset) const;
     bool IsInExecVaddr(uint64_t addr) const;
     bool IsInDataVaddr(uint64_t addr) const;
 
-    uint64_t FindCodeRegistration(double il2cppVersion, int imageCount, bool* pointerInExec) const;
+    uint64_t FindCodeRegistration(double il2cppVersion, int imageCount, unsigned workerCount, bool* pointerInExec) const;
     uint64_t FindCodeRegistrationInSegments(double il2cppVersion, int imageCount, bool executableSegments) const;
+    // Follows the reference chain from one "mscorlib.dll" string to a CodeRegistration candidate.
+    bool TryCodeRegistrationFromFeature(double il2cppVersion, int imageCount, uint64_t featureVa,
+                                        uint64_t* codeRegistration) const;
     uint64_t FindMetadataRegistrationV21(int typeDefinitionsCount, bool pointerInExec) const;
     uint64_t FindMetadataRegistrationHeuristic(int typeDefinitionsCount) const;
+    // Runs both v21 variants and the heuristic over the data segments in one chunked pass.
+    MetadataRegistrationCandidates ScanMetadataRegistrationCandidates(int typeDefinitionsCount,
+                                                                      unsigned workerCount) const;
     uint64_t RefineMetadataRegistrationAround(uint64_t candidate, int typeDefinitionsCount) const;
+    // Prefers the v21 candidate matching pointerInExec, then the other v21 candidate, then the heuristic one.
+    uint64_t ResolveMetadataRegistration(const MetadataRegistrationCandidates& candidates, bool pointerInExec,
+                                         int typeDefinitionsCount) const;
+
+    // Slot checks shared by the sequential and chunked scans; off is the file offset of the candidate slot, whose
+    // first word already equals typeDefinitionsCount for the v21 check.
+    bool ReadV21TypesTable(uint64_t off, int typeDefinitionsCount, uint64_t* typesOffset) const;
+    bool TypePointersIn(uint64_t typesOffset, int typeDefinitionsCount, bool pointerInExec) const;
+    bool IsHeuristicMetadataRegistration(uint64_t off, int typeDefinitionsCount) const;
+
+    // Data-segment slots holding pointer-like values, sorted by value, so each lookup is a binary search
+    // instead of a pass over every data segment. Built on first use, or up front by the parallel search.
+    struct PointerSlot {
+        uint64_t value = 0;
+        uint64_t fileOffset = 0;
+    };
 
+    void BuildPointerIndex(unsigned workerCount = 1) const;
+    bool IsIndexedPointerValue(uint64_t value) const;
     std::vector<uint64_t> FindReferencesInData(uint64_t addr) const;
+    std::vector<uint64_t> ScanReferencesInData(uint64_t addr) const;
 
     const ElfImage& elf_;
+    mutable bool pointerIndexBuilt_ = false;
+    mutable uint64_t pointerRangeBegin_ = 0;
+    mutable uint64_t pointerRangeEnd_ = 0;
+    mutable std::vector<PointerSlot> pointerIndex_;
 };
 
 } // namespace SwitchPort
@@ -1,14 +1,17 @@
 #pragma once
 
 #include <cstdint>
+#include <mutex>
+#include <optional>
 #include <string>
-#include <unordered_map>
 #include <vector>
 
 #include "SwitchPort/ElfImage.h"
+#include "SwitchPort/FlatPointerMap.h"
 
 namespace SwitchPort {
 
+// One Il2CppType, assembled on demand from the type table columns.
 struct RuntimeType {
     uint64_t pointer = 0;
     uint64_t data = 0;
@@ -52,10 +55,10 @@ class RuntimeTypeSystem {
 public:
     bool Load(const ElfImage& elf, uint64_t metadataRegistrationVa, double metadataVersion, std::string* error);
 
-    const RuntimeType* GetTypeByIndex(int32_t index) const;
-    const RuntimeType* GetTypeByPointer(uint64_t pointer) const;
+    std::optional<RuntimeType> GetTypeByIndex(int32_t index) const;
+    std::optional<RuntimeType> GetTypeByPointer(uint64_t pointer) const;
     int32_t FindTypeIndexByPointer(uint64_t pointer) const;
-    bool HasTypes() const { return !types_.empty(); }
+    bool HasTypes() const { return !typePointers_.empty(); }
     const MetadataRegistration& Registration() const { return metadataRegistration_; }
     const std::vector<uint64_t>& GenericInstPointers() const { return genericInstPointers_; }
     const std::vector<MethodSpec>& MethodSpecs() const { return methodSpecs_; }
@@ -69,13 +72,20 @@ private:
     bool fieldOffsetsArePointers_ = false;
     std::vector<uint64_t> fieldOffsets_;
     MetadataRegistration metadataRegistration_;
+    // types[] as parallel columns; attrs/type/byref are decoded from typeBits_ when a RuntimeType is built.
     std::vector<uint64_t> typePointers_;
-    std::vector<RuntimeType> types_;
+    std::vector<uint64_t> typeData_;
+    std::vector<uint32_t> typeBits_;
+    FlatPointerMap pointerToIndex_;
     std::vector<uint64_t> genericInstPointers_;
     std::vector<MethodSpec> methodSpecs_;
     std::vector<GenericMethodTableEntry> genericMethodTable_;
-    std::unordered_map<uint64_t, int32_t> pointerToIndex_;
-    mutable std::unordered_map<uint64_t, RuntimeType> pointerTypeCache_;
+    // Il2CppTypes reached through pointers outside types[] (array elements, generic arguments), read once and kept
+    // in the same column layout. The mutex lets dump workers resolve pointer types concurrently.
+    mutable std::mutex pointerTypeCacheMutex_;
+    mutable FlatPointerMap pointerTypeCache_;
+    mutable std::vector<uint64_t> cachedTypeData_;
+    mutable std::vector<uint32_t> cachedTypeBits_;
 };
 
 } // namespace SwitchPort
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace SwitchPort {
+
+// Runs a handful of dependent pipeline steps on a few threads. A task starts once every task it depends on has
+// succeeded; when a task fails, everything that depends on it is skipped. Dependencies must be added first, so
+// insertion order is always a valid sequential order. Tasks report failure by returning false; an exception thrown
+// by a task fails it and is rethrown from Run once the other running tasks have finished.
+class TaskGraph {
+public:
+    using TaskId = size_t;
+
+    enum class TaskState {
+        Pending,
+        Succeeded,
+        Failed,
+        Skipped,
+    };
+
+    TaskId Add(std::string name, std::vector<TaskId> dependencies, std::function<bool()> run);
+
+    // Runs every task using up to workerCount threads, including the calling one. With workerCount 1 tasks run on
+    // the calling thread in insertion order. Tasks started on other threads nest their profiler phases under the
+    // caller's current phase.
+    void Run(unsigned workerCount);
+
+    TaskState State(TaskId task) const { return tasks_[task].state; }
+    bool Succeeded(TaskId task) const { return tasks_[task].state == TaskState::Succeeded; }
+
+private:
+    struct Task {
+        std::string name;
+        std::vector<TaskId> dependencies;
+        std::function<bool()> run;
+        TaskState state = TaskState::Pending;
+        bool started = false;
+    };
+
+    std::vector<Task> tasks_;
+};
+
+// Threads the pipeline should use on this platform.
+unsigned DefaultTaskWorkerCount();
+
+} // namespace SwitchPort
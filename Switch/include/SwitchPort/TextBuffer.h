@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace SwitchPort {
+
+// Append-only text buffer for rendering dump.cs. Numbers are formatted with std::to_chars straight into the buffer,
+// so a line costs no stream state changes or temporary strings. Clearing keeps the allocation for the next batch.
+class TextBuffer {
+public:
+    TextBuffer& operator<<(std::string_view text) {
+        data_.append(text.data(), text.size());
+        return *this;
+    }
+    TextBuffer& operator<<(char c) {
+        data_.push_back(c);
+        return *this;
+    }
+
+    TextBuffer& AppendDecimal(int64_t value);
+    TextBuffer& AppendDecimal(uint64_t value);
+    TextBuffer& AppendDecimal(int32_t value) { return AppendDecimal(static_cast<int64_t>(value)); }
+    TextBuffer& AppendDecimal(uint32_t value) { return AppendDecimal(static_cast<uint64_t>(value)); }
+    // Uppercase hexadecimal without a prefix or padding, as std::uppercase << std::hex prints it.
+    TextBuffer& AppendHex(uint64_t value);
+
+    size_t Size() const { return data_.size(); }
+    bool Empty() const { return data_.empty(); }
+    std::string_view View() const { return data_; }
+    void Clear() { data_.clear(); }
+    void Reserve(size_t bytes) { data_.reserve(bytes); }
+    // Exchanges contents (and allocations) with other.
+    void Swap(TextBuffer& other) noexcept { data_.swap(other.data_); }
+
+private:
+    std::string data_;
+};
+
+} // namespace SwitchPort
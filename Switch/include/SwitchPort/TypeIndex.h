@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "SwitchPort/FileBacking.h"
+
+namespace SwitchPort {
+
+struct TypeInfoRecord;
+
+// TYP3: the type index of dump.cs with fixed-size records and name lookups. TYP2 stays the format shared with the
+// C# tool; TYP3 is written next to it. All integers are little-endian.
+//
+//   header   "TYP3", u16 version, u16 reserved, u32 dumpSize, u32 dumpMtime, u32 typeCount, u32 stringCount,
+//            u32 derivedCount, u32 stringBytes
+//   strings  {u32 offset, u32 length}[stringCount]   deduplicated and sorted bytewise, so ids compare like names
+//   types    {u32 dumpOffset, u32 typeName, u32 fullName, u32 baseName, u32 namespaceName, u32 baseType,
+//            u32 firstDerived, u32 derivedCount}[typeCount], in dump offset order; names are string ids
+//   byFull   u32[typeCount]    type indices sorted by full name, then dump offset
+//   byBase   u32[typeCount]    type indices sorted by base name, then dump offset
+//   derived  u32[derivedCount] type indices, grouped per base type
+//   bytes    u8[stringBytes]   string contents, not terminated
+//
+// baseType is the type the base name resolves to: the first type whose full name matches it, otherwise the first
+// whose short name does (dump.cs writes most bases unqualified). Types whose base does not resolve hold kNoType.
+class TypeIndex {
+public:
+    static constexpr uint16_t kVersion = 1;
+    static constexpr uint32_t kNoType = 0xFFFFFFFFu;
+
+    // Type indices read in place from one of the index tables.
+    class TypeList {
+    public:
+        TypeList() = default;
+        TypeList(const uint8_t* data, uint32_t count) : data_(data), count_(count) {}
+
+        size_t size() const { return count_; }
+        bool empty() const { return count_ == 0; }
+        uint32_t operator[](size_t index) const;
+
+    private:
+        const uint8_t* data_ = nullptr;
+        uint32_t count_ = 0;
+    };
+
+    struct Type {
+        uint32_t dumpOffset = 0;
+        std::string_view typeName;
+        std::string_view fullName;
+        std::string_view baseName;
+        std::string_view namespaceName;
+        uint32_t baseType = kNoType;
+    };
+
+    // Opens a TYP3 file and checks that its tables fit inside it. Nothing is decoded up front.
+    bool Open(const std::string& path, std::string* error);
+    void Reset();
+
+    uint32_t DumpSize() const { return dumpSize_; }
+    uint32_t DumpMtime() const { return dumpMtime_; }
+    size_t TypeCount() const { return typeCount_; }
+
+    // index must be below TypeCount().
+    Type GetType(uint32_t index) const;
+
+    // Types with the given full name (several when dump.cs repeats one), in dump offset order.
+    TypeList FindByFullName(std::string_view fullName) const;
+    // Types declaring baseName as their base, as written in dump.cs, in dump offset order.
+    TypeList FindByBaseName(std::string_view baseName) const;
+    // Types whose base resolves to the type at index.
+    TypeList DerivedTypes(uint32_t index) const;
+    // The type whose declaration is the last one starting at or before dumpOffset, i.e. the type enclosing that
+    // position in dump.cs, or kNoType when dumpOffset precedes every type.
+    uint32_t FindTypeAtOffset(uint32_t dumpOffset) const;
+
+private:
+    std::string_view String(uint32_t id) const;
+    // Id of name in the sorted string table, or kNoType.
+    uint32_t FindString(std::string_view name) const;
+    // Entries of a name-sorted table whose name field (at fieldOffset in the type record) is the string id.
+    TypeList EqualRange(const uint8_t* table, size_t fieldOffset, uint32_t id) const;
+
+    FileBacking file_;
+    uint32_t dumpSize_ = 0;
+    uint32_t dumpMtime_ = 0;
+    uint32_t typeCount_ = 0;
+    uint32_t stringCount_ = 0;
+    uint32_t derivedCount_ = 0;
+    uint32_t stringBytes_ = 0;
+    const uint8_t* strings_ = nullptr;
+    const uint8_t* types_ = nullptr;
+    const uint8_t* byFullName_ = nullptr;
+    const uint8_t* byBaseName_ = nullptr;
+    const uint8_t* derived_ = nullptr;
+    const uint8_t* bytes_ = nullptr;
+};
+
+// Writes types (sorted by dump offset) as a TYP3 file. Offsets above 4 GiB are clamped, as in TYP2.
+bool WriteTypeIndex(const std::string& path, const std::vector<TypeInfoRecord>& types, uint64_t dumpSize,
+                    uint64_t dumpMtime, std::string* error);
+
+} // namespace SwitchPort
@@ -0,0 +1,404 @@
+#include "QueryServer.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <limits>
+
+#include "SwitchPort/DumpWriter.h"
+
+namespace SwitchPort {
+
+namespace {
+
+namespace fs = std::filesystem;
+
+constexpr uint16_t kFieldStatic = 0x0010u;
+constexpr uint16_t kFieldLiteral = 0x0040u;
+
+// Batches smaller than this are answered on the calling thread; waking the pool would cost more than the queries.
+constexpr size_t kInlineBatch = 8;
+// Requests held for one batch; a session that sends more before the empty line is answered with an error and closed.
+constexpr size_t kMaxBatchRequests = 4096;
+
+std::string_view TrimView(std::string_view value) {
+    while (!value.empty() && std::isspace(static_cast<unsigned char>(value.front())) != 0) {
+        value.remove_prefix(1);
+    }
+    while (!value.empty() && std::isspace(static_cast<unsigned char>(value.back())) != 0) {
+        value.remove_suffix(1);
+    }
+    return value;
+}
+
+bool StartsWith(std::string_view value, std::string_view prefix) {
+    return value.size() >= prefix.size() && value.compare(0, prefix.size(), prefix) == 0;
+}
+
+// Parses a hex number, with or without 0x, that makes up all of text.
+bool ParseHex(std::string_view text, uint64_t* out) {
+    if (StartsWith(text, "0x") || StartsWith(text, "0X")) {
+        text.remove_prefix(2);
+    }
+    if (text.empty() || text.size() > 16) {
+        return false;
+    }
+    uint64_t value = 0;
+    for (const char c : text) {
+        const int digit = std::isdigit(static_cast<unsigned char>(c)) != 0 ? c - '0'
+                          : (c >= 'a' && c <= 'f')                        ? c - 'a' + 10
+                          : (c >= 'A' && c <= 'F')                        ? c - 'A' + 10
+                                                                           : -1;
+        if (digit < 0) {
+            return false;
+        }
+        value = (value << 4) | static_cast<uint64_t>(digit);
+    }
+    *out = value;
+    return true;
+}
+
+void AppendHex(std::string* out, uint64_t value) {
+    char text[24];
+    std::snprintf(text, sizeof(text), "0x%" PRIX64, value);
+    out->append(text);
+}
+
+void AppendError(std::string* response, std::string_view message) {
+    response->append("error\t").append(message).push_back('\n');
+}
+
+void AppendOk(std::string* response, size_t resultCount) {
+    response->append("ok\t").append(std::to_string(resultCount)).push_back('\n');
+}
+
+} // namespace
+
+bool QueryEngine::Open(const QuerySources& sources, std::string* error) {
+    if (sources.metadata == nullptr || sources.elf == nullptr) {
+        if (error != nullptr) {
+            *error = "query engine needs loaded metadata and ELF";
+        }
+        return false;
+    }
+    sources_ = sources;
+    const fs::path dumpPath = sources.dumpPath;
+    const fs::path dir = dumpPath.has_parent_path() ? dumpPath.parent_path() : fs::current_path();
+    if (!dump_.Open(sources.dumpPath, std::numeric_limits<uint32_t>::max(), "dump.cs", error) ||
+        !types_.Open((dir / "dumpcs_type_index3.bin").string(), error) ||
+        !rvas_.Load((dir / "index1.bin").string(), (dir / "index2.bin").string(), error)) {
+        return false;
+    }
+    // TYP3 records the dump.cs it was built from; offsets into any other dump.cs would point at the wrong lines.
+    const DumpSignature sig = GetDumpSignature(sources.dumpPath);
+    const auto clamp = [](uint64_t value) {
+        return static_cast<uint32_t>(std::min<uint64_t>(value, std::numeric_limits<uint32_t>::max()));
+    };
+    if (types_.DumpSize() != clamp(sig.size) || types_.DumpMtime() != clamp(sig.mtime)) {
+        if (error != nullptr) {
+            *error = "index files do not match " + sources.dumpPath + "; regenerate them with switch_il2cpp_metadata";
+        }
+        return false;
+    }
+    return true;
+}
+
+void QueryEngine::Answer(std::string_view request, std::string* response) const {
+    request = TrimView(request);
+    const size_t space = request.find(' ');
+    const std::string_view verb = request.substr(0, space);
+    const std::string_view argument = space == std::string_view::npos ? std::string_view() : TrimView(request.substr(space));
+    if (verb == "rva") {
+        AnswerRva(argument, response);
+    } else if (verb == "type") {
+        AnswerType(argument, response);
+    } else if (verb == "field") {
+        AnswerField(argument, response);
+    } else if (verb == "method") {
+        AnswerMethod(argument, response);
+    } else if (verb == "ping") {
+        AppendOk(response, 0);
+    } else {
+        AppendError(response, "unknown query");
+    }
+}
+
+void QueryEngine::AnswerRva(std::string_view argument, std::string* response) const {
+    uint64_t rva = 0;
+    if (!ParseHex(argument, &rva)) {
+        AppendError(response, "expected a hex RVA");
+        return;
+    }
+    uint32_t offset = 0;
+    if (!rvas_.FindClosestLowerOrEqualLine(rva, &offset) || offset >= dump_.size()) {
+        AppendError(response, "no method at or below this RVA");
+        return;
+    }
+    // The index points at the RVA comment; the declaration (or, for generic instances, the first instance name)
+    // is on the next line.
+    const std::string_view rvaLine = DumpLine(offset);
+    uint64_t methodRva = 0;
+    const size_t rvaAt = rvaLine.find("RVA: ");
+    if (rvaAt != std::string_view::npos) {
+        const std::string_view digits = rvaLine.substr(rvaAt + 5);
+        ParseHex(digits.substr(0, digits.find(' ')), &methodRva);
+    }
+    std::string_view declaration = DumpLine(offset + rvaLine.size() + 1);
+    if (StartsWith(declaration, "\t|-")) {
+        declaration.remove_prefix(3);
+    }
+    declaration = TrimView(declaration);
+    const uint32_t typeAt = types_.FindTypeAtOffset(offset);
+    const std::string_view typeName = typeAt != TypeIndex::kNoType ? types_.GetType(typeAt).fullName : std::string_view();
+
+    AppendOk(response, 1);
+    AppendHex(response, methodRva);
+    response->push_back('\t');
+    AppendHex(response, offset);
+    response->append("\t").append(typeName).append("\t").append(declaration).push_back('\n');
+}
+
+void QueryEngine::AnswerType(std::string_view argument, std::string* response) const {
+    const TypeIndex::TypeList matches = types_.FindByFullName(argument);
+    AppendOk(response, matches.size());
+    for (size_t i = 0; i < matches.size(); ++i) {
+        const TypeIndex::Type type = types_.GetType(matches[i]);
+        response->append(type.fullName).append("\t").append(type.namespaceName).append("\t").append(type.baseName);
+        response->push_back('\t');
+        AppendHex(response, type.dumpOffset);
+        response->append("\t").append(std::to_string(TypeDefIndexAt(type.dumpOffset))).push_back('\n');
+    }
+}
+
+void QueryEngine::AnswerField(std::string_view argument, std::string* response) const {
+    // Type names may contain spaces ("Dictionary<TKey, TValue>"); the field name is the last word.
+    const size_t space = argument.rfind(' ');
+    if (space == std::string_view::npos) {
+        AppendError(response, "expected a type name and a field name");
+        return;
+    }
+    const std::string_view typeName = TrimView(argument.substr(0, space));
+    const std::string_view fieldName = argument.substr(space + 1);
+    if (sources_.runtimeTypes == nullptr) {
+        AppendError(response, "field offsets need the runtime type table");
+        return;
+    }
+    const TypeIndex::TypeList matches = types_.FindByFullName(typeName);
+    if (matches.empty()) {
+        AppendError(response, "no such type");
+        return;
+    }
+
+    const MetadataFile& metadata = *sources_.metadata;
+    const auto& types = metadata.Types();
+    const auto& fields = metadata.Fields();
+    const double version = static_cast<double>(metadata.Header().version);
+    std::string results;
+    size_t resultCount = 0;
+    for (size_t m = 0; m < matches.size(); ++m) {
+        const int32_t typeIndex = TypeDefIndexAt(types_.GetType(matches[m]).dumpOffset);
+        if (typeIndex < 0 || static_cast<size_t>(typeIndex) >= types.size()) {
+            continue;
+        }
+        const auto& type = types[static_cast<size_t>(typeIndex)];
+        if (type.fieldCount == 0 || type.fieldStart < 0) {
+            continue;
+        }
+        const size_t fieldStart = static_cast<size_t>(type.fieldStart);
+        const size_t fieldEnd = std::min(fieldStart + type.fieldCount, fields.size());
+        for (size_t i = fieldStart; i < fieldEnd; ++i) {
+            const std::string_view name = metadata.GetStringView(fields[i].nameIndex);
+            if (fieldName != "*" && name != fieldName) {
+                continue;
+            }
+            const auto fieldRt = sources_.runtimeTypes->GetTypeByIndex(fields[i].typeIndex);
+            const uint16_t attrs = fieldRt ? fieldRt->attrs : 0;
+            if ((attrs & kFieldLiteral) != 0) {
+                continue; // constants have no storage
+            }
+            const bool isStatic = (attrs & kFieldStatic) != 0;
+            const int32_t offset = sources_.runtimeTypes->GetFieldOffsetFromIndex(
+                *sources_.elf, version, typeIndex, static_cast<int32_t>(i - fieldStart), static_cast<int32_t>(i),
+                type.IsValueType(), isStatic);
+            results.append(typeName).append("\t").append(name).push_back('\t');
+            if (offset < 0) {
+                results.append("unknown"); // no offset table entry (or a thread-static field)
+            } else {
+                AppendHex(&results, static_cast<uint32_t>(offset));
+            }
+            results.append(isStatic ? "\tstatic\n" : "\tinstance\n");
+            ++resultCount;
+        }
+    }
+    AppendOk(response, resultCount);
+    response->append(results);
+}
+
+void QueryEngine::AnswerMethod(std::string_view argument, std::string* response) const {
+    if (!rvas_.HasMethodNames()) {
+        AppendError(response, "index2.bin has no method name section; rebuild it with --method-names");
+        return;
+    }
+    std::vector<uint64_t> found;
+    rvas_.FindRvasByMethodName(argument, &found);
+    AppendOk(response, found.size());
+    for (const uint64_t rva : found) {
+        AppendHex(response, rva);
+        response->push_back('\n');
+    }
+}
+
+std::string_view QueryEngine::DumpLine(size_t offset) const {
+    if (offset >= dump_.size()) {
+        return {};
+    }
+    const char* start = reinterpret_cast<const char*>(dump_.data()) + offset;
+    std::string_view rest(start, dump_.size() - offset);
+    rest = rest.substr(0, rest.find('\n'));
+    if (!rest.empty() && rest.back() == '\r') {
+        rest.remove_suffix(1);
+    }
+    return rest;
+}
+
+int32_t QueryEngine::TypeDefIndexAt(uint32_t dumpOffset) const {
+    constexpr std::string_view kMarker = "// TypeDefIndex: ";
+    const std::string_view line = DumpLine(dumpOffset);
+    const size_t at = line.find(kMarker);
+    if (at == std::string_view::npos) {
+        return -1;
+    }
+    int64_t value = 0;
+    size_t digits = 0;
+    for (size_t i = at + kMarker.size(); i < line.size() && std::isdigit(static_cast<unsigned char>(line[i])) != 0;
+         ++i, ++digits) {
+        value = value * 10 + (line[i] - '0');
+        if (value > std::numeric_limits<int32_t>::max()) {
+            return -1;
+        }
+    }
+    return digits > 0 ? static_cast<int32_t>(value) : -1;
+}
+
+QueryWorkerPool::QueryWorkerPool(unsigned workerCount) {
+    for (unsigned i = 1; i < workerCount; ++i) {
+        threads_.emplace_back([this]() { WorkerLoop(); });
+    }
+}
+
+QueryWorkerPool::~QueryWorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+}
+
+void QueryWorkerPool::ForEach(size_t count, const std::function<void(size_t)>& task) {
+    if (threads_.empty() || count < kInlineBatch) {
+        for (size_t i = 0; i < count; ++i) {
+            task(i);
+        }
+        return;
+    }
+    std::lock_guard<std::mutex> batch(batchMutex_);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        task_ = &task;
+        count_ = count;
+        next_ = 0;
+        finished_ = 0;
+        ++generation_;
+    }
+    wake_.notify_all();
+    Drain();
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [&]() { return finished_ == count_; });
+    task_ = nullptr;
+}
+
+void QueryWorkerPool::WorkerLoop() {
+    uint64_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [&]() { return stopping_ || generation_ != seen; });
+            if (stopping_) {
+                return;
+            }
+            seen = generation_;
+        }
+        Drain();
+    }
+}
+
+void QueryWorkerPool::Drain() {
+    // Indices are claimed a few at a time so single queries, which take microseconds, do not contend on the lock.
+    for (;;) {
+        const std::function<void(size_t)>* task = nullptr;
+        size_t first = 0;
+        size_t last = 0;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (task_ == nullptr || next_ >= count_) {
+                return;
+            }
+            task = task_;
+            first = next_;
+            last = std::min(count_, first + std::max<size_t>(1, count_ / ((threads_.size() + 1) * 4)));
+            next_ = last;
+        }
+        for (size_t i = first; i < last; ++i) {
+            (*task)(i);
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        finished_ += last - first;
+        if (finished_ == count_) {
+            done_.notify_all();
+        }
+    }
+}
+
+void ServeQueries(const QueryEngine& engine, QueryWorkerPool& pool, const QueryChannel& channel) {
+    std::vector<std::string> requests;
+    std::vector<std::string> responses;
+    std::string line;
+    std::string out;
+    for (bool open = true; open;) {
+        requests.clear();
+        while ((open = channel.readLine(&line))) {
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+            if (line.empty()) {
+                break;
+            }
+            if (requests.size() >= kMaxBatchRequests) {
+                channel.write("error\tbatch too large\n\n");
+                return;
+            }
+            requests.push_back(line);
+        }
+        if (!open && requests.empty()) {
+            break;
+        }
+        responses.assign(requests.size(), std::string());
+        pool.ForEach(requests.size(), [&](size_t i) { engine.Answer(requests[i], &responses[i]); });
+        out.clear();
+        for (const auto& response : responses) {
+            out += response;
+        }
+        out.push_back('\n');
+        if (!channel.write(out)) {
+            break;
+        }
+    }
+}
+
+} // namespace SwitchPort
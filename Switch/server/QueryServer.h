@@ -0,0 +1,111 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "Il2CppDumper/RvaIndexLookup.h"
+#include "SwitchPort/ElfImage.h"
+#include "SwitchPort/FileBacking.h"
+#include "SwitchPort/MetadataFile.h"
+#include "SwitchPort/RuntimeTypeSystem.h"
+#include "SwitchPort/TypeIndex.h"
+
+namespace SwitchPort {
+
+// Inputs the query engine answers from. The loaded structures are owned by the caller and must stay alive, and
+// unmodified, while the engine is in use. runtimeTypes may be null, which disables field offsets.
+struct QuerySources {
+    const MetadataFile* metadata = nullptr;
+    const ElfImage* elf = nullptr;
+    const RuntimeTypeSystem* runtimeTypes = nullptr;
+    // dump.cs written by switch_il2cpp_metadata; index1.bin, index2.bin and dumpcs_type_index3.bin are read from
+    // the same directory.
+    std::string dumpPath;
+};
+
+// Answers queries over resident metadata, runtime types and the dump.cs indexes. Immutable after Open: any number
+// of threads may call Answer concurrently.
+//
+// A request is one line, a response is a status line followed by its result lines, fields separated by tabs:
+//
+//   rva <hex>                    -> ok 1: 0x<method rva>  0x<dump offset>  <type full name>  <declaration>
+//   type <full name>             -> ok n: <full name>  <namespace>  <base name>  0x<dump offset>  <TypeDefIndex>
+//   field <type full name> <name or *>
+//                                -> ok n: <type full name>  <field name>  0x<offset>|unknown  static|instance
+//   method <Type.Method>         -> ok n: 0x<rva>
+//   ping                         -> ok 0
+//
+// Failures answer "error <message>" with no result lines. Type names are written as in dump.cs ("Ns.List<T>").
+class QueryEngine {
+public:
+    bool Open(const QuerySources& sources, std::string* error);
+
+    // Appends the response to request to response; every line of it ends with a newline.
+    void Answer(std::string_view request, std::string* response) const;
+
+private:
+    void AnswerRva(std::string_view argument, std::string* response) const;
+    void AnswerType(std::string_view argument, std::string* response) const;
+    void AnswerField(std::string_view argument, std::string* response) const;
+    void AnswerMethod(std::string_view argument, std::string* response) const;
+
+    // The dump.cs line starting at offset, without its newline.
+    std::string_view DumpLine(size_t offset) const;
+    // TypeDefIndex written on the declaration line at dumpOffset, or -1.
+    int32_t TypeDefIndexAt(uint32_t dumpOffset) const;
+
+    QuerySources sources_;
+    FileBacking dump_;
+    TypeIndex types_;
+    Il2CppDumper::RvaIndexLookup rvas_;
+};
+
+// Persistent threads that answer one batch of queries at a time; the calling thread works too. Sessions on
+// several connections may share one pool, their batches then run one after the other.
+class QueryWorkerPool {
+public:
+    explicit QueryWorkerPool(unsigned workerCount);
+    ~QueryWorkerPool();
+    QueryWorkerPool(const QueryWorkerPool&) = delete;
+    QueryWorkerPool& operator=(const QueryWorkerPool&) = delete;
+
+    // Calls task(i) for every i below count and returns once all calls have finished.
+    void ForEach(size_t count, const std::function<void(size_t)>& task);
+
+private:
+    void WorkerLoop();
+    // Claims indices of the current batch until none are left.
+    void Drain();
+
+    std::mutex batchMutex_; // one batch at a time
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    const std::function<void(size_t)>* task_ = nullptr;
+    size_t count_ = 0;
+    size_t next_ = 0;
+    size_t finished_ = 0;
+    uint64_t generation_ = 0;
+    bool stopping_ = false;
+    std::vector<std::thread> threads_;
+};
+
+// Line transport for a session: ReadLine returns false at end of input; Write sends everything or returns false.
+struct QueryChannel {
+    std::function<bool(std::string* line)> readLine;
+    std::function<bool(std::string_view data)> write;
+};
+
+// Serves one session until its input ends or a write fails. Requests are read up to an empty line (or the end of
+// input), answered on the pool, and written back in request order followed by an empty line. A batch of more than
+// 4096 requests ends the session with "error<TAB>batch too large".
+void ServeQueries(const QueryEngine& engine, QueryWorkerPool& pool, const QueryChannel& channel);
+
+} // namespace SwitchPort
@@ -0,0 +1,259 @@
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "QueryServer.h"
+#include "SwitchPort/ElfImage.h"
+#include "SwitchPort/MetadataFile.h"
+#include "SwitchPort/RegistrationFinder.h"
+#include "SwitchPort/RuntimeTypeSystem.h"
+#include "SwitchPort/TaskGraph.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define SWITCHPORT_HAVE_UNIX_SOCKETS 1
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <csignal>
+#include <unistd.h>
+#endif
+
+namespace {
+
+void PrintUsage() {
+    std::fprintf(stderr,
+                 "usage:\n"
+                 "  switch_il2cpp_query <il2cpp-binary> <global-metadata.dat> <dump.cs> [--workers N] [--socket PATH]\n"
+                 "\n"
+                 "Loads the inputs once and answers queries until stdin closes, or on a local socket with --socket.\n"
+                 "dump.cs and its index files must come from the same switch_il2cpp_metadata run.\n"
+                 "Requests, one per line, are answered in batches ending with an empty line:\n"
+                 "  rva <hex> | type <full name> | field <type full name> <name or *> | method <Type.Method> | ping\n");
+}
+
+bool ParseNumber(const char* text, uint64_t* out) {
+    char* end = nullptr;
+    const unsigned long long value = std::strtoull(text, &end, 0);
+    if (end == text || *end != '\0') {
+        return false;
+    }
+    *out = value;
+    return true;
+}
+
+void ServeStdio(const SwitchPort::QueryEngine& engine, SwitchPort::QueryWorkerPool& pool) {
+    std::ios::sync_with_stdio(false);
+    SwitchPort::QueryChannel channel;
+    channel.readLine = [](std::string* line) { return static_cast<bool>(std::getline(std::cin, *line)); };
+    channel.write = [](std::string_view data) {
+        std::cout.write(data.data(), static_cast<std::streamsize>(data.size()));
+        std::cout.flush();
+        return static_cast<bool>(std::cout);
+    };
+    SwitchPort::ServeQueries(engine, pool, channel);
+}
+
+#ifdef SWITCHPORT_HAVE_UNIX_SOCKETS
+// Limits that keep one client from exhausting the server: sessions beyond the cap are refused, and a session whose
+// request line grows past the cap without a newline is closed.
+constexpr unsigned kMaxSessions = 32;
+constexpr size_t kMaxRequestLineBytes = 64u * 1024u;
+
+std::atomic<unsigned> gActiveSessions{0};
+
+bool SendAll(int fd, std::string_view data) {
+    while (!data.empty()) {
+        const ssize_t sent = ::send(fd, data.data(), data.size(), 0);
+        if (sent <= 0) {
+            return false;
+        }
+        data.remove_prefix(static_cast<size_t>(sent));
+    }
+    return true;
+}
+
+// One session per connection; every session shares the engine and the pool.
+void ServeConnection(const SwitchPort::QueryEngine& engine, SwitchPort::QueryWorkerPool& pool, int fd) {
+    std::string pending;
+    bool lineTooLong = false;
+    char buffer[16 * 1024];
+    SwitchPort::QueryChannel channel;
+    channel.readLine = [&](std::string* line) {
+        for (;;) {
+            const size_t newline = pending.find('\n');
+            if (newline != std::string::npos) {
+                line->assign(pending, 0, newline);
+                pending.erase(0, newline + 1);
+                return true;
+            }
+            if (pending.size() > kMaxRequestLineBytes) {
+                lineTooLong = true;
+                return false;
+            }
+            const ssize_t got = ::recv(fd, buffer, sizeof(buffer), 0);
+            if (got <= 0) {
+                // A last request without a newline still counts.
+                line->swap(pending);
+                pending.clear();
+                return !line->empty();
+            }
+            pending.append(buffer, static_cast<size_t>(got));
+        }
+    };
+    channel.write = [fd](std::string_view data) { return SendAll(fd, data); };
+    SwitchPort::ServeQueries(engine, pool, channel);
+    if (lineTooLong) {
+        SendAll(fd, "error\trequest line too long\n\n");
+    }
+    ::close(fd);
+    gActiveSessions.fetch_sub(1, std::memory_order_relaxed);
+}
+
+int ServeSocket(const SwitchPort::QueryEngine& engine, SwitchPort::QueryWorkerPool& pool, const std::string& path) {
+    sockaddr_un address{};
+    if (path.size() >= sizeof(address.sun_path)) {
+        std::fprintf(stderr, "socket path too long: %s\n", path.c_str());
+        return 1;
+    }
+    // A client that disconnects mid-response must end its session, not the server.
+    std::signal(SIGPIPE, SIG_IGN);
+    const int listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0) {
+        std::perror("socket");
+        return 1;
+    }
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    // Only a stale socket from an earlier run is replaced; any other file at the path is left alone.
+    struct stat existing {};
+    if (::lstat(path.c_str(), &existing) == 0) {
+        if (!S_ISSOCK(existing.st_mode)) {
+            std::fprintf(stderr, "not a socket, refusing to replace: %s\n", path.c_str());
+            ::close(listener);
+            return 1;
+        }
+        ::unlink(path.c_str());
+    }
+    if (::bind(listener, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        std::perror("bind");
+        ::close(listener);
+        return 1;
+    }
+    if (::listen(listener, 16) != 0) {
+        std::perror("listen");
+        ::close(listener);
+        return 1;
+    }
+    std::fprintf(stderr, "listening on %s\n", path.c_str());
+    for (;;) {
+        const int fd = ::accept(listener, nullptr, nullptr);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            std::perror("accept");
+            // Out of descriptors or buffers: sessions ending will free some, so wait instead of spinning.
+            if (errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                continue;
+            }
+            ::close(listener);
+            return 1;
+        }
+        if (gActiveSessions.load(std::memory_order_relaxed) >= kMaxSessions) {
+            SendAll(fd, "error\ttoo many sessions\n\n");
+            ::close(fd);
+            continue;
+        }
+        gActiveSessions.fetch_add(1, std::memory_order_relaxed);
+        std::thread(ServeConnection, std::cref(engine), std::ref(pool), fd).detach();
+    }
+}
+#endif
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 4) {
+        PrintUsage();
+        return 2;
+    }
+    const std::string elfPath = argv[1];
+    const std::string metadataPath = argv[2];
+    const std::string dumpPath = argv[3];
+    unsigned workers = SwitchPort::DefaultTaskWorkerCount();
+    std::string socketPath;
+    for (int i = 4; i < argc; i += 2) {
+        const std::string flag = argv[i];
+        uint64_t value = 0;
+        if (i + 1 >= argc) {
+            PrintUsage();
+            return 2;
+        }
+        if (flag == "--workers" && ParseNumber(argv[i + 1], &value) && value > 0) {
+            workers = static_cast<unsigned>(value);
+        } else if (flag == "--socket") {
+            socketPath = argv[i + 1];
+        } else {
+            PrintUsage();
+            return 2;
+        }
+    }
+#ifndef SWITCHPORT_HAVE_UNIX_SOCKETS
+    if (!socketPath.empty()) {
+        std::fprintf(stderr, "--socket is not supported on this platform\n");
+        return 2;
+    }
+#endif
+
+    // Everything below stays resident and unchanged for the life of the process.
+    SwitchPort::MetadataFile metadata;
+    SwitchPort::ElfImage elf;
+    std::unique_ptr<SwitchPort::RuntimeTypeSystem> runtimeTypes;
+    std::string error;
+    if (!metadata.Load(metadataPath, &error) || !elf.Load(elfPath, &error)) {
+        std::fprintf(stderr, "load failed: %s\n", error.c_str());
+        return 1;
+    }
+    const double version = static_cast<double>(metadata.Header().version);
+    SwitchPort::RegistrationFinder finder(elf);
+    const SwitchPort::RegistrationResult regs = finder.Find(version, static_cast<int>(metadata.Types().size()),
+                                                            static_cast<int>(metadata.Images().size()), workers);
+    if (regs.metadataRegistration != 0) {
+        runtimeTypes = std::make_unique<SwitchPort::RuntimeTypeSystem>();
+        if (!runtimeTypes->Load(elf, regs.metadataRegistration, version, &error)) {
+            std::fprintf(stderr, "runtime types unavailable, field queries disabled: %s\n", error.c_str());
+            runtimeTypes.reset();
+        }
+    } else {
+        std::fprintf(stderr, "MetadataRegistration not found, field queries disabled\n");
+    }
+
+    SwitchPort::QuerySources sources;
+    sources.metadata = &metadata;
+    sources.elf = &elf;
+    sources.runtimeTypes = runtimeTypes.get();
+    sources.dumpPath = dumpPath;
+    SwitchPort::QueryEngine engine;
+    if (!engine.Open(sources, &error)) {
+        std::fprintf(stderr, "failed to open indexes: %s\n", error.c_str());
+        return 1;
+    }
+    SwitchPort::QueryWorkerPool pool(workers);
+    std::fprintf(stderr, "ready: %zu types, %u workers\n", metadata.Types().size(), workers);
+
+#ifdef SWITCHPORT_HAVE_UNIX_SOCKETS
+    if (!socketPath.empty()) {
+        return ServeSocket(engine, pool, socketPath);
+    }
+#endif
+    ServeStdio(engine, pool);
+    return 0;
+}
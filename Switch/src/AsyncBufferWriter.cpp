@@ -0,0 +1,72 @@
+#include "SwitchPort/AsyncBufferWriter.h"
+
+#include <string_view>
+#include <utility>
+
+namespace SwitchPort {
+
+AsyncBufferWriter::AsyncBufferWriter(std::ostream& out) : out_(out) {
+    thread_ = std::thread([this]() { Run(); });
+}
+
+AsyncBufferWriter::~AsyncBufferWriter() {
+    Finish();
+}
+
+void AsyncBufferWriter::Submit(TextBuffer& buffer) {
+    if (buffer.Empty()) {
+        return;
+    }
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        drained_.wait(lock, [&] { return pending_.size() < kMaxPending; });
+        pending_.emplace_back();
+        pending_.back().Swap(buffer);
+        if (!spare_.empty()) {
+            buffer.Swap(spare_.back());
+            spare_.pop_back();
+        }
+    }
+    queued_.notify_one();
+}
+
+bool AsyncBufferWriter::Finish() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    queued_.notify_one();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    return !failed_;
+}
+
+void AsyncBufferWriter::Run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        queued_.wait(lock, [&] { return stop_ || !pending_.empty(); });
+        if (pending_.empty()) {
+            return;
+        }
+        TextBuffer buffer;
+        buffer.Swap(pending_.front());
+        pending_.pop_front();
+        lock.unlock();
+        drained_.notify_one();
+
+        const std::string_view text = buffer.View();
+        if (!failed_) {
+            out_.write(text.data(), static_cast<std::streamsize>(text.size()));
+            failed_ = !out_;
+        }
+        buffer.Clear();
+
+        lock.lock();
+        if (spare_.size() < kMaxPending) {
+            spare_.push_back(std::move(buffer));
+        }
+    }
+}
+
+} // namespace SwitchPort
@@ -0,0 +1,40 @@
+#include "SwitchPort/Cancellation.h"
+
+#include <chrono>
+
+#ifdef __SWITCH__
+#include <switch.h>
+#endif
+
+namespace SwitchPort {
+
+namespace {
+
+#ifdef __SWITCH__
+constexpr std::chrono::milliseconds kInputPollInterval(50);
+#endif
+
+} // namespace
+
+CancelInputPoller::CancelInputPoller() {
+#ifdef __SWITCH__
+    thread_ = std::thread([this]() {
+        while (!stop_.load(std::memory_order_relaxed)) {
+            hidScanInput();
+            if ((hidKeysDown(CONTROLLER_P1_AUTO) & KEY_MINUS) != 0) {
+                Cancellation::Request();
+            }
+            std::this_thread::sleep_for(kInputPollInterval);
+        }
+    });
+#endif
+}
+
+CancelInputPoller::~CancelInputPoller() {
+    stop_.store(true, std::memory_order_relaxed);
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+} // namespace SwitchPort
@@ -0,0 +1,254 @@
+#include "SwitchPort/DefinitionCache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <numeric>
+
+namespace SwitchPort {
+
+namespace {
+
+constexpr char kMagic[4] = {'D', 'E', 'F', '1'};
+constexpr size_t kHeaderSize = 32;
+constexpr size_t kEntrySize = 24;
+constexpr uint32_t kMaxBucketBits = 24;
+constexpr uint64_t kMaxCacheBytes = 1ull << 32;
+
+void SetError(std::string* error, const std::string& message) {
+    if (error != nullptr) {
+        *error = message;
+    }
+}
+
+uint32_t ReadLe32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) | (static_cast<uint32_t>(p[2]) << 16) |
+           (static_cast<uint32_t>(p[3]) << 24);
+}
+
+uint64_t ReadLe64(const uint8_t* p) {
+    return static_cast<uint64_t>(ReadLe32(p)) | (static_cast<uint64_t>(ReadLe32(p + 4)) << 32);
+}
+
+void AppendLe16(std::vector<uint8_t>* out, uint16_t value) {
+    out->push_back(static_cast<uint8_t>(value));
+    out->push_back(static_cast<uint8_t>(value >> 8));
+}
+
+void AppendLe32(std::vector<uint8_t>* out, uint32_t value) {
+    for (int shift = 0; shift < 32; shift += 8) {
+        out->push_back(static_cast<uint8_t>(value >> shift));
+    }
+}
+
+void AppendLe64(std::vector<uint8_t>* out, uint64_t value) {
+    AppendLe32(out, static_cast<uint32_t>(value));
+    AppendLe32(out, static_cast<uint32_t>(value >> 32));
+}
+
+uint32_t BucketOf(uint64_t hash, uint32_t bucketBits) {
+    return bucketBits == 0 ? 0 : static_cast<uint32_t>(hash >> (64 - bucketBits));
+}
+
+// Smallest table with at least one bucket per name, so buckets hold about one entry on average.
+uint32_t BucketBitsFor(size_t nameCount) {
+    uint32_t bits = 0;
+    while (bits < kMaxBucketBits && (size_t{1} << bits) < nameCount) {
+        ++bits;
+    }
+    return bits;
+}
+
+} // namespace
+
+uint32_t DefinitionCache::Offsets::operator[](size_t index) const {
+    return ReadLe32(data_ + index * 4);
+}
+
+uint64_t DefinitionCache::HashName(std::string_view name) {
+    // FNV-1a; the top bits pick the bucket, so finish with a mix that spreads them.
+    uint64_t hash = 1469598103934665603ull;
+    for (const char c : name) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 1099511628211ull;
+    }
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdull;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+void DefinitionCache::Reset() {
+    file_.Reset();
+    dumpSize_ = 0;
+    dumpMtime_ = 0;
+    bucketBits_ = 0;
+    nameCount_ = 0;
+    offsetCount_ = 0;
+    buckets_ = nullptr;
+    entries_ = nullptr;
+    offsets_ = nullptr;
+    strings_ = nullptr;
+    stringBytes_ = 0;
+}
+
+bool DefinitionCache::Open(const std::string& path, std::string* error) {
+    Reset();
+    if (!file_.Open(path, kMaxCacheBytes, "definition cache", error)) {
+        return false;
+    }
+    const uint8_t* data = file_.data();
+    const uint64_t size = file_.size();
+    if (size < kHeaderSize || std::memcmp(data, kMagic, sizeof(kMagic)) != 0) {
+        Reset();
+        SetError(error, "definition cache magic mismatch (expected DEF1): " + path);
+        return false;
+    }
+    const uint16_t version = static_cast<uint16_t>(data[4] | (data[5] << 8));
+    if (version != kVersion) {
+        Reset();
+        SetError(error, "Unsupported definition cache version: " + std::to_string(version));
+        return false;
+    }
+    dumpSize_ = ReadLe32(data + 8);
+    dumpMtime_ = ReadLe32(data + 12);
+    bucketBits_ = ReadLe32(data + 16);
+    nameCount_ = ReadLe32(data + 20);
+    offsetCount_ = ReadLe32(data + 24);
+    stringBytes_ = ReadLe32(data + 28);
+    if (bucketBits_ > kMaxBucketBits) {
+        Reset();
+        SetError(error, "definition cache bucket table is too large");
+        return false;
+    }
+
+    const uint64_t bucketsAt = kHeaderSize;
+    const uint64_t entriesAt = bucketsAt + ((uint64_t{1} << bucketBits_) + 1) * 4;
+    const uint64_t offsetsAt = entriesAt + static_cast<uint64_t>(nameCount_) * kEntrySize;
+    const uint64_t stringsAt = offsetsAt + static_cast<uint64_t>(offsetCount_) * 4;
+    if (stringsAt + stringBytes_ > size) {
+        Reset();
+        SetError(error, "definition cache is truncated: " + path);
+        return false;
+    }
+    buckets_ = data + bucketsAt;
+    entries_ = data + entriesAt;
+    offsets_ = data + offsetsAt;
+    strings_ = data + stringsAt;
+    return true;
+}
+
+DefinitionCache::Offsets DefinitionCache::Find(std::string_view name) const {
+    if (entries_ == nullptr) {
+        return {};
+    }
+    const uint64_t hash = HashName(name);
+    const uint32_t bucket = BucketOf(hash, bucketBits_);
+    const uint32_t first = ReadLe32(buckets_ + static_cast<size_t>(bucket) * 4);
+    const uint32_t last = std::min(ReadLe32(buckets_ + (static_cast<size_t>(bucket) + 1) * 4), nameCount_);
+    for (uint32_t i = first; i < last; ++i) {
+        const uint8_t* entry = entries_ + static_cast<size_t>(i) * kEntrySize;
+        const uint64_t entryHash = ReadLe64(entry);
+        if (entryHash > hash) {
+            break;
+        }
+        if (entryHash != hash) {
+            continue;
+        }
+        const uint32_t nameOffset = ReadLe32(entry + 8);
+        const uint32_t nameLength = ReadLe32(entry + 12);
+        if (static_cast<uint64_t>(nameOffset) + nameLength > stringBytes_ || nameLength != name.size() ||
+            std::memcmp(strings_ + nameOffset, name.data(), name.size()) != 0) {
+            continue;
+        }
+        const uint32_t firstOffset = ReadLe32(entry + 16);
+        const uint32_t count = ReadLe32(entry + 20);
+        if (static_cast<uint64_t>(firstOffset) + count > offsetCount_) {
+            return {};
+        }
+        return Offsets(offsets_ + static_cast<size_t>(firstOffset) * 4, count);
+    }
+    return {};
+}
+
+bool WriteDefinitionCache(const std::string& path, const std::vector<std::pair<std::string_view, uint64_t>>& definitions,
+                          uint64_t dumpSize, uint64_t dumpMtime, std::string* error) {
+    struct NameRun {
+        uint64_t hash = 0;
+        size_t first = 0; // into definitions
+        size_t count = 0;
+    };
+    // definitions is grouped by name, so each name is one run of consecutive pairs.
+    std::vector<NameRun> names;
+    for (size_t i = 0; i < definitions.size();) {
+        size_t end = i + 1;
+        while (end < definitions.size() && definitions[end].first == definitions[i].first) {
+            ++end;
+        }
+        names.push_back({DefinitionCache::HashName(definitions[i].first), i, end - i});
+        i = end;
+    }
+    // Runs are in name order already; a stable sort leaves equal hashes ordered by name.
+    std::stable_sort(names.begin(), names.end(), [](const NameRun& a, const NameRun& b) { return a.hash < b.hash; });
+
+    const uint32_t bucketBits = BucketBitsFor(names.size());
+    const size_t bucketCount = size_t{1} << bucketBits;
+
+    std::vector<uint8_t> entries;
+    std::vector<uint8_t> offsets;
+    std::vector<uint8_t> strings;
+    std::vector<uint32_t> bucketStarts(bucketCount + 1, 0);
+    entries.reserve(names.size() * kEntrySize);
+    offsets.reserve(definitions.size() * 4);
+    uint32_t offsetCount = 0;
+    for (const NameRun& run : names) {
+        const std::string_view name = definitions[run.first].first;
+        const uint32_t firstOffset = offsetCount;
+        for (size_t i = run.first; i < run.first + run.count; ++i) {
+            if (definitions[i].second <= std::numeric_limits<uint32_t>::max()) {
+                AppendLe32(&offsets, static_cast<uint32_t>(definitions[i].second));
+                ++offsetCount;
+            }
+        }
+        AppendLe64(&entries, run.hash);
+        AppendLe32(&entries, static_cast<uint32_t>(strings.size()));
+        AppendLe32(&entries, static_cast<uint32_t>(name.size()));
+        AppendLe32(&entries, firstOffset);
+        AppendLe32(&entries, offsetCount - firstOffset);
+        strings.insert(strings.end(), name.begin(), name.end());
+        ++bucketStarts[BucketOf(run.hash, bucketBits) + 1];
+    }
+    std::partial_sum(bucketStarts.begin(), bucketStarts.end(), bucketStarts.begin());
+
+    std::vector<uint8_t> header;
+    header.reserve(kHeaderSize + bucketStarts.size() * 4);
+    header.insert(header.end(), kMagic, kMagic + sizeof(kMagic));
+    AppendLe16(&header, DefinitionCache::kVersion);
+    AppendLe16(&header, 0);
+    AppendLe32(&header, static_cast<uint32_t>(std::min<uint64_t>(dumpSize, std::numeric_limits<uint32_t>::max())));
+    AppendLe32(&header, static_cast<uint32_t>(std::min<uint64_t>(dumpMtime, std::numeric_limits<uint32_t>::max())));
+    AppendLe32(&header, bucketBits);
+    AppendLe32(&header, static_cast<uint32_t>(names.size()));
+    AppendLe32(&header, offsetCount);
+    AppendLe32(&header, static_cast<uint32_t>(strings.size()));
+    for (const uint32_t start : bucketStarts) {
+        AppendLe32(&header, start);
+    }
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        SetError(error, "Failed to write " + path);
+        return false;
+    }
+    for (const auto* section : {&header, &entries, &offsets, &strings}) {
+        out.write(reinterpret_cast<const char*>(section->data()), static_cast<std::streamsize>(section->size()));
+    }
+    if (!out) {
+        SetError(error, "Failed to write " + path);
+        return false;
+    }
+    return true;
+}
+
+} // namespace SwitchPort
@@ -0,0 +1,3191 @@
+#include "SwitchPort/DumpWriter.h"
+
+#include <algorithm>
+#include <cctype>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <sys/stat.h>
+
+#include "SwitchPort/AsyncBufferWriter.h"
+#include "SwitchPort/Cancellation.h"
+#include "SwitchPort/DefinitionCache.h"
+#include "SwitchPort/MonotonicArena.h"
+#include "SwitchPort/Profiler.h"
+#include "SwitchPort/TextBuffer.h"
+#include "SwitchPort/TypeIndex.h"
+
+namespace SwitchPort {
+
+namespace {
+namespace fs = std::filesystem;
+
+constexpr uint32_t kTypeVisibilityMask = 0x00000007u;
+constexpr uint32_t kTypeNotPublic = 0x00000000u;
+constexpr uint32_t kTypePublic = 0x00000001u;
+constexpr uint32_t kTypeNestedPublic = 0x00000002u;
+constexpr uint32_t kTypeNestedPrivate = 0x00000003u;
+constexpr uint32_t kTypeNestedFamily = 0x00000004u;
+constexpr uint32_t kTypeNestedAssembly = 0x00000005u;
+constexpr uint32_t kTypeNestedFamAndAssem = 0x00000006u;
+constexpr uint32_t kTypeNestedFamOrAssem = 0x00000007u;
+constexpr uint32_t kTypeInterface = 0x00000020u;
+constexpr uint32_t kTypeAbstract = 0x00000080u;
+constexpr uint32_t kTypeSealed = 0x00000100u;
+constexpr uint32_t kTypeSerializable = 0x00002000u;
+
+constexpr uint16_t kMethodMemberAccessMask = 0x0007u;
+constexpr uint16_t kMethodPrivate = 0x0001u;
+constexpr uint16_t kMethodFamAndAssem = 0x0002u;
+constexpr uint16_t kMethodAssembly = 0x0003u;
+constexpr uint16_t kMethodFamily = 0x0004u;
+constexpr uint16_t kMethodFamOrAssem = 0x0005u;
+constexpr uint16_t kMethodPublic = 0x0006u;
+constexpr uint16_t kMethodStatic = 0x0010u;
+constexpr uint16_t kMethodFinal = 0x0020u;
+constexpr uint16_t kMethodVirtual = 0x0040u;
+constexpr uint16_t kMethodVtableLayoutMask = 0x0100u;
+constexpr uint16_t kMethodReuseSlot = 0x0000u;
+constexpr uint16_t kMethodNewSlot = 0x0100u;
+constexpr uint16_t kMethodAbstract = 0x0400u;
+constexpr uint16_t kMethodPInvokeImpl = 0x2000u;
+
+constexpr uint16_t kParamAttributeIn = 0x0001u;
+constexpr uint16_t kParamAttributeOut = 0x0002u;
+
+constexpr uint16_t kFieldAccessMask = 0x0007u;
+constexpr uint16_t kFieldPrivate = 0x0001u;
+constexpr uint16_t kFieldFamAndAssem = 0x0002u;
+constexpr uint16_t kFieldAssembly = 0x0003u;
+constexpr uint16_t kFieldFamily = 0x0004u;
+constexpr uint16_t kFieldFamOrAssem = 0x0005u;
+constexpr uint16_t kFieldPublic = 0x0006u;
+constexpr uint16_t kFieldStatic = 0x0010u;
+constexpr uint16_t kFieldInitOnly = 0x0020u;
+constexpr uint16_t kFieldLiteral = 0x0040u;
+
+constexpr uint8_t kIl2CppTypeVoid = 0x01;
+constexpr uint8_t kIl2CppTypeBoolean = 0x02;
+constexpr uint8_t kIl2CppTypeChar = 0x03;
+constexpr uint8_t kIl2CppTypeI1 = 0x04;
+constexpr uint8_t kIl2CppTypeU1 = 0x05;
+constexpr uint8_t kIl2CppTypeI2 = 0x06;
+constexpr uint8_t kIl2CppTypeU2 = 0x07;
+constexpr uint8_t kIl2CppTypeI4 = 0x08;
+constexpr uint8_t kIl2CppTypeU4 = 0x09;
+constexpr uint8_t kIl2CppTypeI8 = 0x0a;
+constexpr uint8_t kIl2CppTypeU8 = 0x0b;
+constexpr uint8_t kIl2CppTypeR4 = 0x0c;
+constexpr uint8_t kIl2CppTypeR8 = 0x0d;
+constexpr uint8_t kIl2CppTypeString = 0x0e;
+constexpr uint8_t kIl2CppTypePtr = 0x0f;
+constexpr uint8_t kIl2CppTypeValueType = 0x11;
+constexpr uint8_t kIl2CppTypeClass = 0x12;
+constexpr uint8_t kIl2CppTypeVar = 0x13;
+constexpr uint8_t kIl2CppTypeArray = 0x14;
+constexpr uint8_t kIl2CppTypeGenericInst = 0x15;
+constexpr uint8_t kIl2CppTypeTypedByRef = 0x16;
+constexpr uint8_t kIl2CppTypeI = 0x18;
+constexpr uint8_t kIl2CppTypeU = 0x19;
+constexpr uint8_t kIl2CppTypeObject = 0x1c;
+constexpr uint8_t kIl2CppTypeSzArray = 0x1d;
+constexpr uint8_t kIl2CppTypeMVar = 0x1e;
+constexpr uint8_t kIl2CppTypeEnumSentinel = 0x55;
+constexpr uint8_t kIl2CppTypeIl2CppTypeIndex = 0xff;
+
+std::string_view TypeKeyword(const SwitchPort::TypeDefinition& type) {
+    if ((type.flags & kTypeInterface) != 0) {
+        return "interface";
+    }
+    if (type.IsEnum()) {
+        return "enum";
+    }
+    if (type.IsValueType()) {
+        return "struct";
+    }
+    return "class";
+}
+
+std::string_view TypeVisibility(uint32_t flags) {
+    switch (flags & kTypeVisibilityMask) {
+        case kTypePublic:
+        case kTypeNestedPublic:
+            return "public";
+        case kTypeNestedPrivate:
+            return "private";
+        case kTypeNestedFamily:
+            return "protected";
+        case kTypeNestedFamOrAssem:
+            return "protected internal";
+        case kTypeNestedAssembly:
+        case kTypeNestedFamAndAssem:
+        case kTypeNotPublic:
+        default:
+            return "internal";
+    }
+}
+
+std::string_view TypeModifiers(const SwitchPort::TypeDefinition& type) {
+    if ((type.flags & kTypeInterface) != 0) {
+        return "";
+    }
+    if ((type.flags & kTypeAbstract) != 0 && (type.flags & kTypeSealed) != 0) {
+        return " static";
+    }
+    if ((type.flags & kTypeAbstract) != 0 && !type.IsEnum() && !type.IsValueType()) {
+        return " abstract";
+    }
+    if ((type.flags & kTypeSealed) != 0 && !type.IsEnum() && !type.IsValueType()) {
+        return " sealed";
+    }
+    return "";
+}
+
+std::string BuildMethodModifiers(uint16_t flags) {
+    std::string out;
+    switch (flags & kMethodMemberAccessMask) {
+        case kMethodPublic:
+            out = "public";
+            break;
+        case kMethodPrivate:
+            out = "private";
+            break;
+        case kMethodFamily:
+            out = "protected";
+            break;
+        case kMethodFamOrAssem:
+            out = "protected internal";
+            break;
+        case kMethodAssembly:
+        case kMethodFamAndAssem:
+        default:
+            out = "internal";
+            break;
+    }
+    if ((flags & kMethodStatic) != 0) {
+        out += " static";
+    }
+    if ((flags & kMethodAbstract) != 0) {
+        out += " abstract";
+        if ((flags & kMethodVtableLayoutMask) == kMethodReuseSlot) {
+            out += " override";
+        }
+    } else if ((flags & kMethodFinal) != 0) {
+        if ((flags & kMethodVtableLayoutMask) == kMethodReuseSlot) {
+            out += " sealed override";
+        }
+    } else if ((flags & kMethodVirtual) != 0) {
+        if ((flags & kMethodVtableLayoutMask) == kMethodNewSlot) {
+            out += " virtual";
+        } else {
+            out += " override";
+        }
+    }
+    if ((flags & kMethodPInvokeImpl) != 0) {
+        out += " extern";
+    }
+    return out;
+}
+
+std::string PseudoTypeName(int32_t typeIndex) {
+    return "Il2CppType_" + std::to_string(typeIndex);
+}
+
+std::string BuildFieldModifiers(uint16_t attrs) {
+    std::string out;
+    switch (attrs & kFieldAccessMask) {
+        case kFieldPublic:
+            out = "public";
+            break;
+        case kFieldPrivate:
+            out = "private";
+            break;
+        case kFieldFamily:
+            out = "protected";
+            break;
+        case kFieldFamOrAssem:
+            out = "protected internal";
+            break;
+        case kFieldAssembly:
+        case kFieldFamAndAssem:
+        default:
+            out = "internal";
+            break;
+    }
+    if ((attrs & kFieldLiteral) != 0) {
+        out += " const";
+    } else {
+        if ((attrs & kFieldStatic) != 0) {
+            out += " static";
+        }
+        if ((attrs & kFieldInitOnly) != 0) {
+            out += " readonly";
+        }
+    }
+    return out;
+}
+
+// Modifier strings only depend on a few flag bits. Every combination is rendered once, packed into a small key,
+// and MethodModifiers/FieldModifiers return views into that table.
+constexpr size_t kMethodModifierKeys = 512;
+constexpr size_t kFieldModifierKeys = 64;
+
+// access(0-2) | static, final, virtual(4-6) | new slot(8) | abstract(10) | pinvoke(13) -> 9 bits.
+size_t MethodModifierKey(uint16_t flags) {
+    return (flags & 0x7u) | ((flags >> 1) & 0x38u) | ((flags >> 2) & 0x40u) | ((flags >> 3) & 0x80u) |
+           ((flags >> 5) & 0x100u);
+}
+
+uint16_t MethodFlagsFromKey(size_t key) {
+    return static_cast<uint16_t>((key & 0x7u) | ((key & 0x38u) << 1) | ((key & 0x40u) << 2) | ((key & 0x80u) << 3) |
+                                 ((key & 0x100u) << 5));
+}
+
+// access(0-2) | static, init only, literal(4-6) -> 6 bits.
+size_t FieldModifierKey(uint16_t attrs) {
+    return (attrs & 0x7u) | ((attrs >> 1) & 0x38u);
+}
+
+std::string_view MethodModifiers(uint16_t flags) {
+    static const std::vector<std::string> table = [] {
+        std::vector<std::string> modifiers(kMethodModifierKeys);
+        for (size_t key = 0; key < kMethodModifierKeys; ++key) {
+            modifiers[key] = BuildMethodModifiers(MethodFlagsFromKey(key));
+        }
+        return modifiers;
+    }();
+    return table[MethodModifierKey(flags)];
+}
+
+std::string_view FieldModifiers(uint16_t attrs) {
+    static const std::vector<std::string> table = [] {
+        std::vector<std::string> modifiers(kFieldModifierKeys);
+        for (size_t key = 0; key < kFieldModifierKeys; ++key) {
+            const uint16_t attrsForKey = static_cast<uint16_t>((key & 0x7u) | ((key & 0x38u) << 1));
+            modifiers[key] = BuildFieldModifiers(attrsForKey);
+        }
+        return modifiers;
+    }();
+    return table[FieldModifierKey(attrs)];
+}
+
+// Declaring type of every nested type definition, indexed by type definition.
+class NestedParentTable {
+public:
+    explicit NestedParentTable(size_t typeCount) : parents_(typeCount, kNoParent) {}
+
+    void Set(size_t child, size_t parent) {
+        if (child < parents_.size()) {
+            parents_[child] = parent;
+        }
+    }
+    bool Find(size_t child, size_t* parent) const {
+        if (child >= parents_.size() || parents_[child] == kNoParent) {
+            return false;
+        }
+        *parent = parents_[child];
+        return true;
+    }
+
+private:
+    static constexpr size_t kNoParent = static_cast<size_t>(-1);
+    std::vector<size_t> parents_;
+};
+
+// Names built by BuildTypeDefName, indexed by type definition. The names live in the cache's arena, so views of
+// stored names stay valid while further names are added and are all released with the cache.
+class TypeNameCache {
+public:
+    explicit TypeNameCache(size_t typeCount) : names_(typeCount) {}
+
+    // Stored names are never empty, so an empty view means the name has not been built yet.
+    std::string_view Find(size_t typeIndex) const {
+        if (typeIndex < names_.size()) {
+            return names_[typeIndex];
+        }
+        const auto it = outOfRange_.find(typeIndex);
+        return (it != outOfRange_.end()) ? it->second : std::string_view();
+    }
+    std::string_view Store(size_t typeIndex, std::string_view name) {
+        const std::string_view stored = arena_.Copy(name);
+        if (typeIndex < names_.size()) {
+            names_[typeIndex] = stored;
+        } else {
+            // Indexes past the type table only come from malformed metadata.
+            outOfRange_[typeIndex] = stored;
+        }
+        return stored;
+    }
+
+private:
+    SwitchPort::MonotonicArena arena_;
+    std::vector<std::string_view> names_;
+    std::unordered_map<size_t, std::string_view> outOfRange_;
+};
+
+std::string StripGenericArity(std::string_view name);
+
+// Returns a view into cache, valid for the cache's lifetime.
+std::string_view BuildTypeDefName(const SwitchPort::MetadataFile& metadata, size_t typeIndex,
+                                  const NestedParentTable& nestedParents,
+                                  TypeNameCache& cache) {
+    if (const std::string_view found = cache.Find(typeIndex); !found.empty()) {
+        SwitchPort::Profiler::Count(SwitchPort::ProfileCounter::TypeNameCacheHits);
+        return found;
+    }
+    SwitchPort::Profiler::Count(SwitchPort::ProfileCounter::TypeNameCacheMisses);
+
+    const auto& types = metadata.Types();
+    if (typeIndex >= types.size()) {
+        return cache.Store(typeIndex, "Type_" + std::to_string(typeIndex));
+    }
+
+    const auto& type = types[typeIndex];
+    std::string name = StripGenericArity(metadata.GetStringView(type.nameIndex));
+    if (name.empty()) {
+        name = "Type_" + std::to_string(typeIndex);
+    }
+    size_t parentIndex = 0;
+    if (nestedParents.Find(typeIndex, &parentIndex)) {
+        name = std::string(BuildTypeDefName(metadata, parentIndex, nestedParents, cache)) + "." + name;
+    }
+    if (type.genericContainerIndex >= 0 && static_cast<size_t>(type.genericContainerIndex) < metadata.GenericContainers().size()) {
+        const auto& gc = metadata.GenericContainers()[static_cast<size_t>(type.genericContainerIndex)];
+        if (gc.typeArgc > 0 && gc.genericParameterStart >= 0) {
+            name += "<";
+            bool first = true;
+            for (int32_t i = 0; i < gc.typeArgc; ++i) {
+                if (!first) {
+                    name += ", ";
+                }
+                first = false;
+                const int32_t gpIndex = gc.genericParameterStart + i;
+                std::string_view gpName;
+                if (gpIndex >= 0 && static_cast<size_t>(gpIndex) < metadata.GenericParameters().size()) {
+                    const auto& gp = metadata.GenericParameters()[static_cast<size_t>(gpIndex)];
+                    gpName = metadata.GetStringView(gp.nameIndex);
+                }
+                if (!gpName.empty()) {
+                    name += gpName;
+                } else {
+                    name += "T" + std::to_string(i);
+                }
+            }
+            name += ">";
+        }
+    }
+
+    return cache.Store(typeIndex, name);
+}
+
+std::string StripGenericArity(std::string_view name) {
+    std::string out(name);
+    const size_t tick = out.find('`');
+    if (tick == std::string::npos) {
+        return out;
+    }
+    size_t end = tick + 1;
+    while (end < out.size() && out[end] >= '0' && out[end] <= '9') {
+        ++end;
+    }
+    out.erase(tick, end - tick);
+    return out;
+}
+
+std::string StripGenericParams(const std::string& name) {
+    std::string out;
+    out.reserve(name.size());
+    int depth = 0;
+    for (char c : name) {
+        if (c == '<') {
+            ++depth;
+            continue;
+        }
+        if (c == '>') {
+            if (depth > 0) {
+                --depth;
+            }
+            continue;
+        }
+        if (depth == 0) {
+            out.push_back(c);
+        }
+    }
+    return out;
+}
+
+std::string PrimitiveTypeName(uint8_t type) {
+    switch (type) {
+        case kIl2CppTypeVoid:
+            return "void";
+        case kIl2CppTypeBoolean:
+            return "bool";
+        case kIl2CppTypeChar:
+            return "char";
+        case kIl2CppTypeI1:
+            return "sbyte";
+        case kIl2CppTypeU1:
+            return "byte";
+        case kIl2CppTypeI2:
+            return "short";
+        case kIl2CppTypeU2:
+            return "ushort";
+        case kIl2CppTypeI4:
+            return "int";
+        case kIl2CppTypeU4:
+            return "uint";
+        case kIl2CppTypeI8:
+            return "long";
+        case kIl2CppTypeU8:
+            return "ulong";
+        case kIl2CppTypeR4:
+            return "float";
+        case kIl2CppTypeR8:
+            return "double";
+        case kIl2CppTypeString:
+            return "string";
+        case kIl2CppTypeTypedByRef:
+            return "TypedReference";
+        case kIl2CppTypeI:
+            return "IntPtr";
+        case kIl2CppTypeU:
+            return "UIntPtr";
+        case kIl2CppTypeObject:
+            return "object";
+        default:
+            return "";
+    }
+}
+
+std::string ResolveTypeName(const SwitchPort::MetadataFile& metadata, const SwitchPort::RuntimeTypeSystem* runtimeTypes,
+                            const SwitchPort::ElfImage* elfImage, int32_t typeIndex,
+                            const NestedParentTable& nestedParents,
+                            TypeNameCache& typeDefNameCache, int depth = 0);
+
+std::string ResolveRuntimeType(const SwitchPort::MetadataFile& metadata, const SwitchPort::RuntimeTypeSystem* runtimeTypes,
+                               const SwitchPort::ElfImage* elfImage, const SwitchPort::RuntimeType& rt,
+                               const NestedParentTable& nestedParents,
+                               TypeNameCache& typeDefNameCache, int depth = 0) {
+    if (depth > 12) {
+        return "";
+    }
+    if (const std::string primitive = PrimitiveTypeName(rt.type); !primitive.empty()) {
+        return primitive;
+    }
+    if (rt.type == kIl2CppTypeClass || rt.type == kIl2CppTypeValueType) {
+        const uint64_t klassIndex = rt.data;
+        if (klassIndex < metadata.Types().size()) {
+            return std::string(BuildTypeDefName(metadata, static_cast<size_t>(klassIndex), nestedParents, typeDefNameCache));
+        }
+    }
+    if (rt.type == kIl2CppTypeVar) {
+        if (rt.data < metadata.GenericParameters().size()) {
+            const auto& gp = metadata.GenericParameters()[static_cast<size_t>(rt.data)];
+            const std::string_view n = metadata.GetStringView(gp.nameIndex);
+            if (!n.empty()) {
+                return std::string(n);
+            }
+        }
+        return "T" + std::to_string(rt.data);
+    }
+    if (rt.type == kIl2CppTypeMVar) {
+        if (rt.data < metadata.GenericParameters().size()) {
+            const auto& gp = metadata.GenericParameters()[static_cast<size_t>(rt.data)];
+            const std::string_view n = metadata.GetStringView(gp.nameIndex);
+            if (!n.empty()) {
+                return std::string(n);
+            }
+        }
+        return "M" + std::to_string(rt.data);
+    }
+    if (rt.type == kIl2CppTypePtr || rt.type == kIl2CppTypeSzArray) {
+        const auto elemRt = runtimeTypes ? runtimeTypes->GetTypeByPointer(rt.data) : std::nullopt;
+        const std::string elemName =
+            (elemRt.has_value()) ? ResolveRuntimeType(metadata, runtimeTypes, elfImage, *elemRt, nestedParents, typeDefNameCache, depth + 1)
+                                : PseudoTypeName(-1);
+        if (rt.type == kIl2CppTypePtr) {
+            return elemName + "*";
+        }
+        return elemName + "[]";
+    }
+    if (rt.type == kIl2CppTypeArray && elfImage != nullptr) {
+        uint64_t elemTypePtr = 0;
+        uint8_t rank = 1;
+        if (elfImage->ReadU64AtVaddr(rt.data + 0, &elemTypePtr)) {
+            (void)elfImage->ReadU8AtVaddr(rt.data + 8, &rank);
+            const auto elemRt = runtimeTypes ? runtimeTypes->GetTypeByPointer(elemTypePtr) : std::nullopt;
+            std::string elemName = (elemRt.has_value())
+                                       ? ResolveRuntimeType(metadata, runtimeTypes, elfImage, *elemRt, nestedParents, typeDefNameCache,
+                                                            depth + 1)
+                                       : PseudoTypeName(-1);
+            if (rank <= 1) {
+                return elemName + "[]";
+            }
+            return elemName + "[" + std::string(static_cast<size_t>(rank - 1), ',') + "]";
+        }
+    }
+    if (rt.type == kIl2CppTypeGenericInst && elfImage != nullptr && runtimeTypes != nullptr) {
+        uint64_t genericTypePtr = 0;
+        uint64_t classInst = 0;
+        if (elfImage->ReadU64AtVaddr(rt.data + 0, &genericTypePtr) && elfImage->ReadU64AtVaddr(rt.data + 8, &classInst)) {
+            std::string baseName;
+            if (const auto baseRt = runtimeTypes->GetTypeByPointer(genericTypePtr); baseRt.has_value()) {
+                baseName = ResolveRuntimeType(metadata, runtimeTypes, elfImage, *baseRt, nestedParents, typeDefNameCache, depth + 1);
+            }
+            if (baseName.empty()) {
+                baseName = "Il2CppType_" + std::to_string(static_cast<unsigned long long>(genericTypePtr));
+            }
+            baseName = StripGenericArity(baseName);
+            baseName = StripGenericParams(baseName);
+            if (classInst != 0) {
+                uint64_t argcRaw = 0;
+                uint64_t argv = 0;
+                if (elfImage->ReadU64AtVaddr(classInst + 0, &argcRaw) && elfImage->ReadU64AtVaddr(classInst + 8, &argv) &&
+                    argcRaw > 0 && argcRaw <= 64) {
+                    std::vector<std::string> args;
+                    args.reserve(static_cast<size_t>(argcRaw));
+                    for (uint64_t ai = 0; ai < argcRaw; ++ai) {
+                        uint64_t argTypePtr = 0;
+                        if (!elfImage->ReadU64AtVaddr(argv + ai * 8, &argTypePtr)) {
+                            break;
+                        }
+                        if (const auto argRt = runtimeTypes->GetTypeByPointer(argTypePtr); argRt.has_value()) {
+                            args.push_back(ResolveRuntimeType(metadata, runtimeTypes, elfImage, *argRt, nestedParents,
+                                                              typeDefNameCache, depth + 1));
+                        } else {
+                            args.push_back("Il2CppType_" + std::to_string(static_cast<unsigned long long>(argTypePtr)));
+                        }
+                    }
+                    if (!args.empty()) {
+                        std::string rendered = baseName + "<";
+                        for (size_t i = 0; i < args.size(); ++i) {
+                            if (i != 0) {
+                                rendered += ", ";
+                            }
+                            rendered += args[i];
+                        }
+                        rendered += ">";
+                        return rendered;
+                    }
+                }
+            }
+            return baseName;
+        }
+    }
+    return "";
+}
+
+std::string ResolveTypeName(const SwitchPort::MetadataFile& metadata, const SwitchPort::RuntimeTypeSystem* runtimeTypes,
+                            const SwitchPort::ElfImage* elfImage, int32_t typeIndex,
+                            const NestedParentTable& nestedParents,
+                            TypeNameCache& typeDefNameCache, int depth) {
+    if (runtimeTypes == nullptr) {
+        return PseudoTypeName(typeIndex);
+    }
+    const auto rt = runtimeTypes->GetTypeByIndex(typeIndex);
+    if (!rt) {
+        return PseudoTypeName(typeIndex);
+    }
+    const std::string resolved = ResolveRuntimeType(metadata, runtimeTypes, elfImage, *rt, nestedParents, typeDefNameCache, depth);
+    if (!resolved.empty()) {
+        return resolved;
+    }
+    return PseudoTypeName(typeIndex);
+}
+
+std::string FormatFieldDefaultValue(const SwitchPort::MetadataFile& metadata, const SwitchPort::RuntimeTypeSystem* runtimeTypes,
+                                    const SwitchPort::FieldDefaultValue& fdv) {
+    auto readCompressedUInt32 = [&](uint32_t absOffset, uint32_t* out, uint32_t* bytesRead) -> bool {
+        uint8_t first = 0;
+        if (!metadata.ReadU8AtMetadataOffset(absOffset, &first)) {
+            return false;
+        }
+        if ((first & 0x80u) == 0) {
+            *out = first;
+            *bytesRead = 1;
+            return true;
+        }
+        if ((first & 0xC0u) == 0x80u) {
+            uint8_t b1 = 0;
+            if (!metadata.ReadU8AtMetadataOffset(absOffset + 1, &b1)) {
+                return false;
+            }
+            *out = ((first & ~0x80u) << 8) | b1;
+            *bytesRead = 2;
+            return true;
+        }
+        if ((first & 0xE0u) == 0xC0u) {
+            uint8_t b1 = 0, b2 = 0, b3 = 0;
+            if (!metadata.ReadU8AtMetadataOffset(absOffset + 1, &b1) || !metadata.ReadU8AtMetadataOffset(absOffset + 2, &b2) ||
+                !metadata.ReadU8AtMetadataOffset(absOffset + 3, &b3)) {
+                return false;
+            }
+            *out = ((first & ~0xC0u) << 24) | (static_cast<uint32_t>(b1) << 16) | (static_cast<uint32_t>(b2) << 8) |
+                   static_cast<uint32_t>(b3);
+            *bytesRead = 4;
+            return true;
+        }
+        if (first == 0xF0u) {
+            if (!metadata.ReadU32AtMetadataOffset(absOffset + 1, out)) {
+                return false;
+            }
+            *bytesRead = 5;
+            return true;
+        }
+        if (first == 0xFEu) {
+            *out = 0xFFFFFFFEu;
+            *bytesRead = 1;
+            return true;
+        }
+        if (first == 0xFFu) {
+            *out = 0xFFFFFFFFu;
+            *bytesRead = 1;
+            return true;
+        }
+        return false;
+    };
+
+    auto readCompressedInt32 = [&](uint32_t absOffset, int32_t* out, uint32_t* bytesRead) -> bool {
+        uint32_t encoded = 0;
+        if (!readCompressedUInt32(absOffset, &encoded, bytesRead)) {
+            return false;
+        }
+        if (encoded == 0xFFFFFFFFu) {
+            *out = static_cast<int32_t>(0x80000000u);
+            return true;
+        }
+        const bool isNegative = (encoded & 1u) != 0;
+        encoded >>= 1;
+        if (isNegative) {
+            *out = -static_cast<int32_t>(encoded + 1);
+        } else {
+            *out = static_cast<int32_t>(encoded);
+        }
+        return true;
+    };
+
+    const uint32_t abs = metadata.GetFieldAndParameterDefaultValueDataOffset() + static_cast<uint32_t>(fdv.dataIndex);
+    const auto rt = runtimeTypes ? runtimeTypes->GetTypeByIndex(fdv.typeIndex) : std::nullopt;
+    const uint8_t type = rt ? rt->type : 0;
+    if (type == kIl2CppTypeBoolean) {
+        uint8_t v = 0;
+        if (metadata.ReadU8AtMetadataOffset(abs, &v)) {
+            return v ? "True" : "False";
+        }
+    } else if (type == kIl2CppTypeI1) {
+        int8_t v = 0;
+        if (metadata.ReadI8AtMetadataOffset(abs, &v)) {
+            return std::to_string(static_cast<int>(v));
+        }
+    } else if (type == kIl2CppTypeU1) {
+        uint8_t v = 0;
+        if (metadata.ReadU8AtMetadataOffset(abs, &v)) {
+            return std::to_string(static_cast<unsigned int>(v));
+        }
+    } else if (type == kIl2CppTypeI2) {
+        int16_t v = 0;
+        if (metadata.ReadI16AtMetadataOffset(abs, &v)) {
+            return std::to_string(v);
+        }
+    } else if (type == kIl2CppTypeU2) {
+        uint16_t v = 0;
+        if (metadata.ReadU16AtMetadataOffset(abs, &v)) {
+            return std::to_string(v);
+        }
+    } else if (type == kIl2CppTypeI4) {
+        int32_t v = 0;
+        uint32_t bytesRead = 0;
+        if (metadata.Header().version >= 29 ? readCompressedInt32(abs, &v, &bytesRead) : metadata.ReadI32AtMetadataOffset(abs, &v)) {
+            return std::to_string(v);
+        }
+    } else if (type == kIl2CppTypeU4) {
+        uint32_t v = 0;
+        uint32_t bytesRead = 0;
+        if (metadata.Header().version >= 29 ? readCompressedUInt32(abs, &v, &bytesRead) : metadata.ReadU32AtMetadataOffset(abs, &v)) {
+            return std::to_string(v);
+        }
+    } else if (type == kIl2CppTypeI8) {
+        int64_t v = 0;
+        if (metadata.ReadI64AtMetadataOffset(abs, &v)) {
+            return std::to_string(v);
+        }
+    } else if (type == kIl2CppTypeU8) {
+        uint64_t v = 0;
+        if (metadata.ReadU64AtMetadataOffset(abs, &v)) {
+            return std::to_string(v);
+        }
+    } else if (type == kIl2CppTypeR4) {
+        float v = 0;
+        if (metadata.ReadF32AtMetadataOffset(abs, &v)) {
+            return std::to_string(v) + "f";
+        }
+    } else if (type == kIl2CppTypeR8) {
+        double v = 0;
+        if (metadata.ReadF64AtMetadataOffset(abs, &v)) {
+            return std::to_string(v);
+        }
+    } else if (type == kIl2CppTypeString) {
+        std::string s;
+        if (metadata.Header().version >= 29) {
+            int32_t length = 0;
+            uint32_t bytesRead = 0;
+            if (!readCompressedInt32(abs, &length, &bytesRead)) {
+                return "";
+            }
+            if (length < 0) {
+                return "null";
+            }
+            uint32_t dataOff = abs + bytesRead;
+            uint8_t ch = 0;
+            s.clear();
+            s.reserve(static_cast<size_t>(length));
+            for (int32_t i = 0; i < length; ++i) {
+                if (!metadata.ReadU8AtMetadataOffset(dataOff + static_cast<uint32_t>(i), &ch)) {
+                    return "";
+                }
+                s.push_back(static_cast<char>(ch));
+            }
+        } else if (metadata.ReadStringBlobAtMetadataOffset(abs, &s)) {
+        } else {
+            return "";
+        }
+        std::string escaped;
+        escaped.reserve(s.size());
+        for (char c : s) {
+            if (c == '\\' || c == '"') {
+                escaped.push_back('\\');
+            }
+            escaped.push_back(c);
+        }
+        return "\"" + escaped + "\"";
+    }
+    return "";
+}
+
+std::string FormatDefaultValue(const SwitchPort::MetadataFile& metadata, const SwitchPort::RuntimeTypeSystem* runtimeTypes, int32_t typeIndex,
+                               int32_t dataIndex) {
+    SwitchPort::FieldDefaultValue fdv{};
+    fdv.typeIndex = typeIndex;
+    fdv.dataIndex = dataIndex;
+    return FormatFieldDefaultValue(metadata, runtimeTypes, fdv);
+}
+
+bool ReadCompressedUInt32At(const SwitchPort::MetadataFile& metadata, uint32_t absOffset, uint32_t* out, uint32_t* bytesRead) {
+    uint8_t first = 0;
+    if (!metadata.ReadU8AtMetadataOffset(absOffset, &first)) {
+        return false;
+    }
+    if ((first & 0x80u) == 0) {
+        *out = first;
+        *bytesRead = 1;
+        return true;
+    }
+    if ((first & 0xC0u) == 0x80u) {
+        uint8_t b1 = 0;
+        if (!metadata.ReadU8AtMetadataOffset(absOffset + 1, &b1)) {
+            return false;
+        }
+        *out = ((first & ~0x80u) << 8) | b1;
+        *bytesRead = 2;
+        return true;
+    }
+    if ((first & 0xE0u) == 0xC0u) {
+        uint8_t b1 = 0, b2 = 0, b3 = 0;
+        if (!metadata.ReadU8AtMetadataOffset(absOffset + 1, &b1) || !metadata.ReadU8AtMetadataOffset(absOffset + 2, &b2) ||
+            !metadata.ReadU8AtMetadataOffset(absOffset + 3, &b3)) {
+            return false;
+        }
+        *out = ((first & ~0xC0u) << 24) | (static_cast<uint32_t>(b1) << 16) | (static_cast<uint32_t>(b2) << 8) |
+               static_cast<uint32_t>(b3);
+        *bytesRead = 4;
+        return true;
+    }
+    if (first == 0xF0u) {
+        if (!metadata.ReadU32AtMetadataOffset(absOffset + 1, out)) {
+            return false;
+        }
+        *bytesRead = 5;
+        return true;
+    }
+    if (first == 0xFEu) {
+        *out = 0xFFFFFFFEu;
+        *bytesRead = 1;
+        return true;
+    }
+    if (first == 0xFFu) {
+        *out = 0xFFFFFFFFu;
+        *bytesRead = 1;
+        return true;
+    }
+    return false;
+}
+
+bool ReadCompressedInt32At(const SwitchPort::MetadataFile& metadata, uint32_t absOffset, int32_t* out, uint32_t* bytesRead) {
+    uint32_t encoded = 0;
+    if (!ReadCompressedUInt32At(metadata, absOffset, &encoded, bytesRead)) {
+        return false;
+    }
+    if (encoded == 0xFFFFFFFFu) {
+        *out = static_cast<int32_t>(0x80000000u);
+        return true;
+    }
+    const bool isNegative = (encoded & 1u) != 0;
+    encoded >>= 1;
+    if (isNegative) {
+        *out = -static_cast<int32_t>(encoded + 1);
+    } else {
+        *out = static_cast<int32_t>(encoded);
+    }
+    return true;
+}
+
+std::string StripAttributeSuffix(const std::string& name) {
+    std::string out = name;
+    const std::string needle = "Attribute";
+    size_t pos = 0;
+    while ((pos = out.find(needle, pos)) != std::string::npos) {
+        out.erase(pos, needle.size());
+    }
+    return out;
+}
+
+std::string DecodeAttributeValueToString(const SwitchPort::MetadataFile& metadata, const SwitchPort::RuntimeTypeSystem* runtimeTypes,
+                                         const SwitchPort::ElfImage* elfImage,
+                                         const NestedParentTable& nestedParents,
+                                         TypeNameCache& typeDefNameCache, uint8_t valueType, uint32_t* cursor,
+                                         int depth) {
+    if (depth > 16) {
+        return "null";
+    }
+    if (valueType == kIl2CppTypeBoolean) {
+        uint8_t v = 0;
+        if (!metadata.ReadU8AtMetadataOffset(*cursor, &v)) {
+            return "null";
+        }
+        *cursor += 1;
+        return v ? "True" : "False";
+    }
+    if (valueType == kIl2CppTypeI1) {
+        int8_t v = 0;
+        if (!metadata.ReadI8AtMetadataOffset(*cursor, &v)) {
+            return "null";
+        }
+        *cursor += 1;
+        return std::to_string(static_cast<int>(v));
+    }
+    if (valueType == kIl2CppTypeU1) {
+        uint8_t v = 0;
+        if (!metadata.ReadU8AtMetadataOffset(*cursor, &v)) {
+            return "null";
+        }
+        *cursor += 1;
+        return std::to_string(static_cast<unsigned int>(v));
+    }
+    if (valueType == kIl2CppTypeI2 || valueType == kIl2CppTypeChar) {
+        int16_t v = 0;
+        if (!metadata.ReadI16AtMetadataOffset(*cursor, &v)) {
+            return "null";
+        }
+        *cursor += 2;
+        return std::to_string(v);
+    }
+    if (valueType == kIl2CppTypeU2) {
+        uint16_t v = 0;
+        if (!metadata.ReadU16AtMetadataOffset(*cursor, &v)) {
+            return "null";
+        }
+        *cursor += 2;
+        return std::to_string(v);
+    }
+    if (valueType == kIl2CppTypeI4) {
+        int32_t v = 0;
+        uint32_t br = 0;
+        if (!ReadCompressedInt32At(metadata, *cursor, &v, &br)) {
+            return "null";
+        }
+        *cursor += br;
+        return std::to_string(v);
+    }
+    if (valueType == kIl2CppTypeU4) {
+        uint32_t v = 0;
+        uint32_t br = 0;
+        if (!ReadCompressedUInt32At(metadata, *cursor, &v, &br)) {
+            return "null";
+        }
+        *cursor += br;
+        return std::to_string(v);
+    }
+    if (valueType == kIl2CppTypeI8) {
+        int64_t v = 0;
+        if (!metadata.ReadI64AtMetadataOffset(*cursor, &v)) {
+            return "null";
+        }
+        *cursor += 8;
+        return std::to_string(v);
+    }
+    if (valueType == kIl2CppTypeU8) {
+        uint64_t v = 0;
+        if (!metadata.ReadU64AtMetadataOffset(*cursor, &v)) {
+            return "null";
+        }
+        *cursor += 8;
+        return std::to_string(v);
+    }
+    if (valueType == kIl2CppTypeR4) {
+        float v = 0;
+        if (!metadata.ReadF32AtMetadataOffset(*cursor, &v)) {
+            return "null";
+        }
+        *cursor += 4;
+        return std::to_string(v) + "f";
+    }
+    if (valueType == kIl2CppTypeR8) {
+        double v = 0;
+        if (!metadata.ReadF64AtMetadataOffset(*cursor, &v)) {
+            return "null";
+        }
+        *cursor += 8;
+        return std::to_string(v);
+    }
+    if (valueType == kIl2CppTypeString) {
+        int32_t len = 0;
+        uint32_t br = 0;
+        if (!ReadCompressedInt32At(metadata, *cursor, &len, &br)) {
+            return "null";
+        }
+        *cursor += br;
+        if (len < 0) {
+            return "null";
+        }
+        std::string s;
+        s.reserve(static_cast<size_t>(len));
+        for (int32_t i = 0; i < len; ++i) {
+            uint8_t ch = 0;
+            if (!metadata.ReadU8AtMetadataOffset(*cursor + static_cast<uint32_t>(i), &ch)) {
+                return "null";
+            }
+            s.push_back(static_cast<char>(ch));
+        }
+        *cursor += static_cast<uint32_t>(len);
+        std::string escaped;
+        for (char c : s) {
+            if (c == '\\' || c == '"') {
+                escaped.push_back('\\');
+            }
+            escaped.push_back(c);
+        }
+        return "\"" + escaped + "\"";
+    }
+    if (valueType == kIl2CppTypeIl2CppTypeIndex) {
+        int32_t tIndex = -1;
+        uint32_t br = 0;
+        if (!ReadCompressedInt32At(metadata, *cursor, &tIndex, &br)) {
+            return "null";
+        }
+        *cursor += br;
+        if (tIndex < 0) {
+            return "null";
+        }
+        return "typeof(" + ResolveTypeName(metadata, runtimeTypes, elfImage, tIndex, nestedParents, typeDefNameCache) + ")";
+    }
+    if (valueType == kIl2CppTypeSzArray) {
+        int32_t arrayLen = -1;
+        uint32_t br = 0;
+        if (!ReadCompressedInt32At(metadata, *cursor, &arrayLen, &br)) {
+            return "null";
+        }
+        *cursor += br;
+        if (arrayLen < 0) {
+            return "null";
+        }
+        uint8_t elemType = 0;
+        if (!metadata.ReadU8AtMetadataOffset(*cursor, &elemType)) {
+            return "null";
+        }
+        *cursor += 1;
+        if (elemType == kIl2CppTypeEnumSentinel) {
+            int32_t enumTypeIndex = -1;
+            if (!ReadCompressedInt32At(metadata, *cursor, &enumTypeIndex, &br)) {
+                return "null";
+            }
+            *cursor += br;
+            const auto enumRt = runtimeTypes ? runtimeTypes->GetTypeByIndex(enumTypeIndex) : std::nullopt;
+            if (enumRt.has_value() && enumRt->data < metadata.Types().size()) {
+                const auto& td = metadata.Types()[static_cast<size_t>(enumRt->data)];
+                if (td.elementTypeIndex >= 0) {
+                    const auto underRt = runtimeTypes->GetTypeByIndex(td.elementTypeIndex);
+                    if (underRt.has_value()) {
+                        elemType = underRt->type;
+                    }
+                }
+            }
+        }
+        uint8_t varied = 0;
+        if (!metadata.ReadU8AtMetadataOffset(*cursor, &varied)) {
+            return "null";
+        }
+        *cursor += 1;
+        std::string out = "new[] { ";
+        for (int32_t i = 0; i < arrayLen; ++i) {
+            uint8_t current = elemType;
+            if (varied == 1) {
+                if (!metadata.ReadU8AtMetadataOffset(*cursor, &current)) {
+                    return "null";
+                }
+                *cursor += 1;
+            }
+            if (i != 0) {
+                out += ", ";
+            }
+            out += DecodeAttributeValueToString(metadata, runtimeTypes, elfImage, nestedParents, typeDefNameCache, current, cursor,
+                                                depth + 1);
+        }
+        out += " }";
+        return out;
+    }
+    return "null";
+}
+
+// Range index of every image's attribute tokens, so a member's attributes are found by binary search instead of a
+// scan over the image's ranges. Built once before rendering and read-only afterwards.
+class AttributeTokenIndex {
+public:
+    static constexpr size_t kNoRange = static_cast<size_t>(-1);
+
+    explicit AttributeTokenIndex(const SwitchPort::MetadataFile& metadata) {
+        const auto& images = metadata.Images();
+        imageStarts_.assign(images.size() + 1, 0);
+        if (metadata.Header().version < 29) {
+            return;
+        }
+        const auto& ranges = metadata.AttributeDataRanges();
+        for (size_t imageIndex = 0; imageIndex < images.size(); ++imageIndex) {
+            const auto& image = images[imageIndex];
+            const size_t first = entries_.size();
+            imageStarts_[imageIndex] = first;
+            if (image.customAttributeStart < 0 || image.customAttributeCount == 0) {
+                continue;
+            }
+            const size_t start = static_cast<size_t>(image.customAttributeStart);
+            const size_t end = start + static_cast<size_t>(image.customAttributeCount);
+            for (size_t i = start; i < end && i < ranges.size(); ++i) {
+                entries_.push_back({ranges[i].token, i});
+            }
+            // Stable, so the first range of a repeated token wins, as it did for the front-to-back scan.
+            std::stable_sort(entries_.begin() + static_cast<std::ptrdiff_t>(first), entries_.end(),
+                             [](const Entry& a, const Entry& b) { return a.token < b.token; });
+        }
+        imageStarts_[images.size()] = entries_.size();
+    }
+
+    size_t Find(size_t imageIndex, uint32_t token) const {
+        if (imageIndex + 1 >= imageStarts_.size()) {
+            return kNoRange;
+        }
+        const auto begin = entries_.begin() + static_cast<std::ptrdiff_t>(imageStarts_[imageIndex]);
+        const auto end = entries_.begin() + static_cast<std::ptrdiff_t>(imageStarts_[imageIndex + 1]);
+        const auto it =
+            std::lower_bound(begin, end, token, [](const Entry& e, uint32_t value) { return e.token < value; });
+        return (it != end && it->token == token) ? it->range : kNoRange;
+    }
+
+private:
+    struct Entry {
+        uint32_t token = 0;
+        size_t range = 0;
+    };
+    std::vector<size_t> imageStarts_; // per image, into entries_; one extra end entry
+    std::vector<Entry> entries_;
+};
+
+// Rendered attribute lines, memoized per writer. A range renders from its blob bytes alone, so members carrying
+// identical blobs (the same [CompilerGenerated] or [SerializeField] data) are decoded once, and attribute type
+// names are stripped once per declaring type.
+class AttributeCache {
+public:
+    explicit AttributeCache(size_t typeCount) : names_(typeCount), known_(typeCount, 0) {}
+
+    const std::vector<std::string_view>* FindLines(std::string_view blob) const {
+        const auto it = linesByBlob_.find(blob);
+        return (it != linesByBlob_.end()) ? &it->second : nullptr;
+    }
+    // Copies lines into the cache's arena. blob must outlive the cache; views into the metadata file do.
+    const std::vector<std::string_view>& StoreLines(std::string_view blob, const std::vector<std::string>& lines) {
+        std::vector<std::string_view> stored;
+        stored.reserve(lines.size());
+        for (const auto& line : lines) {
+            stored.push_back(arena_.Copy(line));
+        }
+        return linesByBlob_.emplace(blob, std::move(stored)).first->second;
+    }
+    // Holds lines of a range that could not be keyed, until the next call.
+    const std::vector<std::string_view>& StoreUncached(std::vector<std::string> lines) {
+        uncachedText_ = std::move(lines);
+        uncached_.assign(uncachedText_.begin(), uncachedText_.end());
+        return uncached_;
+    }
+
+    // typeIndex must be inside the type table.
+    const std::string& AttributeName(const SwitchPort::MetadataFile& metadata, size_t typeIndex) {
+        if (known_[typeIndex] == 0) {
+            known_[typeIndex] = 1;
+            names_[typeIndex] =
+                StripAttributeSuffix(StripGenericArity(metadata.GetStringView(metadata.Types()[typeIndex].nameIndex)));
+        }
+        return names_[typeIndex];
+    }
+
+private:
+    SwitchPort::MonotonicArena arena_;
+    std::unordered_map<std::string_view, std::vector<std::string_view>> linesByBlob_;
+    std::vector<std::string> uncachedText_;
+    std::vector<std::string_view> uncached_;
+    std::vector<std::string> names_;
+    std::vector<uint8_t> known_;
+};
+
+// Renders the attributes of the blob of localDataSize bytes at abs, one line per attribute.
+std::vector<std::string> DecodeAttributeRange(const SwitchPort::MetadataFile& metadata,
+                                              const SwitchPort::RuntimeTypeSystem* runtimeTypes,
+                                              const SwitchPort::ElfImage* elfImage,
+                                              const NestedParentTable& nestedParents, TypeNameCache& typeDefNameCache,
+                                              AttributeCache& attributeCache, uint32_t abs, uint32_t localDataSize) {
+    std::vector<std::string> out;
+    uint32_t count = 0;
+    uint32_t countBytes = 0;
+    if (!ReadCompressedUInt32At(metadata, abs, &count, &countBytes)) {
+        return out;
+    }
+    const uint32_t ctorListAbs = abs + countBytes;
+    if (count > localDataSize / 4) {
+        return out;
+    }
+    const auto& methods = metadata.Methods();
+    const auto& types = metadata.Types();
+    // Attribute i's arguments start where those of attributes 0..i-1 end. skipPos walks the blob once for all of
+    // them and stays put once an argument header fails to read.
+    uint32_t skipPos = ctorListAbs + count * 4;
+    bool skipStopped = false;
+    auto skipAttribute = [&]() {
+        uint32_t c = 0, b0 = 0, f = 0, b1 = 0, p = 0, b2 = 0;
+        if (!ReadCompressedUInt32At(metadata, skipPos, &c, &b0)) return false;
+        skipPos += b0;
+        if (!ReadCompressedUInt32At(metadata, skipPos, &f, &b1)) return false;
+        skipPos += b1;
+        if (!ReadCompressedUInt32At(metadata, skipPos, &p, &b2)) return false;
+        skipPos += b2;
+        for (uint32_t k = 0; k < c + f + p; ++k) {
+            uint8_t t = 0;
+            if (!metadata.ReadU8AtMetadataOffset(skipPos, &t)) break;
+            skipPos += 1;
+            if (t == kIl2CppTypeEnumSentinel) {
+                int32_t dummy = 0;
+                uint32_t br = 0;
+                if (!ReadCompressedInt32At(metadata, skipPos, &dummy, &br)) break;
+                skipPos += br;
+                t = kIl2CppTypeI4;
+            }
+            (void)DecodeAttributeValueToString(metadata, runtimeTypes, elfImage, nestedParents, typeDefNameCache, t, &skipPos, 0);
+            if (k >= c) {
+                int32_t memberIndex = 0;
+                uint32_t br = 0;
+                if (!ReadCompressedInt32At(metadata, skipPos, &memberIndex, &br)) break;
+                skipPos += br;
+                if (memberIndex < 0) {
+                    uint32_t dummyType = 0;
+                    if (!ReadCompressedUInt32At(metadata, skipPos, &dummyType, &br)) break;
+                    skipPos += br;
+                }
+            }
+        }
+        return true;
+    };
+    for (uint32_t i = 0; i < count; ++i) {
+        uint32_t dataPos = skipPos;
+        if (!skipStopped && i + 1 < count) {
+            skipStopped = !skipAttribute();
+        }
+        int32_t ctorIndex = -1;
+        if (!metadata.ReadI32AtMetadataOffset(ctorListAbs + i * 4, &ctorIndex)) {
+            break;
+        }
+        if (ctorIndex < 0 || static_cast<size_t>(ctorIndex) >= methods.size()) {
+            continue;
+        }
+        const int32_t decl = methods[static_cast<size_t>(ctorIndex)].declaringType;
+        if (decl < 0 || static_cast<size_t>(decl) >= types.size()) {
+            continue;
+        }
+        const std::string& attr = attributeCache.AttributeName(metadata, static_cast<size_t>(decl));
+        if (attr.empty()) {
+            continue;
+        }
+        uint32_t argCount = 0, bArg = 0, fieldCount = 0, bField = 0, propCount = 0, bProp = 0;
+        if (!ReadCompressedUInt32At(metadata, dataPos, &argCount, &bArg)) {
+            out.push_back("[" + attr + "]");
+            continue;
+        }
+        dataPos += bArg;
+        if (!ReadCompressedUInt32At(metadata, dataPos, &fieldCount, &bField)) {
+            out.push_back("[" + attr + "]");
+            continue;
+        }
+        dataPos += bField;
+        if (!ReadCompressedUInt32At(metadata, dataPos, &propCount, &bProp)) {
+            out.push_back("[" + attr + "]");
+            continue;
+        }
+        dataPos += bProp;
+
+        std::vector<std::string> args;
+        for (uint32_t ai = 0; ai < argCount; ++ai) {
+            uint8_t t = 0;
+            if (!metadata.ReadU8AtMetadataOffset(dataPos, &t)) {
+                break;
+            }
+            dataPos += 1;
+            if (t == kIl2CppTypeEnumSentinel) {
+                int32_t enumTypeIndex = -1;
+                uint32_t br = 0;
+                if (!ReadCompressedInt32At(metadata, dataPos, &enumTypeIndex, &br)) {
+                    break;
+                }
+                dataPos += br;
+                const auto enumRt = runtimeTypes ? runtimeTypes->GetTypeByIndex(enumTypeIndex) : std::nullopt;
+                if (enumRt.has_value() && enumRt->data < metadata.Types().size()) {
+                    const auto& td = metadata.Types()[static_cast<size_t>(enumRt->data)];
+                    if (td.elementTypeIndex >= 0) {
+                        const auto underRt = runtimeTypes->GetTypeByIndex(td.elementTypeIndex);
+                        if (underRt.has_value()) {
+                            t = underRt->type;
+                        }
+                    }
+                } else {
+                    t = kIl2CppTypeI4;
+                }
+            }
+            args.push_back(DecodeAttributeValueToString(metadata, runtimeTypes, elfImage, nestedParents, typeDefNameCache, t, &dataPos, 0));
+        }
+        auto readNamedArg = [&](bool isField) {
+            uint8_t t = 0;
+            if (!metadata.ReadU8AtMetadataOffset(dataPos, &t)) {
+                return;
+            }
+            dataPos += 1;
+            if (t == kIl2CppTypeEnumSentinel) {
+                int32_t dummy = -1;
+                uint32_t br = 0;
+                if (!ReadCompressedInt32At(metadata, dataPos, &dummy, &br)) {
+                    return;
+                }
+                dataPos += br;
+                t = kIl2CppTypeI4;
+            }
+            std::string value =
+                DecodeAttributeValueToString(metadata, runtimeTypes, elfImage, nestedParents, typeDefNameCache, t, &dataPos, 0);
+            int32_t memberIndex = 0;
+            uint32_t br = 0;
+            if (!ReadCompressedInt32At(metadata, dataPos, &memberIndex, &br)) {
+                return;
+            }
+            dataPos += br;
+            int32_t ownerTypeIndex = decl;
+            if (memberIndex < 0) {
+                memberIndex = -(memberIndex + 1);
+                uint32_t otherType = 0;
+                if (!ReadCompressedUInt32At(metadata, dataPos, &otherType, &br)) {
+                    return;
+                }
+                dataPos += br;
+                ownerTypeIndex = static_cast<int32_t>(otherType);
+            }
+            std::string memberName = isField ? ("field_" + std::to_string(memberIndex)) : ("prop_" + std::to_string(memberIndex));
+            if (ownerTypeIndex >= 0 && static_cast<size_t>(ownerTypeIndex) < types.size()) {
+                const auto& owner = types[static_cast<size_t>(ownerTypeIndex)];
+                if (isField) {
+                    const int32_t idx = owner.fieldStart + memberIndex;
+                    if (idx >= 0 && static_cast<size_t>(idx) < metadata.Fields().size()) {
+                        memberName = metadata.GetStringView(metadata.Fields()[static_cast<size_t>(idx)].nameIndex);
+                    }
+                } else {
+                    const int32_t idx = owner.propertyStart + memberIndex;
+                    if (idx >= 0 && static_cast<size_t>(idx) < metadata.Properties().size()) {
+                        memberName = metadata.GetStringView(metadata.Properties()[static_cast<size_t>(idx)].nameIndex);
+                    }
+                }
+            }
+            args.push_back(memberName + " = " + value);
+        };
+        for (uint32_t fi = 0; fi < fieldCount; ++fi) {
+            readNamedArg(true);
+        }
+        for (uint32_t pi = 0; pi < propCount; ++pi) {
+            readNamedArg(false);
+        }
+        if (args.empty()) {
+            out.push_back("[" + attr + "]");
+        } else {
+            std::string line = "[" + attr + "(";
+            for (size_t ai = 0; ai < args.size(); ++ai) {
+                if (ai != 0) {
+                    line += ", ";
+                }
+                line += args[ai];
+            }
+            line += ")]";
+            out.push_back(line);
+        }
+    }
+    return out;
+}
+
+// Attribute lines for token in the image. The reference is valid until the next call with the same attributeCache.
+const std::vector<std::string_view>& GetCustomAttributesForToken(const SwitchPort::MetadataFile& metadata,
+                                                                 const SwitchPort::RuntimeTypeSystem* runtimeTypes,
+                                                                 const SwitchPort::ElfImage* elfImage,
+                                                                 const NestedParentTable& nestedParents,
+                                                                 TypeNameCache& typeDefNameCache,
+                                                                 const AttributeTokenIndex& attributeTokens,
+                                                                 AttributeCache& attributeCache, size_t imageIndex,
+                                                                 uint32_t token) {
+    static const std::vector<std::string_view> kNoAttributes;
+    if (token == 0) {
+        return kNoAttributes;
+    }
+    const size_t hit = attributeTokens.Find(imageIndex, token);
+    if (hit == AttributeTokenIndex::kNoRange) {
+        return kNoAttributes;
+    }
+    const auto& ranges = metadata.AttributeDataRanges();
+    const uint32_t startOff = ranges[hit].startOffset;
+    const uint32_t endOff = (hit + 1 < ranges.size()) ? ranges[hit + 1].startOffset : static_cast<uint32_t>(metadata.GetAttributeDataSize());
+    if (endOff <= startOff) {
+        return kNoAttributes;
+    }
+    const uint32_t abs = metadata.GetAttributeDataOffset() + startOff;
+    const std::string_view blob = metadata.GetBytesView(abs, endOff - startOff);
+    if (blob.empty()) {
+        return attributeCache.StoreUncached(DecodeAttributeRange(metadata, runtimeTypes, elfImage, nestedParents,
+                                                                 typeDefNameCache, attributeCache, abs,
+                                                                 endOff - startOff));
+    }
+    if (const auto* cached = attributeCache.FindLines(blob); cached != nullptr) {
+        return *cached;
+    }
+    return attributeCache.StoreLines(blob, DecodeAttributeRange(metadata, runtimeTypes, elfImage, nestedParents,
+                                                                typeDefNameCache, attributeCache, abs,
+                                                                endOff - startOff));
+}
+
+class MethodPointerResolver {
+public:
+    bool Initialize(const SwitchPort::ElfImage& elf, const SwitchPort::MetadataFile& metadata, double metadataVersion,
+                    uint64_t codeRegistrationVa) {
+        modules_.clear();
+        imageModules_.clear();
+        genericMethodPointers_.clear();
+        if (codeRegistrationVa == 0 || metadataVersion < 24.2) {
+            return false;
+        }
+
+        uint64_t cursor = codeRegistrationVa;
+        std::unordered_map<std::string, uint64_t> fields;
+        auto readField = [&](const std::string& name, bool enabled) -> bool {
+            if (!enabled) {
+                return true;
+            }
+            uint64_t value = 0;
+            if (!elf.ReadU64AtVaddr(cursor, &value)) {
+                return false;
+            }
+            fields[name] = value;
+            cursor += 8;
+            return true;
+        };
+
+        if (!readField("methodPointersCount", metadataVersion <= 24.1) ||
+            !readField("methodPointers", metadataVersion <= 24.1) ||
+            !readField("delegateWrappersFromNativeToManagedCount", metadataVersion <= 21.0) ||
+            !readField("delegateWrappersFromNativeToManaged", metadataVersion <= 21.0) ||
+            !readField("reversePInvokeWrapperCount", metadataVersion >= 22.0) ||
+            !readField("reversePInvokeWrappers", metadataVersion >= 22.0) ||
+            !readField("delegateWrappersFromManagedToNativeCount", metadataVersion <= 22.0) ||
+            !readField("delegateWrappersFromManagedToNative", metadataVersion <= 22.0) ||
+            !readField("marshalingFunctionsCount", metadataVersion <= 22.0) ||
+            !readField("marshalingFunctions", metadataVersion <= 22.0) ||
+            !readField("ccwMarshalingFunctionsCount", metadataVersion >= 21.0 && metadataVersion <= 22.0) ||
+            !readField("ccwMarshalingFunctions", metadataVersion >= 21.0 && metadataVersion <= 22.0) ||
+            !readField("genericMethodPointersCount", true) || !readField("genericMethodPointers", true) ||
+            !readField("genericAdjustorThunks", metadataVersion >= 27.1) ||
+            !readField("invokerPointersCount", true) || !readField("invokerPointers", true) ||
+            !readField("customAttributeCount", metadataVersion <= 24.5) ||
+            !readField("customAttributeGenerators", metadataVersion <= 24.5) ||
+            !readField("guidCount", metadataVersion >= 21.0 && metadataVersion <= 22.0) ||
+            !readField("guids", metadataVersion >= 21.0 && metadataVersion <= 22.0) ||
+            !readField("unresolvedVirtualCallCount", metadataVersion >= 22.0) ||
+            !readField("unresolvedVirtualCallPointers", metadataVersion >= 22.0) ||
+            !readField("unresolvedInstanceCallPointers", metadataVersion >= 29.1) ||
+            !readField("unresolvedStaticCallPointers", metadataVersion >= 29.1) ||
+            !readField("interopDataCount", metadataVersion >= 23.0) || !readField("interopData", metadataVersion >= 23.0) ||
+            !readField("windowsRuntimeFactoryCount", metadataVersion >= 24.3) ||
+            !readField("windowsRuntimeFactoryTable", metadataVersion >= 24.3) ||
+            !readField("codeGenModulesCount", metadataVersion >= 24.2) || !readField("codeGenModules", metadataVersion >= 24.2)) {
+            return false;
+        }
+
+        const uint64_t moduleCount = fields["codeGenModulesCount"];
+        const uint64_t moduleTable = fields["codeGenModules"];
+        const uint64_t genericMethodPointerCount = fields["genericMethodPointersCount"];
+        const uint64_t genericMethodPointersVa = fields["genericMethodPointers"];
+        if (genericMethodPointerCount > 0 && genericMethodPointersVa != 0) {
+            (void)elf.ReadU64ArrayAtVaddr(genericMethodPointersVa, static_cast<size_t>(genericMethodPointerCount),
+                                          &genericMethodPointers_);
+        }
+        if (moduleCount == 0 || moduleTable == 0) {
+            return false;
+        }
+
+        std::unordered_map<std::string, size_t> moduleByName;
+        for (uint64_t i = 0; i < moduleCount; ++i) {
+            uint64_t moduleVa = 0;
+            if (!elf.ReadU64AtVaddr(moduleTable + i * 8, &moduleVa) || moduleVa == 0) {
+                continue;
+            }
+            uint64_t moduleNameVa = 0;
+            uint64_t methodPointerCount = 0;
+            uint64_t methodPointersVa = 0;
+            if (!elf.ReadU64AtVaddr(moduleVa, &moduleNameVa) || !elf.ReadU64AtVaddr(moduleVa + 8, &methodPointerCount) ||
+                !elf.ReadU64AtVaddr(moduleVa + 16, &methodPointersVa)) {
+                continue;
+            }
+            std::string moduleName;
+            if (!elf.ReadCStringAtVaddr(moduleNameVa, &moduleName) || moduleName.empty()) {
+                continue;
+            }
+            if (moduleByName.count(moduleName) != 0) {
+                continue;
+            }
+            std::vector<uint64_t> methodPointers;
+            (void)elf.ReadU64ArrayAtVaddr(methodPointersVa, static_cast<size_t>(methodPointerCount), &methodPointers);
+            moduleByName.emplace(moduleName, modules_.size());
+            modules_.push_back(std::move(methodPointers));
+        }
+
+        // Match every image to its CodeGenModule once, so per-method lookups are plain array indexing.
+        const auto& images = metadata.Images();
+        imageModules_.assign(images.size(), kNoModule);
+        for (size_t i = 0; i < images.size(); ++i) {
+            const auto it = moduleByName.find(std::string(metadata.GetStringView(images[i].nameIndex)));
+            if (it != moduleByName.end()) {
+                imageModules_[i] = it->second;
+            }
+        }
+        return !modules_.empty();
+    }
+
+    // Method pointers of the CodeGenModule bound to an image, indexed by (token & 0xFFFFFF) - 1; nullptr if none.
+    const std::vector<uint64_t>* ImageMethodPointers(size_t imageIndex) const {
+        if (imageIndex >= imageModules_.size() || imageModules_[imageIndex] == kNoModule) {
+            return nullptr;
+        }
+        return &modules_[imageModules_[imageIndex]];
+    }
+
+    uint64_t GetMethodPointer(size_t imageIndex, uint32_t methodToken) const {
+        const std::vector<uint64_t>* pointers = ImageMethodPointers(imageIndex);
+        if (pointers == nullptr) {
+            return 0;
+        }
+        const uint32_t methodPointerIndex = methodToken & 0x00FFFFFFu;
+        if (methodPointerIndex == 0) {
+            return 0;
+        }
+        const size_t idx = static_cast<size_t>(methodPointerIndex - 1);
+        if (idx >= pointers->size()) {
+            return 0;
+        }
+        return (*pointers)[idx];
+    }
+
+    uint64_t GetGenericMethodPointer(int32_t methodIndex) const {
+        if (methodIndex < 0 || static_cast<size_t>(methodIndex) >= genericMethodPointers_.size()) {
+            return 0;
+        }
+        return genericMethodPointers_[static_cast<size_t>(methodIndex)];
+    }
+
+private:
+    static constexpr size_t kNoModule = static_cast<size_t>(-1);
+
+    std::vector<std::vector<uint64_t>> modules_;
+    std::vector<size_t> imageModules_;
+    std::vector<uint64_t> genericMethodPointers_;
+};
+
+std::string BuildGenericInstParams(const SwitchPort::MetadataFile& metadata, const SwitchPort::RuntimeTypeSystem* runtimeTypes,
+                                   const SwitchPort::ElfImage* elfImage,
+                                   const NestedParentTable& nestedParents,
+                                   TypeNameCache& typeDefNameCache, int32_t genericInstIndex) {
+    if (runtimeTypes == nullptr || elfImage == nullptr || genericInstIndex < 0) {
+        return "";
+    }
+    std::vector<uint64_t> argPtrs;
+    if (!runtimeTypes->GetGenericInstArgTypePointers(*elfImage, genericInstIndex, &argPtrs) || argPtrs.empty()) {
+        return "";
+    }
+    std::string out = "<";
+    for (size_t i = 0; i < argPtrs.size(); ++i) {
+        if (i != 0) {
+            out += ", ";
+        }
+        const auto argRt = runtimeTypes->GetTypeByPointer(argPtrs[i]);
+        if (argRt.has_value()) {
+            out += ResolveRuntimeType(metadata, runtimeTypes, elfImage, *argRt, nestedParents, typeDefNameCache, 0);
+        } else {
+            out += "Il2CppType_" + std::to_string(static_cast<unsigned long long>(argPtrs[i]));
+        }
+    }
+    out += ">";
+    return out;
+}
+
+// Generic method instantiations of every method definition, built in one pass over the generic method table before
+// rendering. Each generic inst's argument list is resolved once and shared by every instantiation naming it. The
+// instantiations of method m are entries_[offsets_[m], offsets_[m + 1]), grouped by method pointer in the order the
+// pointers first appear.
+class GenericInstMethodTable {
+public:
+    struct Entry {
+        uint64_t ptr = 0;
+        uint32_t line = 0;
+    };
+
+    struct Range {
+        const Entry* first = nullptr;
+        const Entry* last = nullptr;
+
+        bool empty() const { return first == last; }
+    };
+
+    void Build(const SwitchPort::MetadataFile& metadata, const SwitchPort::RuntimeTypeSystem& runtimeTypes,
+               const SwitchPort::ElfImage& elfImage, const MethodPointerResolver& methodResolver,
+               const NestedParentTable& nestedParents, TypeNameCache& typeNameCache) {
+        const auto& types = metadata.Types();
+        const auto& methods = metadata.Methods();
+        const auto& specs = runtimeTypes.MethodSpecs();
+        const auto& gmt = runtimeTypes.GenericMethodTable();
+
+        // Argument lists by generic inst index; kUnresolved until first used. Indices come from the binary, so
+        // ones past the generic inst table render as no arguments, as BuildGenericInstParams would.
+        std::vector<uint32_t> argListIds(runtimeTypes.GenericInstPointers().size(), kUnresolved);
+        std::vector<std::string> argLists;
+        static const std::string kNoArguments;
+        auto argList = [&](int32_t genericInstIndex) -> const std::string& {
+            const size_t slot = static_cast<size_t>(genericInstIndex);
+            if (slot >= argListIds.size()) {
+                return kNoArguments;
+            }
+            if (argListIds[slot] == kUnresolved) {
+                argListIds[slot] = static_cast<uint32_t>(argLists.size());
+                argLists.push_back(BuildGenericInstParams(metadata, &runtimeTypes, &elfImage, nestedParents,
+                                                          typeNameCache, genericInstIndex));
+            }
+            return argLists[argListIds[slot]];
+        };
+
+        struct Pending {
+            uint32_t method = 0;
+            Entry entry;
+        };
+        std::vector<Pending> pending;
+        pending.reserve(gmt.size());
+        std::unordered_map<std::string_view, uint32_t> lineIds;
+        std::string line;
+        offsets_.assign(methods.size() + 1, 0);
+        for (const auto& e : gmt) {
+            if (e.genericMethodIndex < 0 || static_cast<size_t>(e.genericMethodIndex) >= specs.size()) {
+                continue;
+            }
+            const auto& ms = specs[static_cast<size_t>(e.genericMethodIndex)];
+            if (ms.methodDefinitionIndex < 0 || static_cast<size_t>(ms.methodDefinitionIndex) >= methods.size()) {
+                continue;
+            }
+            const auto& methodDef = methods[static_cast<size_t>(ms.methodDefinitionIndex)];
+            if (methodDef.declaringType < 0 || static_cast<size_t>(methodDef.declaringType) >= types.size()) {
+                continue;
+            }
+            line = BuildTypeDefName(metadata, static_cast<size_t>(methodDef.declaringType), nestedParents, typeNameCache);
+            if (ms.classIndexIndex >= 0) {
+                line += argList(ms.classIndexIndex);
+            }
+            line += '.';
+            line += metadata.GetStringView(methodDef.nameIndex);
+            if (ms.methodIndexIndex >= 0) {
+                line += argList(ms.methodIndexIndex);
+            }
+            const auto found = lineIds.find(line);
+            uint32_t lineId = 0;
+            if (found != lineIds.end()) {
+                lineId = found->second;
+            } else {
+                lineId = static_cast<uint32_t>(lines_.size());
+                lines_.push_back(arena_.Copy(line));
+                lineIds.emplace(lines_.back(), lineId);
+            }
+            const uint32_t method = static_cast<uint32_t>(ms.methodDefinitionIndex);
+            pending.push_back({method, {methodResolver.GetGenericMethodPointer(e.methodIndex), lineId}});
+            ++offsets_[method + 1];
+        }
+
+        std::partial_sum(offsets_.begin(), offsets_.end(), offsets_.begin());
+        entries_.resize(pending.size());
+        std::vector<uint32_t> cursor(offsets_.begin(), offsets_.end() - 1);
+        for (const auto& p : pending) {
+            entries_[cursor[p.method]++] = p.entry;
+        }
+
+        // Order each method's entries by the first appearance of their pointer, keeping table order within a group.
+        std::unordered_map<uint64_t, uint32_t> firstSeen;
+        for (size_t m = 0; m + 1 < offsets_.size(); ++m) {
+            const auto first = entries_.begin() + offsets_[m];
+            const auto last = entries_.begin() + offsets_[m + 1];
+            if (last - first < 2) {
+                continue;
+            }
+            firstSeen.clear();
+            for (auto it = first; it != last; ++it) {
+                firstSeen.emplace(it->ptr, static_cast<uint32_t>(firstSeen.size()));
+            }
+            if (firstSeen.size() > 1) {
+                std::stable_sort(first, last, [&](const Entry& a, const Entry& b) {
+                    return firstSeen[a.ptr] < firstSeen[b.ptr];
+                });
+            }
+        }
+    }
+
+    Range ForMethod(size_t methodIndex) const {
+        if (methodIndex + 1 >= offsets_.size()) {
+            return {};
+        }
+        return {entries_.data() + offsets_[methodIndex], entries_.data() + offsets_[methodIndex + 1]};
+    }
+
+    std::string_view Line(uint32_t id) const { return lines_[id]; }
+
+private:
+    static constexpr uint32_t kUnresolved = 0xFFFFFFFFu;
+
+    SwitchPort::MonotonicArena arena_;
+    std::vector<uint32_t> offsets_;
+    std::vector<Entry> entries_;
+    std::vector<std::string_view> lines_;
+};
+
+bool IsNameChar(char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) != 0 || c == '_' || c == '.' || c == ':' || c == '<' || c == '>' ||
+           c == '`';
+}
+
+std::string_view TrimView(std::string_view input) {
+    size_t start = 0;
+    while (start < input.size() && std::isspace(static_cast<unsigned char>(input[start])) != 0) {
+        ++start;
+    }
+    size_t end = input.size();
+    while (end > start && std::isspace(static_cast<unsigned char>(input[end - 1])) != 0) {
+        --end;
+    }
+    return input.substr(start, end - start);
+}
+
+std::string_view NormalizeSymbolWord(std::string_view input) {
+    if (input.empty()) {
+        return "";
+    }
+    size_t start = 0;
+    while (start < input.size() && !IsNameChar(input[start])) {
+        ++start;
+    }
+    size_t end = input.size();
+    while (end > start && !IsNameChar(input[end - 1])) {
+        --end;
+    }
+    if (end <= start) {
+        return {};
+    }
+    return input.substr(start, end - start);
+}
+
+// Normalizes name and copies the result into arena; only array suffixes are appended, everything else is a slice.
+std::string_view NormalizeTypeNameForLookup(std::string_view name, SwitchPort::MonotonicArena& arena) {
+    name = TrimView(name);
+    if (name.empty()) {
+        return {};
+    }
+
+    uint32_t arrayDims = 0;
+    while (name.size() >= 2 && name.compare(name.size() - 2, 2, "[]") == 0) {
+        name = TrimView(name.substr(0, name.size() - 2));
+        ++arrayDims;
+    }
+
+    name = NormalizeSymbolWord(name);
+    if (name.empty()) {
+        return {};
+    }
+
+    constexpr std::string_view kGlobalPrefix = "global::";
+    if (name.rfind(kGlobalPrefix, 0) == 0) {
+        name.remove_prefix(kGlobalPrefix.size());
+    }
+
+    while (!name.empty() && (name.back() == ',' || name.back() == ';')) {
+        name.remove_suffix(1);
+    }
+    name = TrimView(name);
+    if (name.empty()) {
+        return {};
+    }
+
+    if (arrayDims == 0) {
+        return arena.Copy(name);
+    }
+    const size_t size = name.size() + 2 * static_cast<size_t>(arrayDims);
+    char* out = static_cast<char*>(arena.Allocate(size, 1));
+    std::memcpy(out, name.data(), name.size());
+    for (size_t i = name.size(); i < size; i += 2) {
+        out[i] = '[';
+        out[i + 1] = ']';
+    }
+    return std::string_view(out, size);
+}
+
+bool TryExtractNameToken(std::string_view value, size_t start, std::string_view* normalized) {
+    size_t end = start;
+    while (end < value.size() && IsNameChar(value[end])) {
+        ++end;
+    }
+    if (end <= start) {
+        return false;
+    }
+    if (normalized != nullptr) {
+        *normalized = NormalizeSymbolWord(value.substr(start, end - start));
+    }
+    return normalized != nullptr && !normalized->empty();
+}
+
+bool TryExtractPublicDefinitionWord(std::string_view line, std::string_view* outWord) {
+    constexpr const char* kPublicClass = "public class ";
+    constexpr const char* kPublicStruct = "public struct ";
+    constexpr const char* kPublicEnum = "public enum ";
+    if (line.rfind(kPublicClass, 0) == 0) {
+        return TryExtractNameToken(line, std::char_traits<char>::length(kPublicClass), outWord);
+    }
+    if (line.rfind(kPublicStruct, 0) == 0) {
+        return TryExtractNameToken(line, std::char_traits<char>::length(kPublicStruct), outWord);
+    }
+    if (line.rfind(kPublicEnum, 0) == 0) {
+        return TryExtractNameToken(line, std::char_traits<char>::length(kPublicEnum), outWord);
+    }
+    return false;
+}
+
+// "scope.name" copied into arena, or just name when scope is empty.
+std::string_view QualifyName(std::string_view scope, std::string_view name, SwitchPort::MonotonicArena& arena) {
+    if (scope.empty()) {
+        return arena.Copy(name);
+    }
+    const size_t size = scope.size() + 1 + name.size();
+    char* out = static_cast<char*>(arena.Allocate(size, 1));
+    std::memcpy(out, scope.data(), scope.size());
+    out[scope.size()] = '.';
+    std::memcpy(out + scope.size() + 1, name.data(), name.size());
+    return std::string_view(out, size);
+}
+
+// The record's names are copied into arena.
+bool TryExtractTypeInfo(std::string_view line, std::string_view namespaceName, SwitchPort::MonotonicArena& arena,
+                        TypeInfoRecord* outRecord) {
+    if (line.find("TypeDefIndex:") == std::string_view::npos) {
+        return false;
+    }
+
+    size_t commentIndex = line.find("// TypeDefIndex:");
+    const std::string_view header = TrimView(commentIndex == std::string_view::npos ? line : line.substr(0, commentIndex));
+    if (header.empty()) {
+        return false;
+    }
+
+    struct KeywordEntry {
+        const char* keyword;
+        bool isStruct;
+        bool isEnum;
+    };
+    constexpr KeywordEntry kKeywords[] = {
+        {" class ", false, false},
+        {" struct ", true, false},
+        {" enum ", false, true},
+        {" interface ", false, false},
+    };
+
+    size_t keywordIndex = std::string_view::npos;
+    size_t keywordLength = 0;
+    bool isStruct = false;
+    bool isEnum = false;
+    for (const auto& k : kKeywords) {
+        const size_t idx = header.find(k.keyword);
+        if (idx == std::string_view::npos) {
+            continue;
+        }
+        keywordIndex = idx;
+        keywordLength = std::char_traits<char>::length(k.keyword);
+        isStruct = k.isStruct;
+        isEnum = k.isEnum;
+        break;
+    }
+    if (keywordIndex == std::string_view::npos) {
+        return false;
+    }
+
+    size_t typeStart = keywordIndex + keywordLength;
+    while (typeStart < header.size() && std::isspace(static_cast<unsigned char>(header[typeStart])) != 0) {
+        ++typeStart;
+    }
+
+    size_t typeEnd = typeStart;
+    while (typeEnd < header.size() && IsNameChar(header[typeEnd])) {
+        ++typeEnd;
+    }
+    if (typeEnd <= typeStart) {
+        return false;
+    }
+
+    TypeInfoRecord rec{};
+    rec.typeName = NormalizeTypeNameForLookup(header.substr(typeStart, typeEnd - typeStart), arena);
+    if (rec.typeName.empty()) {
+        return false;
+    }
+
+    const size_t colonIndex = header.find(':', typeEnd);
+    if (colonIndex != std::string_view::npos) {
+        size_t baseStart = colonIndex + 1;
+        while (baseStart < header.size() && std::isspace(static_cast<unsigned char>(header[baseStart])) != 0) {
+            ++baseStart;
+        }
+        size_t baseEnd = baseStart;
+        while (baseEnd < header.size() && header[baseEnd] != ',' && header[baseEnd] != '{') {
+            ++baseEnd;
+        }
+        rec.baseName = NormalizeTypeNameForLookup(header.substr(baseStart, baseEnd - baseStart), arena);
+    } else if (isStruct) {
+        rec.baseName = "System.ValueType";
+    } else if (isEnum) {
+        rec.baseName = "System.Enum";
+    }
+
+    rec.namespaceName = arena.Copy(TrimView(namespaceName));
+    if (rec.namespaceName.empty()) {
+        rec.fullName = rec.typeName;
+    } else {
+        rec.fullName = QualifyName(rec.namespaceName, rec.typeName, arena);
+    }
+
+    if (outRecord != nullptr) {
+        *outRecord = rec;
+    }
+    return true;
+}
+
+bool StartsWith(std::string_view value, std::string_view prefix) {
+    return value.size() >= prefix.size() && value.compare(0, prefix.size(), prefix) == 0;
+}
+
+bool TryParseHexAfterPrefix(std::string_view line, std::string_view prefix, uint64_t* value) {
+    if (!StartsWith(line, prefix)) {
+        return false;
+    }
+    uint64_t parsed = 0;
+    size_t end = prefix.size();
+    for (; end < line.size(); ++end) {
+        const char c = line[end];
+        uint64_t digit = 0;
+        if (c >= '0' && c <= '9') {
+            digit = static_cast<uint64_t>(c - '0');
+        } else if (c >= 'a' && c <= 'f') {
+            digit = static_cast<uint64_t>(c - 'a' + 10);
+        } else if (c >= 'A' && c <= 'F') {
+            digit = static_cast<uint64_t>(c - 'A' + 10);
+        } else {
+            break;
+        }
+        if (parsed > (std::numeric_limits<uint64_t>::max() >> 4)) {
+            return false; // out of 64-bit range
+        }
+        parsed = (parsed << 4) | digit;
+    }
+    if (end <= prefix.size()) {
+        return false;
+    }
+    if (value != nullptr) {
+        *value = parsed;
+    }
+    return true;
+}
+
+// Name of the method declared on a dump.cs line, with its generic parameters: the token before the parameter list.
+std::string_view ExtractDeclaredMethodName(std::string_view line) {
+    const size_t paren = line.find('(');
+    if (paren == std::string_view::npos) {
+        return {};
+    }
+    size_t start = paren;
+    int depth = 0;
+    while (start > 0) {
+        const char c = line[start - 1];
+        if (c == '>') {
+            ++depth;
+        } else if (c == '<') {
+            --depth;
+        } else if (depth == 0 && std::isspace(static_cast<unsigned char>(c)) != 0) {
+            break;
+        }
+        --start;
+    }
+    return line.substr(start, paren - start);
+}
+
+template <typename T>
+void WriteBinary(std::ofstream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool ReadBinary(std::ifstream& in, T* value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(value), sizeof(T)));
+}
+
+void WriteLengthPrefixedString(std::ofstream& out, std::string_view value) {
+    const uint32_t size = static_cast<uint32_t>(value.size());
+    WriteBinary(out, size);
+    if (!value.empty()) {
+        out.write(value.data(), static_cast<std::streamsize>(value.size()));
+    }
+}
+
+// Read size used when rescanning an existing dump.cs.
+constexpr size_t kDumpScanBlockBytes = 4u * 1024u * 1024u;
+
+// Records the index entries for a type header line, using the same extractors as the dump.cs rescan.
+void CollectTypeHeaderLine(std::string_view line, std::string_view namespaceName, uint64_t offset, DumpIndexChunk* index) {
+    const std::string_view trimmed = TrimView(line);
+    std::string_view word;
+    if (TryExtractPublicDefinitionWord(trimmed, &word)) {
+        index->definitions.emplace_back(index->strings.Copy(word), offset);
+    }
+    TypeInfoRecord typeInfo{};
+    if (TryExtractTypeInfo(trimmed, namespaceName, index->strings, &typeInfo)) {
+        typeInfo.offset = offset;
+        index->typeInfos.push_back(typeInfo);
+    }
+}
+
+uint32_t CountLines(std::string_view text) {
+    return static_cast<uint32_t>(std::count(text.begin(), text.end(), '\n'));
+}
+
+// Read-only state shared by every dump.cs writer; per-writer mutable state (the type name cache) is passed separately.
+struct DumpContext {
+    const SwitchPort::MetadataFile* metadata = nullptr;
+    const SwitchPort::RuntimeTypeSystem* runtimeTypes = nullptr;
+    const SwitchPort::ElfImage* elfImage = nullptr;
+    const MethodPointerResolver* methodResolver = nullptr;
+    bool hasMethodPointers = false;
+    const NestedParentTable* nestedParents = nullptr;
+    const GenericInstMethodTable* genericInstMethods = nullptr;
+    const AttributeTokenIndex* attributeTokens = nullptr;
+    bool collectMethodNames = false;
+};
+
+// Appends the method's name followed by its generic parameter list, e.g. "Map<TKey, TValue>".
+void AppendMethodName(SwitchPort::TextBuffer& out, const SwitchPort::MetadataFile& metadata,
+                      const SwitchPort::MethodDefinition& method) {
+    out << metadata.GetStringView(method.nameIndex);
+    if (method.genericContainerIndex < 0 ||
+        static_cast<size_t>(method.genericContainerIndex) >= metadata.GenericContainers().size()) {
+        return;
+    }
+    const auto& gc = metadata.GenericContainers()[static_cast<size_t>(method.genericContainerIndex)];
+    if (gc.typeArgc <= 0 || gc.genericParameterStart < 0) {
+        return;
+    }
+    out << '<';
+    for (int32_t gpNum = 0; gpNum < gc.typeArgc; ++gpNum) {
+        if (gpNum != 0) {
+            out << ", ";
+        }
+        const int32_t gpIndex = gc.genericParameterStart + gpNum;
+        std::string_view gpName;
+        if (gpIndex >= 0 && static_cast<size_t>(gpIndex) < metadata.GenericParameters().size()) {
+            const auto& gp = metadata.GenericParameters()[static_cast<size_t>(gpIndex)];
+            gpName = metadata.GetStringView(gp.nameIndex);
+        }
+        if (!gpName.empty()) {
+            out << gpName;
+        } else {
+            out << 'T';
+            out.AppendDecimal(gpNum);
+        }
+    }
+    out << '>';
+}
+
+// Appends one type block to out. When index is non-null, the namespace, type header and RVA lines are recorded
+// with offsets relative to the start of out.
+void WriteDumpType(SwitchPort::TextBuffer& out, const DumpContext& ctx, TypeNameCache& typeNameCache,
+                   AttributeCache& attributeCache, size_t imageIndex, size_t typeIndex, DumpIndexChunk* index) {
+    const auto& metadata = *ctx.metadata;
+    const auto* runtimeTypes = ctx.runtimeTypes;
+    const auto* elfImage = ctx.elfImage;
+    const auto& methodResolver = *ctx.methodResolver;
+    const bool hasMethodPointers = ctx.hasMethodPointers;
+    const auto& nestedParents = *ctx.nestedParents;
+    const auto& genericInstMethods = *ctx.genericInstMethods;
+    const auto& attributeTokens = *ctx.attributeTokens;
+    const auto& types = metadata.Types();
+    const auto& fields = metadata.Fields();
+    const auto& methods = metadata.Methods();
+    const auto& parameters = metadata.Parameters();
+    const auto& properties = metadata.Properties();
+    const auto& interfaceIndices = metadata.InterfaceIndices();
+
+    const auto& type = types[typeIndex];
+    const std::string_view ns = metadata.GetStringView(type.namespaceIndex);
+    const std::string_view typeName = BuildTypeDefName(metadata, typeIndex, nestedParents, typeNameCache);
+    std::vector<std::string> extends;
+    if (type.parentIndex >= 0) {
+        const std::string parentName =
+            ResolveTypeName(metadata, runtimeTypes, elfImage, type.parentIndex, nestedParents, typeNameCache);
+        if (!type.IsValueType() && !type.IsEnum() && parentName != "object" && !parentName.empty()) {
+            extends.push_back(parentName);
+        }
+    }
+    if (type.interfacesCount > 0 && type.interfacesStart >= 0) {
+        const size_t ifaceStart = static_cast<size_t>(type.interfacesStart);
+        const size_t ifaceEnd = ifaceStart + static_cast<size_t>(type.interfacesCount);
+        for (size_t ii = ifaceStart; ii < ifaceEnd && ii < interfaceIndices.size(); ++ii) {
+            const int32_t ifaceTypeIndex = interfaceIndices[ii];
+            if (ifaceTypeIndex >= 0) {
+                extends.push_back(
+                    ResolveTypeName(metadata, runtimeTypes, elfImage, ifaceTypeIndex, nestedParents, typeNameCache));
+            }
+        }
+    }
+
+    out << "\n";
+    if (index != nullptr) {
+        index->namespaceOffsets.push_back(out.Size());
+    }
+    out << "// Namespace: " << ns << "\n";
+    for (const auto& attr :
+         GetCustomAttributesForToken(metadata, runtimeTypes, elfImage, nestedParents, typeNameCache, attributeTokens,
+                                     attributeCache, imageIndex, type.token)) {
+        out << attr << "\n";
+    }
+    if ((type.flags & kTypeSerializable) != 0) {
+        out << "[Serializable]\n";
+    }
+    const size_t headerStart = out.Size();
+    out << TypeVisibility(type.flags) << TypeModifiers(type) << ' ' << TypeKeyword(type) << ' ' << typeName;
+    for (size_t ei = 0; ei < extends.size(); ++ei) {
+        out << (ei == 0 ? " : " : ", ") << extends[ei];
+    }
+    out << " // TypeDefIndex: ";
+    out.AppendDecimal(static_cast<uint64_t>(typeIndex));
+    // Qualifies the method names recorded for the IDX2 method index, as the dump.cs rescan does.
+    std::string_view typeFullName;
+    if (index != nullptr) {
+        const size_t typeInfoCount = index->typeInfos.size();
+        CollectTypeHeaderLine(out.View().substr(headerStart), ns, headerStart, index);
+        if (index->typeInfos.size() > typeInfoCount) {
+            typeFullName = index->typeInfos.back().fullName;
+        }
+    }
+    out << "\n{\n";
+
+    if (type.fieldCount > 0 && type.fieldStart >= 0) {
+        out << "\t// Fields\n";
+        const size_t fieldStart = static_cast<size_t>(type.fieldStart);
+        const size_t fieldEnd = fieldStart + static_cast<size_t>(type.fieldCount);
+        for (size_t i = fieldStart; i < fieldEnd && i < fields.size(); ++i) {
+            const auto& field = fields[i];
+            for (const auto& attr :
+                 GetCustomAttributesForToken(metadata, runtimeTypes, elfImage, nestedParents, typeNameCache,
+                                             attributeTokens, attributeCache, imageIndex, field.token)) {
+                out << "\t" << attr << "\n";
+            }
+            const std::string_view fieldName = metadata.GetStringView(field.nameIndex);
+            const auto fieldRt = runtimeTypes ? runtimeTypes->GetTypeByIndex(field.typeIndex) : std::nullopt;
+            const uint16_t fieldAttrs = fieldRt ? fieldRt->attrs : 0;
+            const bool isConst = (fieldAttrs & kFieldLiteral) != 0;
+            const bool isStatic = (fieldAttrs & kFieldStatic) != 0;
+            out << "\t" << FieldModifiers(fieldAttrs) << " "
+                << ResolveTypeName(metadata, runtimeTypes, elfImage, field.typeIndex, nestedParents, typeNameCache) << " "
+                << fieldName;
+            SwitchPort::FieldDefaultValue fdv{};
+            if (metadata.TryGetFieldDefaultValue(static_cast<int32_t>(i), &fdv) && fdv.dataIndex >= 0) {
+                const std::string value = FormatFieldDefaultValue(metadata, runtimeTypes, fdv);
+                if (!value.empty()) {
+                    out << " = " << value;
+                }
+            }
+            out << ";";
+            if (runtimeTypes != nullptr && elfImage != nullptr && !isConst) {
+                const int32_t fieldOffset =
+                    runtimeTypes->GetFieldOffsetFromIndex(*elfImage, static_cast<double>(metadata.Header().version),
+                                                          static_cast<int32_t>(typeIndex),
+                                                          static_cast<int32_t>(i - fieldStart), static_cast<int32_t>(i),
+                                                          type.IsValueType(), isStatic);
+                out << " // 0x";
+                out.AppendHex(static_cast<uint32_t>(fieldOffset));
+            }
+            out << "\n";
+        }
+    }
+
+    if (type.propertyCount > 0 && type.propertyStart >= 0) {
+        out << "\t// Properties\n";
+        const size_t propertyStart = static_cast<size_t>(type.propertyStart);
+        const size_t propertyEnd = propertyStart + static_cast<size_t>(type.propertyCount);
+        for (size_t i = propertyStart; i < propertyEnd && i < properties.size(); ++i) {
+            const auto& property = properties[i];
+            for (const auto& attr :
+                 GetCustomAttributesForToken(metadata, runtimeTypes, elfImage, nestedParents, typeNameCache,
+                                             attributeTokens, attributeCache, imageIndex, property.token)) {
+                out << "\t" << attr << "\n";
+            }
+            int32_t propertyTypeIndex = -1;
+            uint16_t propertyFlags = 0;
+            bool hasAccessor = false;
+            if (property.get >= 0 && type.methodStart >= 0) {
+                const size_t methodIndex = static_cast<size_t>(type.methodStart + property.get);
+                if (methodIndex < methods.size()) {
+                    propertyTypeIndex = methods[methodIndex].returnType;
+                    propertyFlags = methods[methodIndex].flags;
+                    hasAccessor = true;
+                }
+            } else if (property.set >= 0 && type.methodStart >= 0) {
+                const size_t methodIndex = static_cast<size_t>(type.methodStart + property.set);
+                if (methodIndex < methods.size()) {
+                    const auto& method = methods[methodIndex];
+                    propertyFlags = method.flags;
+                    if (method.parameterStart >= 0 && static_cast<size_t>(method.parameterStart) < parameters.size()) {
+                        propertyTypeIndex = parameters[static_cast<size_t>(method.parameterStart)].typeIndex;
+                    }
+                    hasAccessor = true;
+                }
+            }
+            out << "\t";
+            if (hasAccessor) {
+                out << MethodModifiers(propertyFlags) << " ";
+            } else {
+                out << "public ";
+            }
+            out << ResolveTypeName(metadata, runtimeTypes, elfImage, propertyTypeIndex, nestedParents, typeNameCache) << " "
+                << metadata.GetStringView(property.nameIndex) << " { ";
+            if (property.get >= 0) {
+                out << "get; ";
+            }
+            if (property.set >= 0) {
+                out << "set; ";
+            }
+            out << "}\n";
+        }
+    }
+
+    if (type.methodCount > 0 && type.methodStart >= 0) {
+        out << "\t// Methods\n";
+        const size_t methodStart = static_cast<size_t>(type.methodStart);
+        const size_t methodEnd = methodStart + static_cast<size_t>(type.methodCount);
+        for (size_t i = methodStart; i < methodEnd && i < methods.size(); ++i) {
+            const auto& method = methods[i];
+            const bool isAbstract = (method.flags & kMethodAbstract) != 0;
+            out << "\n";
+            for (const auto& attr :
+                 GetCustomAttributesForToken(metadata, runtimeTypes, elfImage, nestedParents, typeNameCache,
+                                             attributeTokens, attributeCache, imageIndex, method.token)) {
+                out << "\t" << attr << "\n";
+            }
+            std::optional<uint64_t> rvaLineOffset;
+            if (hasMethodPointers) {
+                const uint64_t methodPointer = methodResolver.GetMethodPointer(imageIndex, method.token);
+                if (!isAbstract && methodPointer > 0) {
+                    uint64_t methodOffset = 0;
+                    if (elfImage->TryMapVaddrToOffset(methodPointer, &methodOffset)) {
+                        if (index != nullptr) {
+                            index->rvas.emplace_back(methodPointer, out.Size());
+                            rvaLineOffset = out.Size();
+                        }
+                        out << "\t// RVA: 0x";
+                        out.AppendHex(methodPointer) << " Offset: 0x";
+                        out.AppendHex(methodOffset) << " VA: 0x";
+                        out.AppendHex(methodPointer);
+                    } else {
+                        out << "\t// RVA: -1 Offset: -1";
+                    }
+                } else {
+                    out << "\t// RVA: -1 Offset: -1";
+                }
+                if (method.slot != 0xFFFFu) {
+                    out << " Slot: ";
+                    out.AppendDecimal(static_cast<uint32_t>(method.slot));
+                }
+                out << "\n";
+            }
+            const auto returnRt = runtimeTypes ? runtimeTypes->GetTypeByIndex(method.returnType) : std::nullopt;
+            out << "\t" << MethodModifiers(method.flags) << " "
+                << ((returnRt && returnRt->byref == 1) ? "ref " : "")
+                << ResolveTypeName(metadata, runtimeTypes, elfImage, method.returnType, nestedParents, typeNameCache) << ' ';
+            const size_t methodNameStart = out.Size();
+            AppendMethodName(out, metadata, method);
+            if (rvaLineOffset.has_value() && ctx.collectMethodNames) {
+                index->methodNames.emplace_back(QualifyName(typeFullName, out.View().substr(methodNameStart), index->strings),
+                                                *rvaLineOffset);
+            }
+            out << '(';
+
+            bool first = true;
+            if (method.parameterStart >= 0) {
+                const size_t paramStart = static_cast<size_t>(method.parameterStart);
+                const size_t paramEnd = paramStart + static_cast<size_t>(method.parameterCount);
+                for (size_t p = paramStart; p < paramEnd && p < parameters.size(); ++p) {
+                    const auto& param = parameters[p];
+                    if (!first) {
+                        out << ", ";
+                    }
+                    first = false;
+                    const auto paramRt = runtimeTypes ? runtimeTypes->GetTypeByIndex(param.typeIndex) : std::nullopt;
+                    if (paramRt.has_value() && paramRt->byref == 1) {
+                        const bool hasOut = (paramRt->attrs & kParamAttributeOut) != 0;
+                        const bool hasIn = (paramRt->attrs & kParamAttributeIn) != 0;
+                        if (hasOut && !hasIn) {
+                            out << "out ";
+                        } else if (!hasOut && hasIn) {
+                            out << "in ";
+                        } else {
+                            out << "ref ";
+                        }
+                    } else if (paramRt.has_value()) {
+                        if ((paramRt->attrs & kParamAttributeIn) != 0) {
+                            out << "[In] ";
+                        }
+                        if ((paramRt->attrs & kParamAttributeOut) != 0) {
+                            out << "[Out] ";
+                        }
+                    }
+                    out << ResolveTypeName(metadata, runtimeTypes, elfImage, param.typeIndex, nestedParents, typeNameCache)
+                        << ' ';
+                    const std::string_view parameterName = metadata.GetStringView(param.nameIndex);
+                    if (!parameterName.empty()) {
+                        out << parameterName;
+                    } else {
+                        out << "param_";
+                        out.AppendDecimal(static_cast<uint64_t>(p));
+                    }
+                    SwitchPort::ParameterDefaultValue pdv{};
+                    if (metadata.TryGetParameterDefaultValue(static_cast<int32_t>(p), &pdv) && pdv.dataIndex >= 0) {
+                        const std::string value = FormatDefaultValue(metadata, runtimeTypes, pdv.typeIndex, pdv.dataIndex);
+                        if (!value.empty()) {
+                            out << " = " << value;
+                        }
+                    }
+                }
+            }
+
+            if (isAbstract) {
+                out << ");\n";
+            } else {
+                out << ") { }\n";
+            }
+
+            const auto instantiations = genericInstMethods.ForMethod(i);
+            if (!instantiations.empty()) {
+                out << "\t/* GenericInstMethod :\n";
+                for (const auto* group = instantiations.first; group != instantiations.last;) {
+                    const uint64_t ptr = group->ptr;
+                    const auto* groupEnd = group;
+                    while (groupEnd != instantiations.last && groupEnd->ptr == ptr) {
+                        ++groupEnd;
+                    }
+                    out << "\t|\n";
+                    if (ptr > 0 && elfImage != nullptr) {
+                        uint64_t methodOffset = 0;
+                        if (elfImage->TryMapVaddrToOffset(ptr, &methodOffset)) {
+                            if (index != nullptr) {
+                                index->rvas.emplace_back(ptr, out.Size());
+                                for (const auto* e = group; ctx.collectMethodNames && e != groupEnd; ++e) {
+                                    index->methodNames.emplace_back(index->strings.Copy(genericInstMethods.Line(e->line)),
+                                                                    out.Size());
+                                }
+                            }
+                            out << "\t|-RVA: 0x";
+                            out.AppendHex(ptr) << " Offset: 0x";
+                            out.AppendHex(methodOffset) << " VA: 0x";
+                            out.AppendHex(ptr) << '\n';
+                        } else {
+                            out << "\t|-RVA: -1 Offset: -1\n";
+                        }
+                    } else {
+                        out << "\t|-RVA: -1 Offset: -1\n";
+                    }
+                    for (; group != groupEnd; ++group) {
+                        out << "\t|-" << genericInstMethods.Line(group->line) << "\n";
+                    }
+                }
+                out << "\t*/\n";
+            }
+        }
+    }
+
+    out << "}\n";
+}
+
+// Bytes of rendered dump.cs collected before the batch is handed to the background writer.
+constexpr size_t kDumpWriteBatchBytes = 512u * 1024u;
+// Types are rendered in shards of this many entries when dump.cs is written by several workers.
+constexpr size_t kDumpShardTypes = 256;
+// Rendered shards each worker may run ahead of the writer; bounds the buffered output.
+constexpr size_t kDumpShardsInFlightPerWorker = 4;
+
+// Renders contiguous type ranges on a worker pool and writes them back in metadata order, so the output is
+// byte-identical to the sequential writer. Each worker keeps its own type name cache. baseOffset is the number of
+// bytes already written to out and is used to rebase the shards' index entries.
+bool WriteDumpTypesParallel(SwitchPort::AsyncBufferWriter& out, const DumpContext& ctx, unsigned workerCount, uint64_t baseOffset,
+                            DumpIndex* index, DumpProgressCallback progressCb, void* progressUser, std::string* error) {
+    struct Shard {
+        size_t imageIndex = 0;
+        size_t typeBegin = 0;
+        size_t typeEnd = 0;
+        SwitchPort::TextBuffer text;
+        DumpIndexChunk index;
+        bool ready = false;
+    };
+
+    const auto& metadata = *ctx.metadata;
+    const auto& images = metadata.Images();
+    const size_t totalTypes = metadata.Types().size();
+    std::vector<Shard> shards;
+    for (size_t imageIndex = 0; imageIndex < images.size(); ++imageIndex) {
+        const auto& image = images[imageIndex];
+        const size_t typeStart = static_cast<size_t>(image.typeStart);
+        const size_t typeEnd = typeStart + static_cast<size_t>(image.typeCount);
+        for (size_t begin = typeStart; begin < typeEnd; begin += kDumpShardTypes) {
+            Shard shard;
+            shard.imageIndex = imageIndex;
+            shard.typeBegin = begin;
+            shard.typeEnd = std::min(typeEnd, begin + kDumpShardTypes);
+            shards.push_back(std::move(shard));
+        }
+    }
+
+    const size_t maxInFlight = static_cast<size_t>(workerCount) * kDumpShardsInFlightPerWorker;
+    std::mutex mutex;
+    std::condition_variable shardReady;
+    std::condition_variable shardFlushed;
+    size_t nextShard = 0;
+    size_t flushedShards = 0;
+    bool stop = false;
+    std::exception_ptr workerError;
+
+    auto worker = [&]() {
+        TypeNameCache typeNameCache(totalTypes);
+        AttributeCache attributeCache(totalTypes);
+        for (;;) {
+            size_t shardIndex = 0;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                shardFlushed.wait(lock, [&] { return stop || nextShard >= shards.size() || nextShard < flushedShards + maxInFlight; });
+                if (stop || nextShard >= shards.size()) {
+                    return;
+                }
+                shardIndex = nextShard++;
+            }
+            Shard& shard = shards[shardIndex];
+            SwitchPort::TextBuffer buffer;
+            try {
+                DumpIndexChunk* chunk = (index != nullptr) ? &shard.index : nullptr;
+                for (size_t typeIndex = shard.typeBegin; typeIndex < shard.typeEnd; ++typeIndex) {
+                    WriteDumpType(buffer, ctx, typeNameCache, attributeCache, shard.imageIndex, typeIndex, chunk);
+                }
+                if (chunk != nullptr) {
+                    chunk->lines = CountLines(buffer.View());
+                }
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!workerError) {
+                    workerError = std::current_exception();
+                }
+                stop = true;
+                shardReady.notify_all();
+                shardFlushed.notify_all();
+                return;
+            }
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                shard.text.Swap(buffer);
+                shard.ready = true;
+            }
+            shardReady.notify_all();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(workerCount);
+    for (unsigned i = 0; i < workerCount; ++i) {
+        threads.emplace_back(worker);
+    }
+    auto joinWorkers = [&]() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }
+        shardFlushed.notify_all();
+        for (auto& t : threads) {
+            t.join();
+        }
+    };
+
+    size_t writtenTypes = 0;
+    uint64_t writtenBytes = baseOffset;
+    for (size_t shardIndex = 0; shardIndex < shards.size(); ++shardIndex) {
+        if (Cancellation::Requested()) {
+            joinWorkers();
+            if (error != nullptr) {
+                *error = "Aborted by user (MINUS).";
+            }
+            return false;
+        }
+        SwitchPort::TextBuffer text;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            shardReady.wait(lock, [&] { return shards[shardIndex].ready || workerError != nullptr; });
+            if (!shards[shardIndex].ready) {
+                break;
+            }
+            text.Swap(shards[shardIndex].text);
+            ++flushedShards;
+        }
+        shardFlushed.notify_all();
+        const size_t textSize = text.Size();
+        out.Submit(text);
+        if (index != nullptr && !index->Append(shards[shardIndex].index, writtenBytes, error)) {
+            joinWorkers();
+            return false;
+        }
+        writtenBytes += textSize;
+
+        const size_t before = writtenTypes;
+        writtenTypes += shards[shardIndex].typeEnd - shards[shardIndex].typeBegin;
+        if (progressCb != nullptr && ((before >> 10) != (writtenTypes >> 10) || writtenTypes == totalTypes)) {
+            progressCb("write dump.cs", writtenTypes, totalTypes, progressUser);
+        }
+    }
+    joinWorkers();
+    if (workerError) {
+        std::rethrow_exception(workerError);
+    }
+    return true;
+}
+
+bool RenderDumpCs(SwitchPort::AsyncBufferWriter& out, const SwitchPort::MetadataFile& metadata,
+                  const SwitchPort::RuntimeTypeSystem* runtimeTypes, const SwitchPort::ElfImage* elfImage,
+                  uint64_t codeRegistration, unsigned workerCount, DumpIndex* index, DumpProgressCallback progressCb,
+                  void* progressUser, std::string* error) {
+    const auto& images = metadata.Images();
+    const auto& types = metadata.Types();
+    const auto& nestedTypeIndices = metadata.NestedTypeIndices();
+    MethodPointerResolver methodResolver;
+    const bool hasMethodPointers =
+        (elfImage != nullptr) && methodResolver.Initialize(*elfImage, metadata, static_cast<double>(metadata.Header().version),
+                                                            codeRegistration);
+    TypeNameCache typeNameCache(types.size());
+    NestedParentTable nestedParents(types.size());
+    GenericInstMethodTable genericInstMethods;
+    const size_t totalTypes = types.size();
+    size_t writtenTypes = 0;
+
+    if (progressCb != nullptr) {
+        progressCb("write dump.cs", 0, totalTypes, progressUser);
+    }
+
+    for (size_t parentIndex = 0; parentIndex < types.size(); ++parentIndex) {
+        const auto& type = types[parentIndex];
+        if (type.nestedTypeCount == 0 || type.nestedTypesStart < 0) {
+            continue;
+        }
+        const size_t start = static_cast<size_t>(type.nestedTypesStart);
+        const size_t end = start + static_cast<size_t>(type.nestedTypeCount);
+        for (size_t i = start; i < end && i < nestedTypeIndices.size(); ++i) {
+            const int32_t child = nestedTypeIndices[i];
+            if (child >= 0 && static_cast<size_t>(child) < types.size()) {
+                nestedParents.Set(static_cast<size_t>(child), parentIndex);
+            }
+        }
+    }
+
+    uint64_t writtenBytes = 0;
+    {
+        SwitchPort::TextBuffer imageList;
+        for (size_t imageIndex = 0; imageIndex < images.size(); ++imageIndex) {
+            const auto& image = images[imageIndex];
+            imageList << "// Image ";
+            imageList.AppendDecimal(static_cast<uint64_t>(imageIndex)) << ": " << metadata.GetStringView(image.nameIndex)
+                << " - ";
+            imageList.AppendDecimal(image.typeStart) << '\n';
+        }
+        writtenBytes = imageList.Size();
+        if (index != nullptr) {
+            index->totalDumpLines += CountLines(imageList.View());
+        }
+        out.Submit(imageList);
+    }
+
+    if (runtimeTypes != nullptr && elfImage != nullptr) {
+        SwitchPort::ScopedPhase phase("collect generic instance methods");
+        genericInstMethods.Build(metadata, *runtimeTypes, *elfImage, methodResolver, nestedParents, typeNameCache);
+    }
+
+    DumpContext ctx;
+    ctx.metadata = &metadata;
+    ctx.runtimeTypes = runtimeTypes;
+    ctx.elfImage = elfImage;
+    ctx.methodResolver = &methodResolver;
+    ctx.hasMethodPointers = hasMethodPointers;
+    ctx.nestedParents = &nestedParents;
+    ctx.genericInstMethods = &genericInstMethods;
+    const AttributeTokenIndex attributeTokens(metadata);
+    ctx.attributeTokens = &attributeTokens;
+    ctx.collectMethodNames = index != nullptr && index->collectMethodNames;
+
+    SwitchPort::ScopedPhase renderPhase("render types");
+    if (workerCount > 1) {
+        return WriteDumpTypesParallel(out, ctx, workerCount, writtenBytes, index, progressCb, progressUser, error);
+    }
+
+    AttributeCache attributeCache(types.size());
+
+    // Types accumulate in batch until it holds kDumpWriteBatchBytes; its index entries are relative to the batch.
+    SwitchPort::TextBuffer batch;
+    batch.Reserve(kDumpWriteBatchBytes + kDumpWriteBatchBytes / 4);
+    DumpIndexChunk chunk;
+    auto flushBatch = [&]() {
+        if (index != nullptr) {
+            chunk.lines = CountLines(batch.View());
+            if (!index->Append(chunk, writtenBytes, error)) {
+                return false;
+            }
+        }
+        writtenBytes += batch.Size();
+        out.Submit(batch);
+        return true;
+    };
+
+    for (size_t imageIndex = 0; imageIndex < images.size(); ++imageIndex) {
+        const auto& image = images[imageIndex];
+        if (Cancellation::Requested()) {
+            if (error != nullptr) {
+                *error = "Aborted by user (MINUS).";
+            }
+            return false;
+        }
+
+        const size_t typeStart = static_cast<size_t>(image.typeStart);
+        const size_t typeEnd = typeStart + static_cast<size_t>(image.typeCount);
+
+        for (size_t typeIndex = typeStart; typeIndex < typeEnd; ++typeIndex) {
+            if (Cancellation::Requested()) {
+                if (error != nullptr) {
+                    *error = "Aborted by user (MINUS).";
+                }
+                return false;
+            }
+
+            WriteDumpType(batch, ctx, typeNameCache, attributeCache, imageIndex, typeIndex,
+                          (index != nullptr) ? &chunk : nullptr);
+            if (batch.Size() >= kDumpWriteBatchBytes && !flushBatch()) {
+                return false;
+            }
+            ++writtenTypes;
+            if (progressCb != nullptr && ((writtenTypes & 0x3ffu) == 0 || writtenTypes == totalTypes)) {
+                progressCb("write dump.cs", writtenTypes, totalTypes, progressUser);
+            }
+        }
+    }
+
+    return flushBatch();
+}
+
+// Rebuilds the auxiliary index data by rescanning an existing dump.cs. Dumps written by WriteDumpCs collect the
+// same data while rendering; this path remains for dump.cs files produced by other tools.
+bool ScanDumpForIndex(const std::string& dumpPath, DumpIndex* index, std::string* error) {
+    std::ifstream in(dumpPath, std::ios::binary);
+    if (!in) {
+        if (error != nullptr) {
+            *error = "Failed to open dump.cs for indexing: " + dumpPath;
+        }
+        return false;
+    }
+
+    constexpr std::string_view kNamespacePrefix = "// Namespace:";
+    constexpr std::string_view kPublicPrefix = "public ";
+    auto& strings = index->strings;
+    std::string_view currentNamespace;
+    // Method index state: the enclosing type, and the RVA line whose method or generic instance names follow.
+    std::string_view currentTypeFullName;
+    std::optional<uint32_t> methodRvaOffset;
+    std::optional<uint32_t> genericRvaOffset;
+
+    // Lines are handled as views into the read block; only candidate lines are copied for the extractors.
+    auto processLine = [&](std::string_view line, uint64_t offset) -> bool {
+        ++index->totalDumpLines;
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        const std::string_view trimmed = TrimView(line);
+
+        if (StartsWith(trimmed, kNamespacePrefix)) {
+            if (offset <= std::numeric_limits<uint32_t>::max()) {
+                index->namespaceOffsets.push_back(static_cast<uint32_t>(offset));
+            }
+            currentNamespace = strings.Copy(TrimView(trimmed.substr(kNamespacePrefix.size())));
+        }
+
+        if (StartsWith(trimmed, kPublicPrefix)) {
+            std::string_view word;
+            if (TryExtractPublicDefinitionWord(trimmed, &word)) {
+                index->definitions.emplace_back(strings.Copy(word), offset);
+            }
+        }
+
+        if (trimmed.find("TypeDefIndex:") != std::string_view::npos) {
+            TypeInfoRecord typeInfo{};
+            currentTypeFullName = {};
+            if (TryExtractTypeInfo(trimmed, currentNamespace, strings, &typeInfo)) {
+                typeInfo.offset = offset;
+                currentTypeFullName = typeInfo.fullName;
+                index->typeInfos.push_back(typeInfo);
+            }
+        }
+
+        if (line.empty() || line[0] != '\t') {
+            methodRvaOffset.reset();
+            genericRvaOffset.reset();
+            return true;
+        }
+        if (methodRvaOffset.has_value()) {
+            const std::string_view methodName = ExtractDeclaredMethodName(line);
+            if (!methodName.empty() && index->collectMethodNames) {
+                index->methodNames.emplace_back(QualifyName(currentTypeFullName, methodName, strings), *methodRvaOffset);
+            }
+            methodRvaOffset.reset();
+        }
+        uint64_t rva = 0;
+        if (TryParseHexAfterPrefix(line, "\t// RVA: 0x", &rva)) {
+            methodRvaOffset = static_cast<uint32_t>(offset);
+            return index->AddRva(rva, offset, error);
+        }
+        if (TryParseHexAfterPrefix(line, "\t|-RVA: 0x", &rva)) {
+            genericRvaOffset = static_cast<uint32_t>(offset);
+            return index->AddRva(rva, offset, error);
+        }
+        if (StartsWith(line, "\t|-RVA:") || StartsWith(line, "\t*/")) {
+            genericRvaOffset.reset();
+        } else if (genericRvaOffset.has_value() && index->collectMethodNames && StartsWith(line, "\t|-")) {
+            index->methodNames.emplace_back(strings.Copy(line.substr(3)), *genericRvaOffset);
+        }
+        return true;
+    };
+
+    std::vector<char> block(kDumpScanBlockBytes);
+    std::string carry; // partial line continued from the previous block
+    uint64_t blockOffset = 0;
+    uint64_t lineStartOffset = 0;
+    for (;;) {
+        in.read(block.data(), static_cast<std::streamsize>(block.size()));
+        const size_t got = static_cast<size_t>(in.gcount());
+        if (got == 0) {
+            break;
+        }
+        if (Cancellation::Requested()) {
+            if (error != nullptr) {
+                *error = "Aborted by user (MINUS).";
+            }
+            return false;
+        }
+        const char* cursor = block.data();
+        const char* const end = cursor + got;
+        while (cursor < end) {
+            const char* newline = static_cast<const char*>(std::memchr(cursor, '\n', static_cast<size_t>(end - cursor)));
+            if (newline == nullptr) {
+                carry.append(cursor, end);
+                break;
+            }
+            bool ok = false;
+            if (carry.empty()) {
+                ok = processLine(std::string_view(cursor, static_cast<size_t>(newline - cursor)), lineStartOffset);
+            } else {
+                carry.append(cursor, newline);
+                ok = processLine(carry, lineStartOffset);
+                carry.clear();
+            }
+            if (!ok) {
+                return false;
+            }
+            lineStartOffset = blockOffset + static_cast<uint64_t>(newline - block.data()) + 1;
+            cursor = newline + 1;
+        }
+        blockOffset += got;
+    }
+    if (!carry.empty()) {
+        if (!processLine(carry, lineStartOffset)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+bool DumpIndex::AddRva(uint64_t rva, uint64_t offset, std::string* error) {
+    if (offset > std::numeric_limits<uint32_t>::max()) {
+        if (error != nullptr) {
+            *error = "dump.cs is larger than supported 32-bit offset range";
+        }
+        return false;
+    }
+    rvaRecords.push_back({rva, static_cast<uint32_t>(offset)});
+    return true;
+}
+
+bool DumpIndex::Append(DumpIndexChunk& chunk, uint64_t baseOffset, std::string* error) {
+    for (uint64_t off : chunk.namespaceOffsets) {
+        if (baseOffset + off <= std::numeric_limits<uint32_t>::max()) {
+            namespaceOffsets.push_back(static_cast<uint32_t>(baseOffset + off));
+        }
+    }
+    // The chunk's names stay where they are; only the blocks holding them change owner.
+    strings.Adopt(chunk.strings);
+    for (const auto& [word, off] : chunk.definitions) {
+        definitions.emplace_back(word, baseOffset + off);
+    }
+    for (auto info : chunk.typeInfos) {
+        info.offset += baseOffset;
+        typeInfos.push_back(info);
+    }
+    for (const auto& [rva, off] : chunk.rvas) {
+        if (!AddRva(rva, baseOffset + off, error)) {
+            return false;
+        }
+    }
+    // AddRva has rejected offsets beyond 32 bits by now, and every name belongs to an RVA line.
+    for (const auto& [name, off] : chunk.methodNames) {
+        methodNames.emplace_back(name, static_cast<uint32_t>(baseOffset + off));
+    }
+    totalDumpLines += chunk.lines;
+    chunk.Clear();
+    return true;
+}
+
+DumpSignature GetDumpSignature(const std::string& dumpPath) {
+    DumpSignature sig{};
+    struct stat st {};
+    if (stat(dumpPath.c_str(), &st) == 0) {
+        if (st.st_size > 0) {
+            sig.size = static_cast<uint64_t>(st.st_size);
+        }
+        if (st.st_mtime > 0) {
+            sig.mtime = static_cast<uint64_t>(st.st_mtime);
+        }
+    }
+    return sig;
+}
+
+unsigned DefaultDumpWorkerCount() {
+#ifdef __SWITCH__
+    // Keep the console build single-threaded: applet memory cannot hold many rendered shards.
+    return 1;
+#else
+    const unsigned hw = std::thread::hardware_concurrency();
+    return std::max(1u, std::min(hw, 16u));
+#endif
+}
+
+bool WriteDumpCs(const SwitchPort::MetadataFile& metadata, const SwitchPort::RuntimeTypeSystem* runtimeTypes,
+                 const SwitchPort::ElfImage* elfImage, uint64_t codeRegistration, const std::string& outputPath,
+                 unsigned workerCount, DumpIndex* index, DumpProgressCallback progressCb, void* progressUser,
+                 std::string* error) {
+    if (Cancellation::Requested()) {
+        if (error != nullptr) {
+            *error = "Aborted by user (MINUS).";
+        }
+        return false;
+    }
+
+    std::ofstream stream(outputPath, std::ios::binary | std::ios::trunc);
+    if (!stream) {
+        if (error != nullptr) {
+            *error = "Failed to open output file: " + outputPath;
+        }
+        return false;
+    }
+    bool rendered = false;
+    {
+        SwitchPort::AsyncBufferWriter out(stream);
+        rendered = RenderDumpCs(out, metadata, runtimeTypes, elfImage, codeRegistration, workerCount, index, progressCb,
+                                progressUser, error);
+        // Stream failures are picked up from the ofstream state below.
+        out.Finish();
+    }
+    if (!rendered) {
+        return false;
+    }
+    stream.flush();
+    if (!stream) {
+        if (error != nullptr) {
+            *error = "Failed to write output file: " + outputPath;
+        }
+        return false;
+    }
+    Profiler::Count(ProfileCounter::DumpBytesRendered, static_cast<uint64_t>(stream.tellp()));
+    return true;
+}
+
+bool WriteDumpAuxiliaryFiles(DumpIndex& index, const std::string& dumpPath, const std::string& index1Path,
+                             const std::string& index2Path, const std::string& definitionCachePath,
+                             const std::string& definitionIndexPath, const std::string& namespaceOffsetsPath,
+                             const std::string& typeIndexPath, const std::string& typeIndex3Path, std::string* error) {
+    auto& definitions = index.definitions;
+    auto& namespaceOffsets = index.namespaceOffsets;
+    auto& typeInfos = index.typeInfos;
+    auto& rvaRecords = index.rvaRecords;
+    const uint32_t totalDumpLines = index.totalDumpLines;
+
+    std::sort(namespaceOffsets.begin(), namespaceOffsets.end());
+    namespaceOffsets.erase(std::unique(namespaceOffsets.begin(), namespaceOffsets.end()), namespaceOffsets.end());
+
+    std::sort(typeInfos.begin(), typeInfos.end(), [](const TypeInfoRecord& a, const TypeInfoRecord& b) { return a.offset < b.offset; });
+
+    // Name then offset order, without repeats: both definition caches are written from this one flat run.
+    std::sort(definitions.begin(), definitions.end());
+    definitions.erase(std::unique(definitions.begin(), definitions.end()), definitions.end());
+
+    const DumpSignature sig = GetDumpSignature(dumpPath);
+
+    {
+        std::ofstream out(definitionCachePath, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            if (error != nullptr) {
+                *error = "Failed to write " + definitionCachePath;
+            }
+            return false;
+        }
+        out << "v2\t" << std::uppercase << std::hex << sig.size << "\t" << sig.mtime << std::nouppercase << std::dec << "\n";
+        for (const auto& [name, off] : definitions) {
+            out << "D\t" << name << "\t" << std::uppercase << std::hex << off << std::nouppercase << std::dec << "\n";
+        }
+    }
+
+    if (!WriteDefinitionCache(definitionIndexPath, definitions, sig.size, sig.mtime, error)) {
+        return false;
+    }
+
+    {
+        constexpr uint32_t kNamespaceIndexMagic = 0x3153494Eu; // "NIS1"
+        std::ofstream out(namespaceOffsetsPath, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            if (error != nullptr) {
+                *error = "Failed to write " + namespaceOffsetsPath;
+            }
+            return false;
+        }
+        const uint32_t dumpSize32 = static_cast<uint32_t>(std::min<uint64_t>(sig.size, std::numeric_limits<uint32_t>::max()));
+        const uint32_t dumpMtime32 = static_cast<uint32_t>(std::min<uint64_t>(sig.mtime, std::numeric_limits<uint32_t>::max()));
+        const uint32_t count = static_cast<uint32_t>(namespaceOffsets.size());
+        WriteBinary(out, kNamespaceIndexMagic);
+        WriteBinary(out, dumpSize32);
+        WriteBinary(out, dumpMtime32);
+        WriteBinary(out, count);
+        for (uint32_t off : namespaceOffsets) {
+            WriteBinary(out, off);
+        }
+    }
+
+    {
+        constexpr uint32_t kTypeIndexMagic = 0x32595054u; // "TYP2"
+        std::ofstream out(typeIndexPath, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            if (error != nullptr) {
+                *error = "Failed to write " + typeIndexPath;
+            }
+            return false;
+        }
+        const uint32_t dumpSize32 = static_cast<uint32_t>(std::min<uint64_t>(sig.size, std::numeric_limits<uint32_t>::max()));
+        const uint32_t dumpMtime32 = static_cast<uint32_t>(std::min<uint64_t>(sig.mtime, std::numeric_limits<uint32_t>::max()));
+        const uint32_t count = static_cast<uint32_t>(typeInfos.size());
+        WriteBinary(out, kTypeIndexMagic);
+        WriteBinary(out, dumpSize32);
+        WriteBinary(out, dumpMtime32);
+        WriteBinary(out, count);
+        for (const auto& t : typeInfos) {
+            const uint32_t off32 = static_cast<uint32_t>(std::min<uint64_t>(t.offset, std::numeric_limits<uint32_t>::max()));
+            WriteBinary(out, off32);
+            WriteLengthPrefixedString(out, t.typeName);
+            WriteLengthPrefixedString(out, t.fullName);
+            WriteLengthPrefixedString(out, t.baseName);
+            WriteLengthPrefixedString(out, t.namespaceName);
+        }
+    }
+
+    if (!WriteTypeIndex(typeIndex3Path, typeInfos, sig.size, sig.mtime, error)) {
+        return false;
+    }
+
+    std::sort(rvaRecords.begin(), rvaRecords.end(), [](const RvaRecord& a, const RvaRecord& b) {
+        if (a.rva != b.rva) {
+            return a.rva < b.rva;
+        }
+        return a.dumpOffset < b.dumpOffset;
+    });
+
+    constexpr uint16_t kIndexVersion = 3;
+
+    struct Index2BlockRecord {
+        uint32_t addrDelta = 0;
+        uint32_t dumpOffset = 0;
+    };
+    struct Index2Block {
+        uint64_t startRva = 0;
+        uint32_t startDumpOffset = 0;
+        std::vector<Index2BlockRecord> records;
+    };
+    std::vector<Index2Block> blocks;
+    blocks.reserve((rvaRecords.size() / 1024u) + 1u);
+
+    size_t i = 0;
+    while (i < rvaRecords.size()) {
+        Index2Block block{};
+        block.startRva = rvaRecords[i].rva;
+        block.startDumpOffset = rvaRecords[i].dumpOffset;
+        block.records.push_back({0, rvaRecords[i].dumpOffset});
+        ++i;
+        uint64_t prevRva = block.startRva;
+        while (i < rvaRecords.size() && block.records.size() < 1024u) {
+            const uint64_t delta64 = rvaRecords[i].rva - prevRva;
+            if (delta64 > std::numeric_limits<uint32_t>::max()) {
+                break;
+            }
+            block.records.push_back({static_cast<uint32_t>(delta64), rvaRecords[i].dumpOffset});
+            prevRva = rvaRecords[i].rva;
+            ++i;
+        }
+        blocks.push_back(std::move(block));
+    }
+
+    // Reverse section: every record again as {u32 dump offset, u64 RVA}, in dump offset order.
+    std::vector<RvaRecord> offsetRecords(rvaRecords);
+    std::sort(offsetRecords.begin(), offsetRecords.end(), [](const RvaRecord& a, const RvaRecord& b) {
+        if (a.dumpOffset != b.dumpOffset) {
+            return a.dumpOffset < b.dumpOffset;
+        }
+        return a.rva < b.rva;
+    });
+
+    // Method name section (only when index.collectMethodNames), laid out like DEF1: hash buckets over entries sorted
+    // by hash, each entry naming a run of refs (positions in the reverse section).
+    auto& methodNames = index.methodNames;
+    std::sort(methodNames.begin(), methodNames.end());
+    methodNames.erase(std::unique(methodNames.begin(), methodNames.end()), methodNames.end());
+    struct MethodNameRun {
+        uint64_t hash = 0;
+        size_t first = 0; // into methodNames
+        size_t count = 0;
+    };
+    std::vector<MethodNameRun> nameRuns;
+    for (size_t n = 0; n < methodNames.size();) {
+        size_t end = n + 1;
+        while (end < methodNames.size() && methodNames[end].first == methodNames[n].first) {
+            ++end;
+        }
+        nameRuns.push_back({DefinitionCache::HashName(methodNames[n].first), n, end - n});
+        n = end;
+    }
+    std::stable_sort(nameRuns.begin(), nameRuns.end(),
+                     [](const MethodNameRun& a, const MethodNameRun& b) { return a.hash < b.hash; });
+    uint32_t nameBucketBits = 0;
+    while (nameBucketBits < 24 && (size_t{1} << nameBucketBits) < nameRuns.size()) {
+        ++nameBucketBits;
+    }
+    const auto nameBucketOf = [nameBucketBits](uint64_t hash) {
+        return nameBucketBits == 0 ? 0u : static_cast<uint32_t>(hash >> (64 - nameBucketBits));
+    };
+    std::vector<uint32_t> nameBucketStarts((size_t{1} << nameBucketBits) + 1, 0);
+    std::vector<uint32_t> nameRefs;
+    nameRefs.reserve(methodNames.size());
+    std::vector<std::pair<uint32_t, uint32_t>> nameRefRanges; // {first ref, count} per run
+    nameRefRanges.reserve(nameRuns.size());
+    std::vector<uint32_t> nameStringOffsets;
+    nameStringOffsets.reserve(nameRuns.size());
+    std::string nameStrings;
+    for (const MethodNameRun& run : nameRuns) {
+        nameStringOffsets.push_back(static_cast<uint32_t>(nameStrings.size()));
+        nameStrings += methodNames[run.first].first;
+        const uint32_t firstRef = static_cast<uint32_t>(nameRefs.size());
+        for (size_t n = run.first; n < run.first + run.count; ++n) {
+            const uint32_t offset = methodNames[n].second;
+            const auto it = std::lower_bound(offsetRecords.begin(), offsetRecords.end(), offset,
+                                             [](const RvaRecord& r, uint32_t value) { return r.dumpOffset < value; });
+            if (it != offsetRecords.end() && it->dumpOffset == offset) {
+                nameRefs.push_back(static_cast<uint32_t>(it - offsetRecords.begin()));
+            }
+        }
+        nameRefRanges.emplace_back(firstRef, static_cast<uint32_t>(nameRefs.size()) - firstRef);
+        ++nameBucketStarts[nameBucketOf(run.hash) + 1];
+    }
+    std::partial_sum(nameBucketStarts.begin(), nameBucketStarts.end(), nameBucketStarts.begin());
+
+    struct Index1Entry {
+        uint64_t startRva = 0;
+        uint64_t index2Offset = 0;
+        uint32_t index2Size = 0;
+    };
+    std::vector<Index1Entry> index1Entries;
+    index1Entries.reserve(blocks.size());
+
+    {
+        std::ofstream out(index2Path, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            if (error != nullptr) {
+                *error = "Failed to write " + index2Path;
+            }
+            return false;
+        }
+        out.write("IDX2", 4);
+        WriteBinary(out, kIndexVersion);
+        WriteBinary(out, static_cast<uint16_t>(0));
+        WriteBinary(out, static_cast<uint32_t>(blocks.size()));
+        WriteBinary(out, totalDumpLines);
+        for (const auto& block : blocks) {
+            const uint64_t blockOffset = static_cast<uint64_t>(out.tellp());
+            WriteBinary(out, block.startRva);
+            WriteBinary(out, block.startDumpOffset);
+            WriteBinary(out, static_cast<uint32_t>(block.records.size()));
+            for (const auto& rec : block.records) {
+                WriteBinary(out, rec.addrDelta);
+                WriteBinary(out, rec.dumpOffset);
+            }
+            const uint64_t blockEnd = static_cast<uint64_t>(out.tellp());
+            Index1Entry e{};
+            e.startRva = block.startRva;
+            e.index2Offset = blockOffset;
+            e.index2Size = static_cast<uint32_t>(blockEnd - blockOffset);
+            index1Entries.push_back(e);
+        }
+
+        // Everything above is the plain v3 file. The reverse and method name sections follow the last block and
+        // are found through a trailer at the very end, which v3 readers never reach: u64 offsetsAt,
+        // u32 offsetCount, u32 nameBucketBits, u64 namesAt (0 without a name table), u32 nameCount,
+        // u32 nameRefCount, u32 nameStringBytes, u32 reserved, u32 trailer size, "IDXR".
+        const uint64_t offsetsAt = static_cast<uint64_t>(out.tellp());
+        for (const auto& rec : offsetRecords) {
+            WriteBinary(out, rec.dumpOffset);
+            WriteBinary(out, rec.rva);
+        }
+        uint64_t namesAt = 0;
+        if (index.collectMethodNames) {
+            namesAt = static_cast<uint64_t>(out.tellp());
+            for (const uint32_t start : nameBucketStarts) {
+                WriteBinary(out, start);
+            }
+            for (size_t r = 0; r < nameRuns.size(); ++r) {
+                WriteBinary(out, nameRuns[r].hash);
+                WriteBinary(out, nameStringOffsets[r]);
+                WriteBinary(out, static_cast<uint32_t>(methodNames[nameRuns[r].first].first.size()));
+                WriteBinary(out, nameRefRanges[r].first);
+                WriteBinary(out, nameRefRanges[r].second);
+            }
+            for (const uint32_t ref : nameRefs) {
+                WriteBinary(out, ref);
+            }
+            out.write(nameStrings.data(), static_cast<std::streamsize>(nameStrings.size()));
+        }
+        constexpr uint32_t kIndex2TrailerSize = 48;
+        WriteBinary(out, offsetsAt);
+        WriteBinary(out, static_cast<uint32_t>(offsetRecords.size()));
+        WriteBinary(out, namesAt != 0 ? nameBucketBits : 0u);
+        WriteBinary(out, namesAt);
+        WriteBinary(out, namesAt != 0 ? static_cast<uint32_t>(nameRuns.size()) : 0u);
+        WriteBinary(out, namesAt != 0 ? static_cast<uint32_t>(nameRefs.size()) : 0u);
+        WriteBinary(out, namesAt != 0 ? static_cast<uint32_t>(nameStrings.size()) : 0u);
+        WriteBinary(out, static_cast<uint32_t>(0));
+        WriteBinary(out, kIndex2TrailerSize);
+        out.write("IDXR", 4);
+        if (!out) {
+            if (error != nullptr) {
+                *error = "Failed to write " + index2Path;
+            }
+            return false;
+        }
+    }
+
+    {
+        std::ofstream out(index1Path, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            if (error != nullptr) {
+                *error = "Failed to write " + index1Path;
+            }
+            return false;
+        }
+        out.write("IDX1", 4);
+        WriteBinary(out, kIndexVersion);
+        WriteBinary(out, static_cast<uint16_t>(0));
+        WriteBinary(out, static_cast<uint32_t>(index1Entries.size()));
+        for (const auto& e : index1Entries) {
+            WriteBinary(out, e.startRva);
+            WriteBinary(out, e.index2Offset);
+            WriteBinary(out, e.index2Size);
+            WriteBinary(out, static_cast<uint32_t>(0));
+        }
+    }
+
+    return true;
+}
+
+bool BuildDumpAuxiliaryFiles(const std::string& dumpPath, const std::string& index1Path, const std::string& index2Path,
+                             const std::string& definitionCachePath, const std::string& definitionIndexPath,
+                             const std::string& namespaceOffsetsPath, const std::string& typeIndexPath,
+                             const std::string& typeIndex3Path, bool withMethodNames, std::string* error) {
+    DumpIndex index;
+    index.collectMethodNames = withMethodNames;
+    if (!ScanDumpForIndex(dumpPath, &index, error)) {
+        return false;
+    }
+    return WriteDumpAuxiliaryFiles(index, dumpPath, index1Path, index2Path, definitionCachePath, definitionIndexPath,
+                                   namespaceOffsetsPath, typeIndexPath, typeIndex3Path, error);
+}
+
+} // namespace SwitchPort
@@ -1,10 +1,13 @@
 #include "SwitchPort/ElfImage.h"
 
 #include <algorithm>
-#include <fstream>
+#include <cstring>
 #include <limits>
 #include <new>
 #include <string>
+#include <utility>
+
+#include "SwitchPort/Profiler.h"
 
 namespace SwitchPort {
 
@@ -59,62 +62,40 @@ bool AddOverflowU64(uint64_t a, uint64_t b, uint64_t* out) {
     return false;
 }
 
-bool ReadFile(const std::string& path, std::vector<uint8_t>* out, std::string* error) {
-    std::ifstream in(path, std::ios::binary);
-    if (!in) {
-        if (error != nullptr) {
-            *error = "Failed to open ELF file: " + path;
-        }
-        return false;
-    }
-    in.seekg(0, std::ios::end);
-    const std::streamoff size = in.tellg();
-    if (size < 0) {
-        if (error != nullptr) {
-            *error = "Failed to query ELF file size: " + path;
-        }
-        return false;
-    }
-    if (static_cast<uint64_t>(size) > kMaxElfFileBytes) {
-        if (error != nullptr) {
-            *error = "ELF file is too large: " + std::to_string(static_cast<unsigned long long>(size)) + " bytes";
-        }
-        return false;
-    }
-    in.seekg(0, std::ios::beg);
+} // namespace
+
+bool ElfImage::Load(const std::string& path, std::string* error) {
+    Reset();
     try {
-        out->resize(static_cast<size_t>(size));
+        if (!data_.Open(path, kMaxElfFileBytes, "ELF file", error)) {
+            return false;
+        }
     } catch (const std::bad_alloc&) {
         if (error != nullptr) {
             *error = "Out of memory while reading ELF file";
         }
         return false;
     }
-    if (size == 0) {
-        return true;
-    }
-    in.read(reinterpret_cast<char*>(out->data()), size);
-    if (!in.good()) {
-        if (error != nullptr) {
-            *error = "Failed to read ELF file contents: " + path;
-        }
-        return false;
-    }
-    return true;
+    return Parse(error);
 }
 
-} // namespace
+bool ElfImage::LoadFromMemory(std::vector<uint8_t>&& bytes, std::string* error) {
+    Reset();
+    data_.Adopt(std::move(bytes));
+    return Parse(error);
+}
 
-bool ElfImage::Load(const std::string& path, std::string* error) {
+void ElfImage::Reset() {
     segments_.clear();
-    data_.clear();
+    vaddrRanges_.clear();
+    lastHit_.store(0, std::memory_order_relaxed);
+    data_.Reset();
     is64Bit_ = false;
     isLittleEndian_ = false;
+}
 
+bool ElfImage::Parse(std::string* error) {
     try {
-        if (!ReadFile(path, &data_, error)) {
-            return false;
-        }
     if (data_.size() < 64) {
         if (error) {
             *error = "ELF file is too small";
@@ -200,6 +181,7 @@ bool ElfImage::Load(const std::string& path, std::string* error) {
         }
         return false;
     }
+    BuildVaddrRanges();
 
     uint64_t dynamicEnd = 0;
     if (dynamicSize >= 16 && !AddOverflowU64(dynamicOffset, dynamicSize, &dynamicEnd) && dynamicEnd <= data_.size()) {
@@ -338,7 +320,7 @@ bool ElfImage::Load(const std::string& path, std::string* error) {
                     if (!TryMapVaddrToOffset(r_offset, &writeOff) || writeOff + 8 > data_.size()) {
                         continue;
                     }
-                    WriteLe64(data_.data() + writeOff, value);
+                    WriteLe64(data_.MutableData() + writeOff, value);
                 }
             }
         }
@@ -353,19 +335,80 @@ bool ElfImage::Load(const std::string& path, std::string* error) {
     }
 }
 
-bool ElfImage::TryMapVaddrToOffset(uint64_t vaddr, uint64_t* outOffset) const {
+void ElfImage::BuildVaddrRanges() {
+    vaddrRanges_.clear();
+    std::vector<uint64_t> bounds;
+    bounds.reserve(segments_.size() * 2);
     for (const auto& seg : segments_) {
-        if (vaddr < seg.vaddr || vaddr >= seg.vaddr + seg.memsz) {
+        if (seg.memsz == 0) {
             continue;
         }
-        const uint64_t delta = vaddr - seg.vaddr;
-        if (delta >= seg.filesz) {
-            return false;
+        bounds.push_back(seg.vaddr);
+        bounds.push_back(SegmentVaddrEnd(seg));
+    }
+    std::sort(bounds.begin(), bounds.end());
+    bounds.erase(std::unique(bounds.begin(), bounds.end()), bounds.end());
+
+    // Split the address space at every segment edge; each piece belongs to the first segment covering it,
+    // which is the one the program-header order would have found.
+    for (size_t i = 0; i + 1 < bounds.size(); ++i) {
+        const uint64_t begin = bounds[i];
+        const uint64_t end = bounds[i + 1];
+        for (size_t s = 0; s < segments_.size(); ++s) {
+            const Segment& seg = segments_[s];
+            if (seg.memsz == 0 || begin < seg.vaddr || begin >= SegmentVaddrEnd(seg)) {
+                continue;
+            }
+            if (!vaddrRanges_.empty() && vaddrRanges_.back().segment == s && vaddrRanges_.back().end == begin) {
+                vaddrRanges_.back().end = end;
+            } else {
+                vaddrRanges_.push_back({begin, end, s});
+            }
+            break;
         }
-        *outOffset = seg.fileOffset + delta;
-        return true;
     }
-    return false;
+}
+
+uint64_t ElfImage::SegmentVaddrEnd(const Segment& seg) {
+    uint64_t end = 0;
+    return AddOverflowU64(seg.vaddr, seg.memsz, &end) ? std::numeric_limits<uint64_t>::max() : end;
+}
+
+const ElfImage::Segment* ElfImage::FindSegmentForVaddr(uint64_t vaddr) const {
+    // Lookups cluster heavily (table walks, string reads), so try the last hit before searching.
+    const size_t lastHit = lastHit_.load(std::memory_order_relaxed);
+    if (lastHit < vaddrRanges_.size()) {
+        const VaddrRange& r = vaddrRanges_[lastHit];
+        if (vaddr >= r.begin && vaddr < r.end) {
+            return &segments_[r.segment];
+        }
+    }
+    // Only searches are counted, which keeps the counter off the hit path.
+    Profiler::Count(ProfileCounter::ElfVaddrSearches);
+    const auto it = std::upper_bound(vaddrRanges_.begin(), vaddrRanges_.end(), vaddr,
+                                     [](uint64_t value, const VaddrRange& r) { return value < r.begin; });
+    if (it == vaddrRanges_.begin()) {
+        return nullptr;
+    }
+    const VaddrRange& r = *(it - 1);
+    if (vaddr >= r.end) {
+        return nullptr;
+    }
+    lastHit_.store(static_cast<size_t>(std::distance(vaddrRanges_.begin(), it) - 1), std::memory_order_relaxed);
+    return &segments_[r.segment];
+}
+
+bool ElfImage::TryMapVaddrToOffset(uint64_t vaddr, uint64_t* outOffset) const {
+    const Segment* seg = FindSegmentForVaddr(vaddr);
+    if (seg == nullptr) {
+        return false;
+    }
+    const uint64_t delta = vaddr - seg->vaddr;
+    if (delta >= seg->filesz) {
+        return false;
+    }
+    *outOffset = seg->fileOffset + delta;
+    return true;
 }
 
 bool ElfImage::TryMapOffsetToVaddr(uint64_t offset, uint64_t* outVaddr) const {
@@ -379,51 +422,110 @@ bool ElfImage::TryMapOffsetToVaddr(uint64_t offset, uint64_t* outVaddr) const {
     return false;
 }
 
-bool ElfImage::ReadBytesAtVaddr(uint64_t vaddr, size_t size, std::vector<uint8_t>* out) const {
+const uint8_t* ElfImage::ViewBytesAtVaddr(uint64_t vaddr, size_t size) const {
     uint64_t fileOffset = 0;
     if (!TryMapVaddrToOffset(vaddr, &fileOffset)) {
-        return false;
+        return nullptr;
     }
-    if (fileOffset + size > data_.size()) {
+    return ViewBytesAtOffset(fileOffset, size);
+}
+
+const uint8_t* ElfImage::ViewBytesAtOffset(uint64_t offset, size_t size) const {
+    uint64_t end = 0;
+    if (AddOverflowU64(offset, size, &end) || end > data_.size()) {
+        return nullptr;
+    }
+    return data_.data() + offset;
+}
+
+bool ElfImage::ReadBytesAtVaddr(uint64_t vaddr, size_t size, std::vector<uint8_t>* out) const {
+    const uint8_t* p = ViewBytesAtVaddr(vaddr, size);
+    if (p == nullptr) {
         return false;
     }
-    out->assign(data_.begin() + static_cast<ptrdiff_t>(fileOffset),
-                data_.begin() + static_cast<ptrdiff_t>(fileOffset + size));
+    out->assign(p, p + size);
     return true;
 }
 
 bool ElfImage::ReadBytesAtOffset(uint64_t offset, size_t size, std::vector<uint8_t>* out) const {
-    if (offset + size > data_.size()) {
+    const uint8_t* p = ViewBytesAtOffset(offset, size);
+    if (p == nullptr) {
         return false;
     }
-    out->assign(data_.begin() + static_cast<ptrdiff_t>(offset), data_.begin() + static_cast<ptrdiff_t>(offset + size));
+    out->assign(p, p + size);
     return true;
 }
 
+const uint8_t* ElfImage::ViewTableAtVaddr(uint64_t vaddr, uint64_t count, uint64_t stride) const {
+    const Segment* seg = FindSegmentForVaddr(vaddr);
+    if (seg == nullptr || stride == 0 || count > std::numeric_limits<uint64_t>::max() / stride) {
+        return nullptr;
+    }
+    // The whole table must sit in this segment's file bytes; element-wise reads could otherwise cross segments.
+    const uint64_t delta = vaddr - seg->vaddr;
+    const uint64_t bytes = count * stride;
+    if (delta > seg->filesz || bytes > seg->filesz - delta || bytes > std::numeric_limits<size_t>::max()) {
+        return nullptr;
+    }
+    return data_.data() + seg->fileOffset + delta;
+}
+
+bool ElfImage::ReadU64ArrayAtVaddr(uint64_t vaddr, size_t count, std::vector<uint64_t>* out) const {
+    out->assign(count, 0);
+    const uint8_t* p = ViewTableAtVaddr(vaddr, count, 8);
+    if (p != nullptr) {
+        for (size_t i = 0; i < count; ++i) {
+            (*out)[i] = ReadLe64(p + i * 8);
+        }
+        return true;
+    }
+    bool ok = true;
+    for (size_t i = 0; i < count; ++i) {
+        ok = ReadU64AtVaddr(vaddr + static_cast<uint64_t>(i) * 8, &(*out)[i]) && ok;
+    }
+    return ok;
+}
+
+bool ElfImage::ReadU32ArrayAtVaddr(uint64_t vaddr, size_t count, std::vector<uint32_t>* out) const {
+    out->assign(count, 0);
+    const uint8_t* p = ViewTableAtVaddr(vaddr, count, 4);
+    if (p != nullptr) {
+        for (size_t i = 0; i < count; ++i) {
+            (*out)[i] = ReadLe32(p + i * 4);
+        }
+        return true;
+    }
+    bool ok = true;
+    for (size_t i = 0; i < count; ++i) {
+        ok = ReadU32AtVaddr(vaddr + static_cast<uint64_t>(i) * 4, &(*out)[i]) && ok;
+    }
+    return ok;
+}
+
 bool ElfImage::ReadU8AtVaddr(uint64_t vaddr, uint8_t* out) const {
-    std::vector<uint8_t> tmp;
-    if (!ReadBytesAtVaddr(vaddr, 1, &tmp)) {
+    const uint8_t* p = ViewBytesAtVaddr(vaddr, 1);
+    if (p == nullptr) {
         return false;
     }
-    *out = tmp[0];
+    *out = p[0];
     return true;
 }
 
 bool ElfImage::ReadI32AtVaddr(uint64_t vaddr, int32_t* out) const {
-    std::vector<uint8_t> tmp;
-    if (!ReadBytesAtVaddr(vaddr, 4, &tmp)) {
+    const uint8_t* p = ViewBytesAtVaddr(vaddr, 4);
+    if (p == nullptr) {
         return false;
     }
-    *out = static_cast<int32_t>(ReadLe32(tmp.data()));
+    *out = static_cast<int32_t>(ReadLe32(p));
     return true;
 }
 
 bool ElfImage::ReadU64AtOffset(uint64_t offset, uint64_t* out) const {
-    std::vector<uint8_t> tmp;
-    if (!ReadBytesAtOffset(offset, 8, &tmp)) {
+    const uint8_t* p = ViewBytesAtOffset(offset, 8);
+    if (p == nullptr) {
         return false;
     }
-    *out = ReadLe64(tmp.data());
+    *out = ReadLe64(p);
     return true;
 }
 
@@ -559,25 +661,38 @@ bool ElfImage::FindDynamicSymbolVaddr(const std::string& symbolName, uint64_t* o
 }
 
 bool ElfImage::ReadU32AtVaddr(uint64_t vaddr, uint32_t* out) const {
-    std::vector<uint8_t> tmp;
-    if (!ReadBytesAtVaddr(vaddr, 4, &tmp)) {
+    const uint8_t* p = ViewBytesAtVaddr(vaddr, 4);
+    if (p == nullptr) {
         return false;
     }
-    *out = ReadLe32(tmp.data());
+    *out = ReadLe32(p);
     return true;
 }
 
 bool ElfImage::ReadU64AtVaddr(uint64_t vaddr, uint64_t* out) const {
-    std::vector<uint8_t> tmp;
-    if (!ReadBytesAtVaddr(vaddr, 8, &tmp)) {
+    const uint8_t* p = ViewBytesAtVaddr(vaddr, 8);
+    if (p == nullptr) {
         return false;
     }
-    *out = ReadLe64(tmp.data());
+    *out = ReadLe64(p);
     return true;
 }
 
 bool ElfImage::ReadCStringAtVaddr(uint64_t vaddr, std::string* out) const {
     out->clear();
+    const Segment* seg = FindSegmentForVaddr(vaddr);
+    if (seg != nullptr && vaddr - seg->vaddr < seg->filesz) {
+        // Fast path: scan the segment bytes directly when the terminator lies inside it.
+        const uint64_t delta = vaddr - seg->vaddr;
+        const uint64_t fileOffset = seg->fileOffset + delta;
+        const size_t avail = static_cast<size_t>(std::min<uint64_t>(4096, seg->filesz - delta));
+        const uint8_t* p = data_.data() + fileOffset;
+        const void* nul = std::memchr(p, 0, avail);
+        if (nul != nullptr) {
+            out->assign(reinterpret_cast<const char*>(p), static_cast<size_t>(static_cast<const uint8_t*>(nul) - p));
+            return true;
+        }
+    }
     for (size_t i = 0; i < 4096; ++i) {
         uint8_t c = 0;
         if (!ReadU8AtVaddr(vaddr + static_cast<uint64_t>(i), &c)) {
@@ -0,0 +1,146 @@
+#include "SwitchPort/FileBacking.h"
+
+#include <fstream>
+#include <new>
+#include <utility>
+
+#include "SwitchPort/Profiler.h"
+
+#if !defined(__SWITCH__) && !defined(_WIN32)
+#define SWITCHPORT_HAVE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace SwitchPort {
+
+namespace {
+
+void SetError(std::string* error, const std::string& message) {
+    if (error != nullptr) {
+        *error = message;
+    }
+}
+
+bool ReadWholeFile(const std::string& path, uint64_t maxBytes, const char* label, std::vector<uint8_t>* out,
+                   std::string* error) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        SetError(error, std::string("Failed to open ") + label + ": " + path);
+        return false;
+    }
+    in.seekg(0, std::ios::end);
+    const std::streamoff size = in.tellg();
+    if (size < 0) {
+        SetError(error, std::string("Failed to query ") + label + " size: " + path);
+        return false;
+    }
+    if (static_cast<uint64_t>(size) > maxBytes) {
+        SetError(error, std::string(label) + " is too large: " + std::to_string(static_cast<unsigned long long>(size)) +
+                            " bytes");
+        return false;
+    }
+    in.seekg(0, std::ios::beg);
+    try {
+        out->resize(static_cast<size_t>(size));
+    } catch (const std::bad_alloc&) {
+        SetError(error, std::string("Out of memory while reading ") + label);
+        return false;
+    }
+    if (size == 0) {
+        return true;
+    }
+    in.read(reinterpret_cast<char*>(out->data()), size);
+    if (!in.good()) {
+        SetError(error, std::string("Failed to read ") + label + " contents: " + path);
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+FileBacking::~FileBacking() {
+    Reset();
+}
+
+FileBacking::FileBacking(FileBacking&& other) noexcept {
+    *this = std::move(other);
+}
+
+FileBacking& FileBacking::operator=(FileBacking&& other) noexcept {
+    if (this != &other) {
+        Reset();
+        owned_ = std::move(other.owned_);
+        data_ = other.mapped_ ? other.data_ : owned_.data();
+        size_ = other.size_;
+        mapped_ = other.mapped_;
+        other.data_ = nullptr;
+        other.size_ = 0;
+        other.mapped_ = false;
+        other.owned_.clear();
+    }
+    return *this;
+}
+
+void FileBacking::Reset() {
+#ifdef SWITCHPORT_HAVE_MMAP
+    if (mapped_ && data_ != nullptr) {
+        ::munmap(data_, size_);
+    }
+#endif
+    data_ = nullptr;
+    size_ = 0;
+    mapped_ = false;
+    owned_.clear();
+    owned_.shrink_to_fit();
+}
+
+void FileBacking::Adopt(std::vector<uint8_t>&& bytes) {
+    Reset();
+    owned_ = std::move(bytes);
+    data_ = owned_.data();
+    size_ = owned_.size();
+}
+
+bool FileBacking::Open(const std::string& path, uint64_t maxBytes, const char* label, std::string* error) {
+    Reset();
+#ifdef SWITCHPORT_HAVE_MMAP
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        struct stat st {};
+        if (::fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+            if (static_cast<uint64_t>(st.st_size) > maxBytes) {
+                ::close(fd);
+                SetError(error, std::string(label) + " is too large: " +
+                                    std::to_string(static_cast<unsigned long long>(st.st_size)) + " bytes");
+                return false;
+            }
+            const size_t length = static_cast<size_t>(st.st_size);
+            void* mapping = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+            if (mapping != MAP_FAILED) {
+                ::close(fd);
+                data_ = static_cast<uint8_t*>(mapping);
+                size_ = length;
+                mapped_ = true;
+                Profiler::Count(ProfileCounter::InputBytesRead, size_);
+                return true;
+            }
+        }
+        ::close(fd);
+    }
+    // Empty files, special files and mmap failures take the buffered path below.
+#endif
+    if (!ReadWholeFile(path, maxBytes, label, &owned_, error)) {
+        owned_.clear();
+        return false;
+    }
+    data_ = owned_.data();
+    size_ = owned_.size();
+    Profiler::Count(ProfileCounter::InputBytesRead, size_);
+    return true;
+}
+
+} // namespace SwitchPort
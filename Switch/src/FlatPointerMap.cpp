@@ -0,0 +1,80 @@
+#include "SwitchPort/FlatPointerMap.h"
+
+namespace SwitchPort {
+
+namespace {
+
+// The table is kept at most half full so probe runs stay short.
+constexpr size_t kMinCapacity = 16;
+
+size_t CapacityFor(size_t count) {
+    size_t capacity = kMinCapacity;
+    while (capacity < count * 2) {
+        capacity *= 2;
+    }
+    return capacity;
+}
+
+} // namespace
+
+void FlatPointerMap::Clear() {
+    keys_.clear();
+    values_.clear();
+    size_ = 0;
+    shift_ = 64;
+}
+
+void FlatPointerMap::Reserve(size_t count) {
+    const size_t capacity = CapacityFor(count);
+    if (capacity > keys_.size()) {
+        Rehash(capacity);
+    }
+}
+
+void FlatPointerMap::Set(uint64_t key, uint32_t value) {
+    if (key == 0) {
+        return;
+    }
+    if ((size_ + 1) * 2 > keys_.size()) {
+        Rehash(CapacityFor(size_ + 1));
+    }
+    const size_t mask = keys_.size() - 1;
+    for (size_t slot = SlotFor(key); ; slot = (slot + 1) & mask) {
+        if (keys_[slot] == key) {
+            values_[slot] = value;
+            return;
+        }
+        if (keys_[slot] == 0) {
+            keys_[slot] = key;
+            values_[slot] = value;
+            ++size_;
+            return;
+        }
+    }
+}
+
+void FlatPointerMap::Rehash(size_t capacity) {
+    std::vector<uint64_t> oldKeys(capacity, 0);
+    std::vector<uint32_t> oldValues(capacity, 0);
+    oldKeys.swap(keys_);
+    oldValues.swap(values_);
+    unsigned bits = 0;
+    while ((size_t{1} << bits) < capacity) {
+        ++bits;
+    }
+    shift_ = 64u - bits;
+    const size_t mask = capacity - 1;
+    for (size_t i = 0; i < oldKeys.size(); ++i) {
+        if (oldKeys[i] == 0) {
+            continue;
+        }
+        size_t slot = SlotFor(oldKeys[i]);
+        while (keys_[slot] != 0) {
+            slot = (slot + 1) & mask;
+        }
+        keys_[slot] = oldKeys[i];
+        values_[slot] = oldValues[i];
+    }
+}
+
+} // namespace SwitchPort
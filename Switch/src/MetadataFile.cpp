@@ -1,36 +1,18 @@
 #include "SwitchPort/MetadataFile.h"
 
+#include <algorithm>
 #include <cstring>
-#include <fstream>
+#include <limits>
 #include <sstream>
+#include <stdexcept>
 
 #include "SwitchPort/BinaryReader.h"
+#include "SwitchPort/Profiler.h"
 
 namespace SwitchPort {
 
 namespace {
 
-bool ReadFile(const std::string& path, std::vector<uint8_t>* out) {
-    std::ifstream file(path, std::ios::binary);
-    if (!file) {
-        return false;
-    }
-    file.seekg(0, std::ios::end);
-    const std::streamoff size = file.tellg();
-    if (size < 0) {
-        return false;
-    }
-    file.seekg(0, std::ios::beg);
-
-    out->resize(static_cast<size_t>(size));
-    if (size == 0) {
-        return true;
-    }
-
-    file.read(reinterpret_cast<char*>(out->data()), size);
-    return file.good();
-}
-
 bool ValidateArrayBounds(uint32_t offset, int32_t size, size_t elemSize, std::string* error, const char* name, size_t fileSize) {
     if (size < 0) {
         if (error != nullptr) {
@@ -56,28 +38,20 @@ bool ValidateArrayBounds(uint32_t offset, int32_t size, size_t elemSize, std::st
 
 } // namespace
 
+MetadataFile::MetadataFile() : tables_(std::make_unique<Tables>()) {}
+
+MetadataFile::~MetadataFile() = default;
+
 bool MetadataFile::Load(const std::string& path, std::string* error) {
     images_.clear();
-    types_.clear();
-    methods_.clear();
-    fields_.clear();
-    parameters_.clear();
-    genericContainers_.clear();
-    genericParameters_.clear();
-    properties_.clear();
-    events_.clear();
-    attributeDataRanges_.clear();
-    nestedTypeIndices_.clear();
-    interfaceIndices_.clear();
-    fieldDefaultValues_.clear();
-    parameterDefaultValues_.clear();
+    tables_ = std::make_unique<Tables>();
     header_ = {};
     typeIndexSize_ = 4;
     typeDefinitionIndexSize_ = 4;
     genericContainerIndexSize_ = 4;
     parameterIndexSize_ = 4;
 
-    if (!ReadFile(path, &data_)) {
+    if (!data_.Open(path, std::numeric_limits<uint64_t>::max(), "metadata file", nullptr)) {
         SetError(error, "Failed to read file: " + path);
         return false;
     }
@@ -88,58 +62,47 @@ bool MetadataFile::Load(const std::string& path, std::string* error) {
     if (!ParseImages(error)) {
         return false;
     }
-    if (!ParseTypes(error)) {
-        return false;
-    }
-    if (!ParseMethods(error)) {
-        return false;
-    }
-    if (!ParseFields(error)) {
-        return false;
-    }
-    if (!ParseParameters(error)) {
-        return false;
-    }
-    if (!ParseGenericParameters(error)) {
-        return false;
-    }
-    if (!ParseGenericContainers(error)) {
-        return false;
-    }
-    if (!ParseNestedTypes(error)) {
-        return false;
-    }
-    if (!ParseInterfaces(error)) {
-        return false;
-    }
-    if (!ParseFieldDefaultValues(error)) {
-        return false;
-    }
-    if (!ParseParameterDefaultValues(error)) {
-        return false;
-    }
-    if (!ParseProperties(error)) {
-        return false;
-    }
-    if (!ParseEvents(error)) {
-        return false;
-    }
-    if (!ParseAttributeDataRanges(error)) {
-        return false;
-    }
 
+    const size_t typeCount = static_cast<size_t>(header_.typeDefinitionsSize) /
+                             GetTypeDefinitionSize(header_.version, genericContainerIndexSize_, typeIndexSize_);
+    for (const auto& image : images_) {
+        const uint64_t end = static_cast<uint64_t>(image.typeStart) + static_cast<uint64_t>(image.typeCount);
+        if (image.typeStart < 0 || end > typeCount) {
+            std::ostringstream oss;
+            oss << "Image type range out of bounds: start=" << image.typeStart << " count=" << image.typeCount;
+            SetError(error, oss.str());
+            return false;
+        }
+    }
     return true;
 }
 
 std::string MetadataFile::GetString(uint32_t index) const {
-    BinaryReader reader(data_);
+    Profiler::Count(ProfileCounter::MetadataStringsAllocated);
+    return std::string(GetStringView(index));
+}
+
+std::string_view MetadataFile::GetBytesView(uint32_t absOffset, uint32_t size) const {
+    if (static_cast<uint64_t>(absOffset) + size > data_.size()) {
+        return {};
+    }
+    return std::string_view(reinterpret_cast<const char*>(data_.data() + absOffset), size);
+}
+
+std::string_view MetadataFile::GetStringView(uint32_t index) const {
     const uint64_t absOffset = static_cast<uint64_t>(header_.stringOffset) + static_cast<uint64_t>(index);
-    return reader.ReadCStringAt(static_cast<size_t>(absOffset));
+    if (absOffset >= data_.size()) {
+        throw std::out_of_range("String offset out of range");
+    }
+    const char* begin = reinterpret_cast<const char*>(data_.data() + absOffset);
+    const size_t avail = data_.size() - static_cast<size_t>(absOffset);
+    const void* nul = std::memchr(begin, 0, avail);
+    return std::string_view(begin, nul != nullptr ? static_cast<size_t>(static_cast<const char*>(nul) - begin) : avail);
 }
 
 bool MetadataFile::ParseHeader(std::string* error) {
     try {
-        BinaryReader reader(data_);
+        BinaryReader reader(data_.data(), data_.size());
 
         const uint32_t sanity = reader.ReadU32();
         if (sanity != kMetadataMagic) {
@@ -402,7 +365,7 @@ bool MetadataFile::ParseHeader(std::string* error) {
 
 bool MetadataFile::ParseImages(std::string* error) {
     try {
-        BinaryReader reader(data_, header_.imagesOffset);
+        BinaryReader reader(data_.data(), data_.size(), header_.imagesOffset);
         const size_t imageCount = static_cast<size_t>(header_.imagesSize) / GetImageDefinitionSize(header_.version, typeDefinitionIndexSize_);
 
         images_.reserve(imageCount);
@@ -437,366 +400,288 @@ bool MetadataFile::ParseImages(std::string* error) {
     return true;
 }
 
-bool MetadataFile::ParseTypes(std::string* error) {
-    try {
-        BinaryReader reader(data_, header_.typeDefinitionsOffset);
-        const size_t typeCount = static_cast<size_t>(header_.typeDefinitionsSize) / GetTypeDefinitionSize(header_.version, genericContainerIndexSize_, typeIndexSize_);
+void MetadataFile::ParseTypes(std::vector<TypeDefinition>* out) const {
+    BinaryReader reader(data_.data(), data_.size(), header_.typeDefinitionsOffset);
+    const size_t typeCount = static_cast<size_t>(header_.typeDefinitionsSize) / GetTypeDefinitionSize(header_.version, genericContainerIndexSize_, typeIndexSize_);
 
-        types_.reserve(typeCount);
-        for (size_t i = 0; i < typeCount; ++i) {
-            TypeDefinition type{};
-            type.nameIndex = reader.ReadU32();
-            type.namespaceIndex = reader.ReadU32();
+    out->reserve(typeCount);
+    for (size_t i = 0; i < typeCount; ++i) {
+        TypeDefinition type{};
+        type.nameIndex = reader.ReadU32();
+        type.namespaceIndex = reader.ReadU32();
 
-            if (header_.version <= 24) {
-                (void)reader.ReadI32(); // customAttributeIndex
-            }
-            (void)reader.ReadIndexValue(typeIndexSize_); // byvalTypeIndex (TypeIndex)
-            if (header_.version <= 24.5) {
-                (void)reader.ReadI32(); // byrefTypeIndex
-            }
+        if (header_.version <= 24) {
+            (void)reader.ReadI32(); // customAttributeIndex
+        }
+        (void)reader.ReadIndexValue(typeIndexSize_); // byvalTypeIndex (TypeIndex)
+        if (header_.version <= 24.5) {
+            (void)reader.ReadI32(); // byrefTypeIndex
+        }
 
-            type.declaringTypeIndex = reader.ReadIndexValue(typeIndexSize_);
-            type.parentIndex = reader.ReadIndexValue(typeIndexSize_);
-            if (header_.version < 35) {
-                type.elementTypeIndex = reader.ReadI32();
-            } else {
-                // v35+ removed elementTypeIndex; for enums, use parentIndex as surrogate
-                type.elementTypeIndex = type.parentIndex;
-            }
+        type.declaringTypeIndex = reader.ReadIndexValue(typeIndexSize_);
+        type.parentIndex = reader.ReadIndexValue(typeIndexSize_);
+        if (header_.version < 35) {
+            type.elementTypeIndex = reader.ReadI32();
+        } else {
+            // v35+ removed elementTypeIndex; for enums, use parentIndex as surrogate
+            type.elementTypeIndex = type.parentIndex;
+        }
 
-            if (header_.version <= 24.1) {
-                (void)reader.ReadI32(); // rgctxStartIndex
-                (void)reader.ReadI32(); // rgctxCount
-            }
+        if (header_.version <= 24.1) {
+            (void)reader.ReadI32(); // rgctxStartIndex
+            (void)reader.ReadI32(); // rgctxCount
+        }
 
-            type.genericContainerIndex = reader.ReadIndexValue(genericContainerIndexSize_);
+        type.genericContainerIndex = reader.ReadIndexValue(genericContainerIndexSize_);
 
-            if (header_.version <= 22) {
-                (void)reader.ReadI32(); // delegateWrapperFromManagedToNativeIndex
-                (void)reader.ReadI32(); // marshalingFunctionsIndex
-            }
-            if (header_.version >= 21 && header_.version <= 22) {
-                (void)reader.ReadI32(); // ccwFunctionIndex
-                (void)reader.ReadI32(); // guidIndex
-            }
+        if (header_.version <= 22) {
+            (void)reader.ReadI32(); // delegateWrapperFromManagedToNativeIndex
+            (void)reader.ReadI32(); // marshalingFunctionsIndex
+        }
+        if (header_.version >= 21 && header_.version <= 22) {
+            (void)reader.ReadI32(); // ccwFunctionIndex
+            (void)reader.ReadI32(); // guidIndex
+        }
 
-            type.flags = reader.ReadU32();
-
-            type.fieldStart = reader.ReadI32();
-            type.methodStart = reader.ReadI32();
-            type.eventStart = reader.ReadI32();
-            type.propertyStart = reader.ReadI32();
-            type.nestedTypesStart = reader.ReadI32();
-            type.interfacesStart = reader.ReadI32();
-            (void)reader.ReadI32(); // vtableStart
-            (void)reader.ReadI32(); // interfaceOffsetsStart
-
-            type.methodCount = reader.ReadU16();
-            type.propertyCount = reader.ReadU16();
-            type.fieldCount = reader.ReadU16();
-            type.eventCount = reader.ReadU16();
-            type.nestedTypeCount = reader.ReadU16();
-            (void)reader.ReadU16(); // vtable_count
-            type.interfacesCount = reader.ReadU16();
-            (void)reader.ReadU16(); // interface_offsets_count
-
-            type.bitfield = reader.ReadU32();
-            if (header_.version >= 19) {
-                type.token = reader.ReadU32();
-            }
+        type.flags = reader.ReadU32();
 
-            types_.push_back(type);
-        }
+        type.fieldStart = reader.ReadI32();
+        type.methodStart = reader.ReadI32();
+        type.eventStart = reader.ReadI32();
+        type.propertyStart = reader.ReadI32();
+        type.nestedTypesStart = reader.ReadI32();
+        type.interfacesStart = reader.ReadI32();
+        (void)reader.ReadI32(); // vtableStart
+        (void)reader.ReadI32(); // interfaceOffsetsStart
 
-        for (const auto& image : images_) {
-            const uint64_t end = static_cast<uint64_t>(image.typeStart) + static_cast<uint64_t>(image.typeCount);
-            if (image.typeStart < 0 || end > types_.size()) {
-                std::ostringstream oss;
-                oss << "Image type range out of bounds: start=" << image.typeStart << " count=" << image.typeCount;
-                SetError(error, oss.str());
-                return false;
-            }
-        }
-    } catch (const std::exception& ex) {
-        SetError(error, std::string("Failed to parse type table: ") + ex.what());
-        return false;
-    }
-    return true;
-}
+        type.methodCount = reader.ReadU16();
+        type.propertyCount = reader.ReadU16();
+        type.fieldCount = reader.ReadU16();
+        type.eventCount = reader.ReadU16();
+        type.nestedTypeCount = reader.ReadU16();
+        (void)reader.ReadU16(); // vtable_count
+        type.interfacesCount = reader.ReadU16();
+        (void)reader.ReadU16(); // interface_offsets_count
 
-bool MetadataFile::ParseMethods(std::string* error) {
-    try {
-        BinaryReader reader(data_, header_.methodsOffset);
-        const size_t methodCount = static_cast<size_t>(header_.methodsSize) / GetMethodDefinitionSize(header_.version, typeIndexSize_, genericContainerIndexSize_, parameterIndexSize_, typeDefinitionIndexSize_);
-        methods_.reserve(methodCount);
-
-        for (size_t i = 0; i < methodCount; ++i) {
-            MethodDefinition method{};
-            method.nameIndex = reader.ReadU32();
-            method.declaringType = reader.ReadIndexValue(typeDefinitionIndexSize_);
-            method.returnType = reader.ReadIndexValue(typeIndexSize_);
-            if (header_.version >= 31) {
-                (void)reader.ReadI32(); // returnParameterToken
-            }
-            method.parameterStart = reader.ReadIndexValue(
-                (header_.version >= 39) ? parameterIndexSize_ : 4);
-            if (header_.version <= 24) {
-                (void)reader.ReadI32(); // customAttributeIndex
-            }
-            method.genericContainerIndex = reader.ReadIndexValue(genericContainerIndexSize_);
-            if (header_.version <= 24) {
-                (void)reader.ReadI32(); // methodIndex
-                (void)reader.ReadI32(); // invokerIndex
-                (void)reader.ReadI32(); // delegateWrapperIndex
-                (void)reader.ReadI32(); // rgctxStartIndex
-                (void)reader.ReadI32(); // rgctxCount
-            }
-            method.token = reader.ReadU32();
-            method.flags = reader.ReadU16();
-            (void)reader.ReadU16(); // iflags
-            method.slot = reader.ReadU16();
-            method.parameterCount = reader.ReadU16();
-            methods_.push_back(method);
+        type.bitfield = reader.ReadU32();
+        if (header_.version >= 19) {
+            type.token = reader.ReadU32();
         }
-    } catch (const std::exception& ex) {
-        SetError(error, std::string("Failed to parse method table: ") + ex.what());
-        return false;
-    }
-    return true;
-}
 
-bool MetadataFile::ParseFields(std::string* error) {
-    try {
-        BinaryReader reader(data_, header_.fieldsOffset);
-        const size_t fieldCount = static_cast<size_t>(header_.fieldsSize) / GetFieldDefinitionSize(header_.version, typeIndexSize_);
-        fields_.reserve(fieldCount);
-
-        for (size_t i = 0; i < fieldCount; ++i) {
-            FieldDefinition field{};
-            field.nameIndex = reader.ReadU32();
-            field.typeIndex = reader.ReadIndexValue(typeIndexSize_);
-            if (header_.version <= 24) {
-                (void)reader.ReadI32(); // customAttributeIndex
-            }
-            if (header_.version >= 19) {
-                field.token = reader.ReadU32();
-            }
-            fields_.push_back(field);
-        }
-    } catch (const std::exception& ex) {
-        SetError(error, std::string("Failed to parse field table: ") + ex.what());
-        return false;
+        out->push_back(type);
     }
-    return true;
 }
 
-bool MetadataFile::ParseParameters(std::string* error) {
-    try {
-        BinaryReader reader(data_, header_.parametersOffset);
-        const size_t parameterCount = static_cast<size_t>(header_.parametersSize) / GetParameterDefinitionSize(header_.version, typeIndexSize_);
-        parameters_.reserve(parameterCount);
-
-        for (size_t i = 0; i < parameterCount; ++i) {
-            ParameterDefinition parameter{};
-            parameter.nameIndex = reader.ReadU32();
-            (void)reader.ReadU32(); // token
-            if (header_.version <= 24) {
-                (void)reader.ReadI32(); // customAttributeIndex
-            }
-            parameter.typeIndex = reader.ReadIndexValue(typeIndexSize_);
-            parameters_.push_back(parameter);
+void MetadataFile::ParseMethods(std::vector<MethodDefinition>* out) const {
+    BinaryReader reader(data_.data(), data_.size(), header_.methodsOffset);
+    const size_t methodCount = static_cast<size_t>(header_.methodsSize) / GetMethodDefinitionSize(header_.version, typeIndexSize_, genericContainerIndexSize_, parameterIndexSize_, typeDefinitionIndexSize_);
+    out->reserve(methodCount);
+
+    for (size_t i = 0; i < methodCount; ++i) {
+        MethodDefinition method{};
+        method.nameIndex = reader.ReadU32();
+        method.declaringType = reader.ReadIndexValue(typeDefinitionIndexSize_);
+        method.returnType = reader.ReadIndexValue(typeIndexSize_);
+        if (header_.version >= 31) {
+            (void)reader.ReadI32(); // returnParameterToken
         }
-    } catch (const std::exception& ex) {
-        SetError(error, std::string("Failed to parse parameter table: ") + ex.what());
-        return false;
+        method.parameterStart = reader.ReadIndexValue(
+            (header_.version >= 39) ? parameterIndexSize_ : 4);
+        if (header_.version <= 24) {
+            (void)reader.ReadI32(); // customAttributeIndex
+        }
+        method.genericContainerIndex = reader.ReadIndexValue(genericContainerIndexSize_);
+        if (header_.version <= 24) {
+            (void)reader.ReadI32(); // methodIndex
+            (void)reader.ReadI32(); // invokerIndex
+            (void)reader.ReadI32(); // delegateWrapperIndex
+            (void)reader.ReadI32(); // rgctxStartIndex
+            (void)reader.ReadI32(); // rgctxCount
+        }
+        method.token = reader.ReadU32();
+        method.flags = reader.ReadU16();
+        (void)reader.ReadU16(); // iflags
+        method.slot = reader.ReadU16();
+        method.parameterCount = reader.ReadU16();
+        out->push_back(method);
     }
-    return true;
 }
 
-bool MetadataFile::ParseGenericParameters(std::string* error) {
-    try {
-        BinaryReader reader(data_, header_.genericParametersOffset);
-        const size_t count = static_cast<size_t>(header_.genericParametersSize) / GetGenericParameterSize(header_.version, genericContainerIndexSize_);
-        genericParameters_.reserve(count);
-        for (size_t i = 0; i < count; ++i) {
-            GenericParameter gp{};
-            gp.ownerIndex = reader.ReadIndexValue(genericContainerIndexSize_);
-            gp.nameIndex = reader.ReadU32();
-            gp.constraintsStart = static_cast<int16_t>(reader.ReadU16());
-            gp.constraintsCount = static_cast<int16_t>(reader.ReadU16());
-            gp.num = reader.ReadU16();
-            gp.flags = reader.ReadU16();
-            genericParameters_.push_back(gp);
+void MetadataFile::ParseFields(std::vector<FieldDefinition>* out) const {
+    BinaryReader reader(data_.data(), data_.size(), header_.fieldsOffset);
+    const size_t fieldCount = static_cast<size_t>(header_.fieldsSize) / GetFieldDefinitionSize(header_.version, typeIndexSize_);
+    out->reserve(fieldCount);
+
+    for (size_t i = 0; i < fieldCount; ++i) {
+        FieldDefinition field{};
+        field.nameIndex = reader.ReadU32();
+        field.typeIndex = reader.ReadIndexValue(typeIndexSize_);
+        if (header_.version <= 24) {
+            (void)reader.ReadI32(); // customAttributeIndex
         }
-    } catch (const std::exception& ex) {
-        SetError(error, std::string("Failed to parse generic parameter table: ") + ex.what());
-        return false;
+        if (header_.version >= 19) {
+            field.token = reader.ReadU32();
+        }
+        out->push_back(field);
     }
-    return true;
 }
 
-bool MetadataFile::ParseGenericContainers(std::string* error) {
-    try {
-        BinaryReader reader(data_, header_.genericContainersOffset);
-        const size_t count = static_cast<size_t>(header_.genericContainersSize) / GetGenericContainerSize();
-        genericContainers_.reserve(count);
-        for (size_t i = 0; i < count; ++i) {
-            GenericContainer gc{};
-            gc.ownerIndex = reader.ReadI32();
-            gc.typeArgc = reader.ReadI32();
-            gc.isMethod = reader.ReadI32();
-            gc.genericParameterStart = reader.ReadI32();
-            genericContainers_.push_back(gc);
-        }
-    } catch (const std::exception& ex) {
-        SetError(error, std::string("Failed to parse generic container table: ") + ex.what());
-        return false;
+void MetadataFile::ParseParameters(std::vector<ParameterDefinition>* out) const {
+    BinaryReader reader(data_.data(), data_.size(), header_.parametersOffset);
+    const size_t parameterCount = static_cast<size_t>(header_.parametersSize) / GetParameterDefinitionSize(header_.version, typeIndexSize_);
+    out->reserve(parameterCount);
+
+    for (size_t i = 0; i < parameterCount; ++i) {
+        ParameterDefinition parameter{};
+        parameter.nameIndex = reader.ReadU32();
+        (void)reader.ReadU32(); // token
+        if (header_.version <= 24) {
+            (void)reader.ReadI32(); // customAttributeIndex
+        }
+        parameter.typeIndex = reader.ReadIndexValue(typeIndexSize_);
+        out->push_back(parameter);
+    }
+}
+
+void MetadataFile::ParseGenericParameters(std::vector<GenericParameter>* out) const {
+    BinaryReader reader(data_.data(), data_.size(), header_.genericParametersOffset);
+    const size_t count = static_cast<size_t>(header_.genericParametersSize) / GetGenericParameterSize(header_.version, genericContainerIndexSize_);
+    out->reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        GenericParameter gp{};
+        gp.ownerIndex = reader.ReadIndexValue(genericContainerIndexSize_);
+        gp.nameIndex = reader.ReadU32();
+        gp.constraintsStart = static_cast<int16_t>(reader.ReadU16());
+        gp.constraintsCount = static_cast<int16_t>(reader.ReadU16());
+        gp.num = reader.ReadU16();
+        gp.flags = reader.ReadU16();
+        out->push_back(gp);
+    }
+}
+
+void MetadataFile::ParseGenericContainers(std::vector<GenericContainer>* out) const {
+    BinaryReader reader(data_.data(), data_.size(), header_.genericContainersOffset);
+    const size_t count = static_cast<size_t>(header_.genericContainersSize) / GetGenericContainerSize();
+    out->reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        GenericContainer gc{};
+        gc.ownerIndex = reader.ReadI32();
+        gc.typeArgc = reader.ReadI32();
+        gc.isMethod = reader.ReadI32();
+        gc.genericParameterStart = reader.ReadI32();
+        out->push_back(gc);
     }
-    return true;
 }
-
-bool MetadataFile::ParseNestedTypes(std::string* error) {
-    try {
-        BinaryReader reader(data_, header_.nestedTypesOffset);
-        // Nested type entries are always 4-byte int32 (not variable-width TypeDefinitionIndex)
-        const size_t count = static_cast<size_t>(header_.nestedTypesSize) / 4;
-        nestedTypeIndices_.reserve(count);
-        for (size_t i = 0; i < count; ++i) {
-            nestedTypeIndices_.push_back(reader.ReadI32());
-        }
-    } catch (const std::exception& ex) {
-        SetError(error, std::string("Failed to parse nested type index table: ") + ex.what());
-        return false;
+
+void MetadataFile::ParseNestedTypes(std::vector<int32_t>* out) const {
+    BinaryReader reader(data_.data(), data_.size(), header_.nestedTypesOffset);
+    // Nested type entries are always 4-byte int32 (not variable-width TypeDefinitionIndex)
+    const size_t count = static_cast<size_t>(header_.nestedTypesSize) / 4;
+    out->reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        out->push_back(reader.ReadI32());
     }
-    return true;
 }
 
-bool MetadataFile::ParseInterfaces(std::string* error) {
-    try {
-        BinaryReader reader(data_, header_.interfacesOffset);
-        const size_t count = static_cast<size_t>(header_.interfacesSize) / static_cast<size_t>(typeIndexSize_);
-        interfaceIndices_.reserve(count);
-        for (size_t i = 0; i < count; ++i) {
-            interfaceIndices_.push_back(reader.ReadIndexValue(typeIndexSize_));
-        }
-    } catch (const std::exception& ex) {
-        SetError(error, std::string("Failed to parse interface index table: ") + ex.what());
-        return false;
+void MetadataFile::ParseInterfaces(std::vector<int32_t>* out) const {
+    BinaryReader reader(data_.data(), data_.size(), header_.interfacesOffset);
+    const size_t count = static_cast<size_t>(header_.interfacesSize) / static_cast<size_t>(typeIndexSize_);
+    out->reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        out->push_back(reader.ReadIndexValue(typeIndexSize_));
     }
-    return true;
 }
 
-bool MetadataFile::ParseFieldDefaultValues(std::string* error) {
-    try {
-        BinaryReader reader(data_, header_.fieldDefaultValuesOffset);
-        const size_t count = static_cast<size_t>(header_.fieldDefaultValuesSize) / GetFieldDefaultValueSize(header_.version, typeIndexSize_);
-        for (size_t i = 0; i < count; ++i) {
-            FieldDefaultValue value{};
-            value.fieldIndex = reader.ReadI32();
-            value.typeIndex = reader.ReadIndexValue(typeIndexSize_);
-            value.dataIndex = reader.ReadI32();
-            fieldDefaultValues_[value.fieldIndex] = value;
-        }
-    } catch (const std::exception& ex) {
-        SetError(error, std::string("Failed to parse field default value table: ") + ex.what());
-        return false;
+void MetadataFile::ParseFieldDefaultValues(std::vector<FieldDefaultValue>* out) const {
+    BinaryReader reader(data_.data(), data_.size(), header_.fieldDefaultValuesOffset);
+    const size_t count = static_cast<size_t>(header_.fieldDefaultValuesSize) / GetFieldDefaultValueSize(header_.version, typeIndexSize_);
+    out->reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        FieldDefaultValue value{};
+        value.fieldIndex = reader.ReadI32();
+        value.typeIndex = reader.ReadIndexValue(typeIndexSize_);
+        value.dataIndex = reader.ReadI32();
+        out->push_back(value);
     }
-    return true;
+    // Stable, so the last entry for a duplicated index is the one lookups find, as with the old map assignment.
+    std::stable_sort(out->begin(), out->end(), [](const FieldDefaultValue& a, const FieldDefaultValue& b) {
+        return a.fieldIndex < b.fieldIndex;
+    });
 }
 
-bool MetadataFile::ParseParameterDefaultValues(std::string* error) {
-    try {
-        BinaryReader reader(data_, header_.parameterDefaultValuesOffset);
-        const size_t count = static_cast<size_t>(header_.parameterDefaultValuesSize) / GetParameterDefaultValueSize(header_.version, typeIndexSize_, parameterIndexSize_);
-        for (size_t i = 0; i < count; ++i) {
-            ParameterDefaultValue value{};
-            value.parameterIndex = reader.ReadIndexValue(parameterIndexSize_);
-            value.typeIndex = reader.ReadIndexValue(typeIndexSize_);
-            value.dataIndex = reader.ReadI32();
-            parameterDefaultValues_[value.parameterIndex] = value;
-        }
-    } catch (const std::exception& ex) {
-        SetError(error, std::string("Failed to parse parameter default value table: ") + ex.what());
-        return false;
+void MetadataFile::ParseParameterDefaultValues(std::vector<ParameterDefaultValue>* out) const {
+    BinaryReader reader(data_.data(), data_.size(), header_.parameterDefaultValuesOffset);
+    const size_t count = static_cast<size_t>(header_.parameterDefaultValuesSize) / GetParameterDefaultValueSize(header_.version, typeIndexSize_, parameterIndexSize_);
+    out->reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        ParameterDefaultValue value{};
+        value.parameterIndex = reader.ReadIndexValue(parameterIndexSize_);
+        value.typeIndex = reader.ReadIndexValue(typeIndexSize_);
+        value.dataIndex = reader.ReadI32();
+        out->push_back(value);
     }
-    return true;
+    // Stable, so the last entry for a duplicated index is the one lookups find, as with the old map assignment.
+    std::stable_sort(out->begin(), out->end(), [](const ParameterDefaultValue& a, const ParameterDefaultValue& b) {
+        return a.parameterIndex < b.parameterIndex;
+    });
 }
 
-bool MetadataFile::ParseProperties(std::string* error) {
-    try {
-        BinaryReader reader(data_, header_.propertiesOffset);
-        const size_t propertyCount = static_cast<size_t>(header_.propertiesSize) / GetPropertyDefinitionSize(header_.version);
-        properties_.reserve(propertyCount);
-
-        for (size_t i = 0; i < propertyCount; ++i) {
-            PropertyDefinition property{};
-            property.nameIndex = reader.ReadU32();
-            property.get = reader.ReadI32();
-            property.set = reader.ReadI32();
-            property.attrs = reader.ReadU32();
-            if (header_.version <= 24) {
-                (void)reader.ReadI32(); // customAttributeIndex
-            }
-            if (header_.version >= 19) {
-                property.token = reader.ReadU32();
-            }
-            properties_.push_back(property);
+void MetadataFile::ParseProperties(std::vector<PropertyDefinition>* out) const {
+    BinaryReader reader(data_.data(), data_.size(), header_.propertiesOffset);
+    const size_t propertyCount = static_cast<size_t>(header_.propertiesSize) / GetPropertyDefinitionSize(header_.version);
+    out->reserve(propertyCount);
+
+    for (size_t i = 0; i < propertyCount; ++i) {
+        PropertyDefinition property{};
+        property.nameIndex = reader.ReadU32();
+        property.get = reader.ReadI32();
+        property.set = reader.ReadI32();
+        property.attrs = reader.ReadU32();
+        if (header_.version <= 24) {
+            (void)reader.ReadI32(); // customAttributeIndex
         }
-    } catch (const std::exception& ex) {
-        SetError(error, std::string("Failed to parse property table: ") + ex.what());
-        return false;
-    }
-    return true;
-}
+        if (header_.version >= 19) {
+            property.token = reader.ReadU32();
+        }
+        out->push_back(property);
+    }
+}
+
+void MetadataFile::ParseEvents(std::vector<EventDefinition>* out) const {
+    BinaryReader reader(data_.data(), data_.size(), header_.eventsOffset);
+    const size_t eventCount = static_cast<size_t>(header_.eventsSize) / GetEventDefinitionSize(header_.version, typeIndexSize_);
+    out->reserve(eventCount);
 
-bool MetadataFile::ParseEvents(std::string* error) {
-    try {
-        BinaryReader reader(data_, header_.eventsOffset);
-        const size_t eventCount = static_cast<size_t>(header_.eventsSize) / GetEventDefinitionSize(header_.version, typeIndexSize_);
-        events_.reserve(eventCount);
-
-        for (size_t i = 0; i < eventCount; ++i) {
-            EventDefinition eventDef{};
-            eventDef.nameIndex = reader.ReadU32();
-            eventDef.typeIndex = reader.ReadIndexValue(typeIndexSize_);
-            eventDef.add = reader.ReadI32();
-            eventDef.remove = reader.ReadI32();
-            eventDef.raise = reader.ReadI32();
-            if (header_.version <= 24) {
-                (void)reader.ReadI32(); // customAttributeIndex
-            }
-            if (header_.version >= 19) {
-                eventDef.token = reader.ReadU32();
-            }
-            events_.push_back(eventDef);
+    for (size_t i = 0; i < eventCount; ++i) {
+        EventDefinition eventDef{};
+        eventDef.nameIndex = reader.ReadU32();
+        eventDef.typeIndex = reader.ReadIndexValue(typeIndexSize_);
+        eventDef.add = reader.ReadI32();
+        eventDef.remove = reader.ReadI32();
+        eventDef.raise = reader.ReadI32();
+        if (header_.version <= 24) {
+            (void)reader.ReadI32(); // customAttributeIndex
         }
-    } catch (const std::exception& ex) {
-        SetError(error, std::string("Failed to parse event table: ") + ex.what());
-        return false;
+        if (header_.version >= 19) {
+            eventDef.token = reader.ReadU32();
+        }
+        out->push_back(eventDef);
     }
-    return true;
 }
 
-bool MetadataFile::ParseAttributeDataRanges(std::string* error) {
+void MetadataFile::ParseAttributeDataRanges(std::vector<CustomAttributeDataRange>* out) const {
     if (header_.version < 29) {
-        return true;
+        return;
     }
-    try {
-        BinaryReader reader(data_, header_.attributeDataRangeOffset);
-        const size_t count = static_cast<size_t>(header_.attributeDataRangeSize) / GetCustomAttributeDataRangeSize();
-        attributeDataRanges_.reserve(count);
-        for (size_t i = 0; i < count; ++i) {
-            CustomAttributeDataRange r{};
-            r.token = reader.ReadU32();
-            r.startOffset = reader.ReadU32();
-            attributeDataRanges_.push_back(r);
-        }
-    } catch (const std::exception& ex) {
-        SetError(error, std::string("Failed to parse attribute data range table: ") + ex.what());
-        return false;
+    BinaryReader reader(data_.data(), data_.size(), header_.attributeDataRangeOffset);
+    const size_t count = static_cast<size_t>(header_.attributeDataRangeSize) / GetCustomAttributeDataRangeSize();
+    out->reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        CustomAttributeDataRange r{};
+        r.token = reader.ReadU32();
+        r.startOffset = reader.ReadU32();
+        out->push_back(r);
     }
-    return true;
 }
 
 void MetadataFile::SetError(std::string* error, const std::string& message) const {
@@ -806,23 +691,27 @@ void MetadataFile::SetError(std::string* error, const std::string& message) cons
 }
 
 bool MetadataFile::TryGetFieldDefaultValue(int32_t fieldIndex, FieldDefaultValue* out) const {
-    const auto it = fieldDefaultValues_.find(fieldIndex);
-    if (it == fieldDefaultValues_.end()) {
+    const auto& values = Table(tables_->fieldDefaultValues, &MetadataFile::ParseFieldDefaultValues);
+    auto it = std::upper_bound(values.begin(), values.end(), fieldIndex,
+                               [](int32_t index, const FieldDefaultValue& value) { return index < value.fieldIndex; });
+    if (it == values.begin() || (--it)->fieldIndex != fieldIndex) {
         return false;
     }
     if (out != nullptr) {
-        *out = it->second;
+        *out = *it;
     }
     return true;
 }
 
 bool MetadataFile::TryGetParameterDefaultValue(int32_t parameterIndex, ParameterDefaultValue* out) const {
-    const auto it = parameterDefaultValues_.find(parameterIndex);
-    if (it == parameterDefaultValues_.end()) {
+    const auto& values = Table(tables_->parameterDefaultValues, &MetadataFile::ParseParameterDefaultValues);
+    auto it = std::upper_bound(values.begin(), values.end(), parameterIndex,
+                               [](int32_t index, const ParameterDefaultValue& value) { return index < value.parameterIndex; });
+    if (it == values.begin() || (--it)->parameterIndex != parameterIndex) {
         return false;
     }
     if (out != nullptr) {
-        *out = it->second;
+        *out = *it;
     }
     return true;
 }
@@ -0,0 +1,88 @@
+#include "SwitchPort/MonotonicArena.h"
+
+#include <cstring>
+#include <utility>
+
+namespace SwitchPort {
+
+MonotonicArena::MonotonicArena(MonotonicArena&& other) noexcept
+    : blocks_(std::move(other.blocks_)),
+      cursor_(std::exchange(other.cursor_, nullptr)),
+      limit_(std::exchange(other.limit_, nullptr)),
+      blockBytes_(other.blockBytes_),
+      reserved_(std::exchange(other.reserved_, 0)) {
+    other.blocks_.clear();
+}
+
+MonotonicArena& MonotonicArena::operator=(MonotonicArena&& other) noexcept {
+    if (this != &other) {
+        blocks_ = std::move(other.blocks_);
+        other.blocks_.clear();
+        cursor_ = std::exchange(other.cursor_, nullptr);
+        limit_ = std::exchange(other.limit_, nullptr);
+        blockBytes_ = other.blockBytes_;
+        reserved_ = std::exchange(other.reserved_, 0);
+    }
+    return *this;
+}
+
+void* MonotonicArena::Allocate(size_t bytes, size_t alignment) {
+    if (cursor_ != nullptr) {
+        const uintptr_t address = reinterpret_cast<uintptr_t>(cursor_);
+        const uintptr_t aligned = (address + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+        uint8_t* start = cursor_ + (aligned - address);
+        if (start <= limit_ && bytes <= static_cast<size_t>(limit_ - start)) {
+            cursor_ = start + bytes;
+            return start;
+        }
+    }
+    // Requests larger than a quarter block get a block of their own, so they do not waste the rest of the current
+    // one. new[] storage is aligned for any fundamental type.
+    if (bytes > blockBytes_ / 4) {
+        return AllocateBlock(bytes);
+    }
+    uint8_t* block = AllocateBlock(blockBytes_);
+    cursor_ = block;
+    limit_ = block + blockBytes_;
+    return Allocate(bytes, alignment);
+}
+
+std::string_view MonotonicArena::Copy(std::string_view text) {
+    if (text.empty()) {
+        return {};
+    }
+    char* data = static_cast<char*>(Allocate(text.size(), 1));
+    std::memcpy(data, text.data(), text.size());
+    return std::string_view(data, text.size());
+}
+
+void MonotonicArena::Adopt(MonotonicArena& other) {
+    if (&other == this) {
+        return;
+    }
+    blocks_.reserve(blocks_.size() + other.blocks_.size());
+    for (auto& block : other.blocks_) {
+        blocks_.push_back(std::move(block));
+    }
+    reserved_ += other.reserved_;
+    other.blocks_.clear();
+    other.cursor_ = nullptr;
+    other.limit_ = nullptr;
+    other.reserved_ = 0;
+}
+
+void MonotonicArena::Reset() {
+    blocks_.clear();
+    cursor_ = nullptr;
+    limit_ = nullptr;
+    reserved_ = 0;
+}
+
+uint8_t* MonotonicArena::AllocateBlock(size_t bytes) {
+    // Left uninitialized: every byte handed out is written by the caller.
+    blocks_.emplace_back(new uint8_t[bytes]);
+    reserved_ += bytes;
+    return blocks_.back().get();
+}
+
+} // namespace SwitchPort
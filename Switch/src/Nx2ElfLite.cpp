@@ -7,8 +7,12 @@
 #include <cstring>
 #include <fstream>
 #include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
 #include <vector>
 
+#include "SwitchPort/Profiler.h"
 #include "lz4.h"
 
 namespace SwitchPort {
@@ -72,7 +76,11 @@ bool ReadFile(const std::string& path, std::vector<uint8_t>* out) {
         return true;
     }
     in.read(reinterpret_cast<char*>(out->data()), size);
-    return in.good();
+    if (!in.good()) {
+        return false;
+    }
+    Profiler::Count(ProfileCounter::InputBytesRead, out->size());
+    return true;
 }
 
 bool WriteFile(const std::string& path, const std::vector<uint8_t>& bytes) {
@@ -229,9 +237,50 @@ bool BuildMinimalElf(const std::vector<uint8_t>& image, const std::array<Segment
     return true;
 }
 
+bool DecompressNsoSegment(const std::vector<uint8_t>& file, const SegmentInfo& seg, uint32_t compSize,
+                          std::vector<uint8_t>* image) {
+    if (compSize == seg.memSize) {
+        std::memcpy(image->data() + seg.memOffset, file.data() + seg.fileOffset, seg.memSize);
+        return true;
+    }
+    const int outLen = LZ4_decompress_safe(reinterpret_cast<const char*>(file.data() + seg.fileOffset),
+                                           reinterpret_cast<char*>(image->data() + seg.memOffset),
+                                           static_cast<int>(compSize), static_cast<int>(seg.memSize));
+    return outLen == static_cast<int>(seg.memSize);
+}
+
+bool SegmentsOverlap(const std::array<SegmentInfo, 3>& segs) {
+    for (size_t i = 0; i < segs.size(); ++i) {
+        for (size_t j = i + 1; j < segs.size(); ++j) {
+            const uint64_t aBegin = segs[i].memOffset;
+            const uint64_t aEnd = aBegin + segs[i].memSize;
+            const uint64_t bBegin = segs[j].memOffset;
+            const uint64_t bEnd = bBegin + segs[j].memSize;
+            if (aBegin < bEnd && bBegin < aEnd) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
 } // namespace
 
 bool ConvertNsoLikeToElf(const std::string& inputPath, const std::string& outputElfPath, std::string* error) {
+    std::vector<uint8_t> elf;
+    if (!ConvertNsoLikeToElfImage(inputPath, &elf, error)) {
+        return false;
+    }
+    if (!WriteFile(outputElfPath, elf)) {
+        if (error) {
+            *error = "Failed to write converted ELF";
+        }
+        return false;
+    }
+    return true;
+}
+
+bool ConvertNsoLikeToElfImage(const std::string& inputPath, std::vector<uint8_t>* outElf, std::string* error) {
     std::vector<uint8_t> file;
     if (!ReadFile(inputPath, &file)) {
         if (error) {
@@ -268,28 +317,45 @@ bool ConvertNsoLikeToElf(const std::string& inputPath, const std::string& output
         const uint32_t dataEnd = segs[2].memOffset + segs[2].memSize + segs[2].bssAlign;
         image.assign(dataEnd, 0);
 
+        std::array<uint32_t, 3> compSizes{};
         for (size_t i = 0; i < 3; ++i) {
-            const uint32_t compSize = ReadLe32(file.data() + segFileSizeBase + i * 4);
-            if (segs[i].fileOffset + compSize > file.size() || segs[i].memOffset + segs[i].memSize > image.size()) {
+            compSizes[i] = ReadLe32(file.data() + segFileSizeBase + i * 4);
+            if (static_cast<uint64_t>(segs[i].fileOffset) + compSizes[i] > file.size() ||
+                static_cast<uint64_t>(segs[i].memOffset) + segs[i].memSize > image.size()) {
                 if (error) {
                     *error = "NSO segment bounds are invalid";
                 }
                 return false;
             }
-            if (compSize == segs[i].memSize) {
-                std::memcpy(image.data() + segs[i].memOffset, file.data() + segs[i].fileOffset, segs[i].memSize);
-            } else {
-                const int outLen = LZ4_decompress_safe(reinterpret_cast<const char*>(file.data() + segs[i].fileOffset),
-                                                       reinterpret_cast<char*>(image.data() + segs[i].memOffset), compSize,
-                                                       segs[i].memSize);
-                if (outLen != static_cast<int>(segs[i].memSize)) {
-                    if (error) {
-                        *error = "NSO LZ4 decompression failed";
-                    }
-                    return false;
+        }
+
+        // text, rodata and data decompress into disjoint ranges of the image, so rodata and data run on helper
+        // threads while text decompresses here. Overlapping (malformed) layouts stay sequential.
+        std::array<bool, 3> decompressed{};
+        std::vector<std::thread> helpers;
+        if (!SegmentsOverlap(segs)) {
+            for (size_t i = 1; i < 3; ++i) {
+                try {
+                    helpers.emplace_back([&, i] { decompressed[i] = DecompressNsoSegment(file, segs[i], compSizes[i], &image); });
+                } catch (const std::system_error&) {
+                    break;
                 }
             }
         }
+        for (size_t i = 0; i < 3; ++i) {
+            if (i == 0 || i > helpers.size()) {
+                decompressed[i] = DecompressNsoSegment(file, segs[i], compSizes[i], &image);
+            }
+        }
+        for (auto& helper : helpers) {
+            helper.join();
+        }
+        if (!decompressed[0] || !decompressed[1] || !decompressed[2]) {
+            if (error) {
+                *error = "NSO LZ4 decompression failed";
+            }
+            return false;
+        }
         recognized = true;
     } else {
         constexpr uint32_t kNroOffset = 0x10;
@@ -307,7 +373,7 @@ bool ConvertNsoLikeToElf(const std::string& inputPath, const std::string& output
                 segs[i].memSize = ReadLe32(file.data() + kNroOffset + 0x14 + i * 8);
                 segs[i].bssAlign = (i == 0) ? 0x100u : (i == 1 ? 1u : ReadLe32(file.data() + kNroOffset + 0x28));
             }
-            image = file;
+            image = std::move(file);
             recognized = true;
         }
     }
@@ -326,6 +392,9 @@ bool ConvertNsoLikeToElf(const std::string& inputPath, const std::string& output
         return false;
     }
 
+    // The compressed input is no longer needed; drop it before the ELF copy is allocated.
+    std::vector<uint8_t>().swap(file);
+
     const uint32_t modMagicOffset = ReadLe32(image.data() + 4);
     if (modMagicOffset + sizeof(ModHeader) > image.size()) {
         if (error) {
@@ -352,18 +421,7 @@ bool ConvertNsoLikeToElf(const std::string& inputPath, const std::string& output
     }
     const uint32_t dynamicVaddr = static_cast<uint32_t>(dynamicVaddr64);
 
-    std::vector<uint8_t> elf;
-    if (!BuildMinimalElf(image, segs, dynamicVaddr, &elf, error)) {
-        return false;
-    }
-
-    if (!WriteFile(outputElfPath, elf)) {
-        if (error) {
-            *error = "Failed to write converted ELF";
-        }
-        return false;
-    }
-    return true;
+    return BuildMinimalElf(image, segs, dynamicVaddr, outElf, error);
 }
 
 } // namespace SwitchPort
@@ -0,0 +1,309 @@
+#include "SwitchPort/Profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <vector>
+
+#ifdef __SWITCH__
+#include <switch.h>
+#elif !defined(_WIN32)
+#define SWITCHPORT_HAVE_RUSAGE 1
+#include <sys/resource.h>
+#endif
+
+namespace SwitchPort {
+
+namespace {
+
+const char* const kCounterNames[kProfileCounterCount] = {
+    "input_bytes_read",
+    "dump_bytes_rendered",
+    "metadata_strings_allocated",
+    "type_name_cache_hits",
+    "type_name_cache_misses",
+    "pointer_type_cache_hits",
+    "pointer_type_cache_misses",
+    "elf_vaddr_searches",
+    "registration_candidates",
+};
+
+struct PhaseRecord {
+    std::string name;
+    long long parent = -1;
+    uint32_t depth = 0;
+    std::chrono::steady_clock::time_point start;
+    double startMs = 0.0;
+    double durationMs = -1.0;
+};
+
+struct ProfileRegistry {
+    std::mutex mutex;
+    std::vector<detail::ThreadProfileCounters*> live;
+    std::array<uint64_t, kProfileCounterCount> retired{};
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::vector<PhaseRecord> phases;
+    uint64_t sampledPeak = 0;
+};
+
+// Phases open on this thread, innermost last, and the phase its outermost ones nest under.
+thread_local std::vector<size_t> tlsOpenPhases;
+thread_local long long tlsParentPhase = -1;
+
+// Never destroyed: thread-local counters of the main thread unregister during exit.
+ProfileRegistry& Registry() {
+    static ProfileRegistry* registry = new ProfileRegistry();
+    return *registry;
+}
+
+double MillisecondsBetween(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to) {
+    return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+uint64_t CurrentMemoryBytes() {
+#ifdef __SWITCH__
+    u64 used = 0;
+    if (R_SUCCEEDED(svcGetInfo(&used, InfoType_UsedMemorySize, CUR_PROCESS_HANDLE, 0))) {
+        return used;
+    }
+#endif
+    return 0;
+}
+
+std::string JsonEscape(const std::string& value) {
+    std::string out;
+    out.reserve(value.size());
+    for (const char c : value) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char buf[8];
+            std::snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned>(c));
+            out += buf;
+        } else {
+            out += c;
+        }
+    }
+    return out;
+}
+
+std::string CsvField(const std::string& value) {
+    if (value.find_first_of(",\"\n") == std::string::npos) {
+        return value;
+    }
+    std::string out = "\"";
+    for (const char c : value) {
+        if (c == '"') {
+            out += '"';
+        }
+        out += c;
+    }
+    out += '"';
+    return out;
+}
+
+std::string FormatMs(double ms) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.3f", ms);
+    return buf;
+}
+
+void SetError(std::string* error, const std::string& message) {
+    if (error != nullptr) {
+        *error = message;
+    }
+}
+
+// Snapshot taken under the registry lock so reports see consistent phases and counters.
+struct ProfileSnapshot {
+    std::vector<PhaseRecord> phases;
+    std::array<uint64_t, kProfileCounterCount> counters{};
+    double totalMs = 0.0;
+};
+
+ProfileSnapshot TakeSnapshot() {
+    ProfileRegistry& registry = Registry();
+    ProfileSnapshot snapshot;
+    const auto now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    snapshot.phases = registry.phases;
+    for (auto& phase : snapshot.phases) {
+        if (phase.durationMs < 0.0) {
+            phase.durationMs = MillisecondsBetween(phase.start, now);
+        }
+    }
+    snapshot.counters = registry.retired;
+    for (const auto* counters : registry.live) {
+        for (size_t i = 0; i < kProfileCounterCount; ++i) {
+            snapshot.counters[i] += counters->values[i].load(std::memory_order_relaxed);
+        }
+    }
+    snapshot.totalMs = MillisecondsBetween(registry.start, now);
+    return snapshot;
+}
+
+const char* PlatformName() {
+#ifdef __SWITCH__
+    return "switch";
+#else
+    return "desktop";
+#endif
+}
+
+} // namespace
+
+namespace detail {
+
+ThreadProfileCounters::ThreadProfileCounters() {
+    ProfileRegistry& registry = Registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.live.push_back(this);
+}
+
+ThreadProfileCounters::~ThreadProfileCounters() {
+    ProfileRegistry& registry = Registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (size_t i = 0; i < kProfileCounterCount; ++i) {
+        registry.retired[i] += values[i].load(std::memory_order_relaxed);
+    }
+    registry.live.erase(std::remove(registry.live.begin(), registry.live.end(), this), registry.live.end());
+}
+
+} // namespace detail
+
+uint64_t Profiler::CounterValue(ProfileCounter counter) {
+    return TakeSnapshot().counters[static_cast<size_t>(counter)];
+}
+
+size_t Profiler::BeginPhase(const std::string& name) {
+    // Touch the thread-locals before locking: their first use on a thread also constructs the thread's counters,
+    // which register themselves under the same mutex.
+    std::vector<size_t>& open = tlsOpenPhases;
+    const long long threadParent = tlsParentPhase;
+    ProfileRegistry& registry = Registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    PhaseRecord record;
+    record.name = name;
+    record.start = std::chrono::steady_clock::now();
+    record.startMs = MillisecondsBetween(registry.start, record.start);
+    record.parent = open.empty() ? threadParent : static_cast<long long>(open.back());
+    if (record.parent >= 0 && static_cast<size_t>(record.parent) < registry.phases.size()) {
+        record.depth = registry.phases[static_cast<size_t>(record.parent)].depth + 1;
+    } else {
+        record.parent = -1;
+    }
+    registry.phases.push_back(std::move(record));
+    open.push_back(registry.phases.size() - 1);
+    return registry.phases.size() - 1;
+}
+
+long long Profiler::EndPhase(size_t phase) {
+    const auto now = std::chrono::steady_clock::now();
+    const uint64_t memory = CurrentMemoryBytes();
+    std::vector<size_t>& open = tlsOpenPhases;
+    ProfileRegistry& registry = Registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.sampledPeak = std::max(registry.sampledPeak, memory);
+    if (phase >= registry.phases.size()) {
+        return 0;
+    }
+    PhaseRecord& record = registry.phases[phase];
+    if (record.durationMs < 0.0) {
+        record.durationMs = MillisecondsBetween(record.start, now);
+    }
+    // Phases end in LIFO order; tolerate an outer phase ending first by closing everything above it.
+    const auto it = std::find(open.begin(), open.end(), phase);
+    if (it != open.end()) {
+        open.erase(it, open.end());
+    }
+    return static_cast<long long>(record.durationMs);
+}
+
+long long Profiler::CurrentPhase() {
+    return tlsOpenPhases.empty() ? tlsParentPhase : static_cast<long long>(tlsOpenPhases.back());
+}
+
+void Profiler::SetThreadParentPhase(long long phase) {
+    tlsParentPhase = phase;
+}
+
+uint64_t Profiler::PeakMemoryBytes() {
+    uint64_t peak = CurrentMemoryBytes();
+#ifdef SWITCHPORT_HAVE_RUSAGE
+    struct rusage usage {};
+    if (getrusage(RUSAGE_SELF, &usage) == 0 && usage.ru_maxrss > 0) {
+#ifdef __APPLE__
+        peak = static_cast<uint64_t>(usage.ru_maxrss);
+#else
+        peak = static_cast<uint64_t>(usage.ru_maxrss) * 1024u;
+#endif
+    }
+#endif
+    ProfileRegistry& registry = Registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    return std::max(peak, registry.sampledPeak);
+}
+
+bool Profiler::WriteJson(const std::string& path, std::string* error) {
+    const ProfileSnapshot snapshot = TakeSnapshot();
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        SetError(error, "Failed to open profile report: " + path);
+        return false;
+    }
+    out << "{\n";
+    out << "  \"format\": 1,\n";
+    out << "  \"platform\": \"" << PlatformName() << "\",\n";
+    out << "  \"total_ms\": " << FormatMs(snapshot.totalMs) << ",\n";
+    out << "  \"peak_memory_bytes\": " << PeakMemoryBytes() << ",\n";
+    out << "  \"phases\": [";
+    for (size_t i = 0; i < snapshot.phases.size(); ++i) {
+        const PhaseRecord& phase = snapshot.phases[i];
+        out << (i == 0 ? "\n" : ",\n");
+        out << "    {\"name\": \"" << JsonEscape(phase.name) << "\", \"parent\": " << phase.parent
+            << ", \"depth\": " << phase.depth << ", \"start_ms\": " << FormatMs(phase.startMs)
+            << ", \"duration_ms\": " << FormatMs(phase.durationMs) << "}";
+    }
+    out << (snapshot.phases.empty() ? "],\n" : "\n  ],\n");
+    out << "  \"counters\": {";
+    for (size_t i = 0; i < kProfileCounterCount; ++i) {
+        out << (i == 0 ? "\n" : ",\n");
+        out << "    \"" << kCounterNames[i] << "\": " << snapshot.counters[i];
+    }
+    out << "\n  }\n}\n";
+    if (!out) {
+        SetError(error, "Failed to write profile report: " + path);
+        return false;
+    }
+    return true;
+}
+
+bool Profiler::WriteCsv(const std::string& path, std::string* error) {
+    const ProfileSnapshot snapshot = TakeSnapshot();
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        SetError(error, "Failed to open profile report: " + path);
+        return false;
+    }
+    // Phase rows carry milliseconds in value; counter and memory rows carry plain counts.
+    out << "kind,name,parent,depth,start_ms,value\n";
+    for (const PhaseRecord& phase : snapshot.phases) {
+        out << "phase," << CsvField(phase.name) << "," << phase.parent << "," << phase.depth << ","
+            << FormatMs(phase.startMs) << "," << FormatMs(phase.durationMs) << "\n";
+    }
+    out << "total,total_ms,-1,0,0.000," << FormatMs(snapshot.totalMs) << "\n";
+    out << "memory,peak_memory_bytes,-1,0,," << PeakMemoryBytes() << "\n";
+    for (size_t i = 0; i < kProfileCounterCount; ++i) {
+        out << "counter," << kCounterNames[i] << ",-1,0,," << snapshot.counters[i] << "\n";
+    }
+    if (!out) {
+        SetError(error, "Failed to write profile report: " + path);
+        return false;
+    }
+    return true;
+}
+
+} // namespace SwitchPort
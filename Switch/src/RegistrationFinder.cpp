@@ -2,8 +2,15 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <cstring>
+#include <limits>
+#include <thread>
 #include <vector>
 
+#include "SwitchPort/Cancellation.h"
+#include "SwitchPort/Profiler.h"
+
 namespace SwitchPort {
 
 namespace {
@@ -11,40 +18,157 @@ namespace {
 constexpr uint32_t kPfX = 1u;
 constexpr std::array<uint8_t, 13> kFeatureBytes = {'m', 's', 'c', 'o', 'r', 'l', 'i', 'b', '.', 'd', 'l', 'l', 0};
 constexpr uint64_t kPtrSize = 8;
+// Linear scans poll the cancel flag once per this many bytes (minus one) scanned.
+constexpr uint64_t kCancelPollMask = 0xFFFF;
+
+bool CancelPollDue(uint64_t scannedBytes) {
+    return (scannedBytes & kCancelPollMask) == 0 && Cancellation::Requested();
+}
+
+uint64_t ReadLe64(const uint8_t* p) {
+    uint64_t v = 0;
+    for (int i = 7; i >= 0; --i) {
+        v = (v << 8) | p[i];
+    }
+    return v;
+}
 
-std::vector<size_t> SearchPattern(const std::vector<uint8_t>& haystack, const std::array<uint8_t, 13>& needle) {
-    std::vector<size_t> results;
-    if (haystack.size() < needle.size()) {
+// Boyer-Moore-Horspool, matching Extensions/BoyerMooreHorspool.cs on the C# side. The skip table is built once per
+// needle, and each alignment is rejected on its last byte before memcmp confirms it.
+class PatternSearcher {
+public:
+    PatternSearcher(const uint8_t* needle, size_t needleSize) : needle_(needle), needleSize_(needleSize) {
+        skip_.fill(needleSize_);
+        for (size_t i = 0; i + 1 < needleSize_; ++i) {
+            skip_[needle_[i]] = needleSize_ - 1 - i;
+        }
+    }
+
+    std::vector<size_t> FindAll(const uint8_t* haystack, size_t haystackSize) const {
+        std::vector<size_t> results;
+        if (needleSize_ == 0 || haystackSize < needleSize_) {
+            return results;
+        }
+        const size_t last = needleSize_ - 1;
+        const uint8_t lastByte = needle_[last];
+        for (size_t i = 0; i + needleSize_ <= haystackSize;) {
+            const uint8_t tail = haystack[i + last];
+            if (tail == lastByte && std::memcmp(haystack + i, needle_, last) == 0) {
+                results.push_back(i);
+            }
+            i += skip_[tail];
+        }
         return results;
     }
-    for (size_t i = 0; i + needle.size() <= haystack.size(); ++i) {
-        if (std::equal(needle.begin(), needle.end(), haystack.begin() + static_cast<ptrdiff_t>(i))) {
-            results.push_back(i);
+
+private:
+    const uint8_t* needle_;
+    size_t needleSize_;
+    std::array<size_t, 256> skip_{};
+};
+
+const PatternSearcher& FeatureBytesSearcher() {
+    static const PatternSearcher searcher(kFeatureBytes.data(), kFeatureBytes.size());
+    return searcher;
+}
+
+// Bytes of one segment handed to a worker at a time by the chunked scans; a multiple of kPtrSize so chunks
+// preserve the sequential scan's slot alignment.
+constexpr uint64_t kScanChunkBytes = 256u * 1024u;
+
+// Slot range [first, last] of one data segment, stepped by kPtrSize.
+struct ScanChunk {
+    uint64_t segmentOffset = 0;
+    uint64_t segmentBytes = 0;
+    uint64_t first = 0;
+    uint64_t last = 0;
+};
+
+// Splits every non-executable segment of at least minSegmentBytes into chunks, in segment then offset order.
+std::vector<ScanChunk> DataSegmentChunks(const ElfImage& elf, uint64_t minSegmentBytes) {
+    std::vector<ScanChunk> chunks;
+    for (const auto& seg : elf.Segments()) {
+        if ((seg.flags & kPfX) != 0 || seg.filesz < std::max(minSegmentBytes, kPtrSize)) {
+            continue;
+        }
+        const uint64_t last = seg.fileOffset + seg.filesz - kPtrSize;
+        for (uint64_t first = seg.fileOffset; first <= last; first += kScanChunkBytes) {
+            chunks.push_back({seg.fileOffset, seg.filesz, first, std::min(last, first + kScanChunkBytes - kPtrSize)});
         }
     }
-    return results;
+    return chunks;
 }
 
+// Calls body(item) for every item in [0, itemCount) on up to workerCount threads, the caller included. Items are
+// handed out in increasing order.
+template <typename Body>
+void ParallelForEach(size_t itemCount, unsigned workerCount, const Body& body) {
+    std::atomic<size_t> next{0};
+    auto worker = [&]() {
+        for (size_t item = next.fetch_add(1); item < itemCount; item = next.fetch_add(1)) {
+            body(item);
+        }
+    };
+    std::vector<std::thread> threads;
+    const size_t extraThreads = std::min<size_t>(workerCount > 0 ? workerCount - 1 : 0, itemCount);
+    threads.reserve(extraThreads);
+    for (size_t i = 0; i < extraThreads; ++i) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+// Lowest item that produced a hit in a parallel scan. Items after it cannot win, so workers skip them; this keeps
+// the winner the one a sequential scan would have returned first.
+class FirstHit {
+public:
+    static constexpr size_t kNone = std::numeric_limits<size_t>::max();
+
+    bool CanWin(size_t item) const { return item < best_.load(std::memory_order_relaxed); }
+    void Offer(size_t item) {
+        size_t current = best_.load(std::memory_order_relaxed);
+        while (item < current && !best_.compare_exchange_weak(current, item, std::memory_order_relaxed)) {
+        }
+    }
+    size_t Best() const { return best_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<size_t> best_{kNone};
+};
+
 } // namespace
 
-RegistrationResult RegistrationFinder::Find(double il2cppVersion, int typeDefinitionsCount, int imageCount) const {
+RegistrationResult RegistrationFinder::Find(double il2cppVersion, int typeDefinitionsCount, int imageCount,
+                                            unsigned workerCount) const {
     RegistrationResult result{};
-    result.codeRegistration = FindCodeRegistration(il2cppVersion, imageCount, &result.pointerInExec);
+    {
+        ScopedPhase phase("find code registration");
+        result.codeRegistration = FindCodeRegistration(il2cppVersion, imageCount, workerCount, &result.pointerInExec);
+    }
+    if (Cancellation::Requested()) {
+        return result;
+    }
     if (il2cppVersion >= 27.0) {
-        result.metadataRegistration = FindMetadataRegistrationV21(typeDefinitionsCount, result.pointerInExec);
-        if (result.metadataRegistration == 0) {
-            // Fallback: some binaries place type pointers outside the expected section class.
-            result.metadataRegistration = FindMetadataRegistrationV21(typeDefinitionsCount, !result.pointerInExec);
-        }
-        if (result.metadataRegistration == 0) {
-            result.metadataRegistration = FindMetadataRegistrationHeuristic(typeDefinitionsCount);
-        }
-        if (result.metadataRegistration != 0) {
-            const uint64_t refined = RefineMetadataRegistrationAround(result.metadataRegistration, typeDefinitionsCount);
-            if (refined != 0) {
-                result.metadataRegistration = refined;
+        ScopedPhase phase("find metadata registration");
+        MetadataRegistrationCandidates candidates;
+        if (workerCount > 1) {
+            candidates = ScanMetadataRegistrationCandidates(typeDefinitionsCount, workerCount);
+        } else {
+            // The fallbacks only run when the preferred strategy finds nothing.
+            uint64_t& preferred = result.pointerInExec ? candidates.execTypes : candidates.dataTypes;
+            uint64_t& other = result.pointerInExec ? candidates.dataTypes : candidates.execTypes;
+            preferred = FindMetadataRegistrationV21(typeDefinitionsCount, result.pointerInExec);
+            if (preferred == 0) {
+                other = FindMetadataRegistrationV21(typeDefinitionsCount, !result.pointerInExec);
+            }
+            if (preferred == 0 && other == 0) {
+                candidates.heuristic = FindMetadataRegistrationHeuristic(typeDefinitionsCount);
             }
         }
+        result.metadataRegistration = ResolveMetadataRegistration(candidates, result.pointerInExec, typeDefinitionsCount);
     }
     uint64_t symbolValue = 0;
     if (result.codeRegistration == 0 && elf_.FindDynamicSymbolVaddr("g_CodeRegistration", &symbolValue)) {
@@ -56,6 +180,25 @@ RegistrationResult RegistrationFinder::Find(double il2cppVersion, int typeDefini
     return result;
 }
 
+uint64_t RegistrationFinder::ResolveMetadataRegistration(const MetadataRegistrationCandidates& candidates,
+                                                         bool pointerInExec, int typeDefinitionsCount) const {
+    uint64_t metadataRegistration = pointerInExec ? candidates.execTypes : candidates.dataTypes;
+    if (metadataRegistration == 0) {
+        // Fallback: some binaries place type pointers outside the expected section class.
+        metadataRegistration = pointerInExec ? candidates.dataTypes : candidates.execTypes;
+    }
+    if (metadataRegistration == 0) {
+        metadataRegistration = candidates.heuristic;
+    }
+    if (metadataRegistration != 0) {
+        const uint64_t refined = RefineMetadataRegistrationAround(metadataRegistration, typeDefinitionsCount);
+        if (refined != 0) {
+            metadataRegistration = refined;
+        }
+    }
+    return metadataRegistration;
+}
+
 bool RegistrationFinder::IsInDataOffset(uint64_t offset) const {
     for (const auto& seg : elf_.Segments()) {
         if ((seg.flags & kPfX) != 0) {
@@ -92,7 +235,81 @@ bool RegistrationFinder::IsInDataVaddr(uint64_t addr) const {
     return false;
 }
 
+void RegistrationFinder::BuildPointerIndex(unsigned workerCount) const {
+    ScopedPhase phase("build pointer index");
+    pointerIndexBuilt_ = true;
+    pointerIndex_.clear();
+    // Only values that land inside the image can be pointers worth indexing; this keeps the table small.
+    bool haveRange = false;
+    for (const auto& seg : elf_.Segments()) {
+        if (!haveRange || seg.vaddr < pointerRangeBegin_) {
+            pointerRangeBegin_ = seg.vaddr;
+        }
+        if (!haveRange || seg.vaddr + seg.memsz > pointerRangeEnd_) {
+            pointerRangeEnd_ = seg.vaddr + seg.memsz;
+        }
+        haveRange = true;
+    }
+    if (!haveRange) {
+        return;
+    }
+
+    const auto chunks = DataSegmentChunks(elf_, kPtrSize);
+    std::vector<std::vector<PointerSlot>> chunkSlots(chunks.size());
+    ParallelForEach(chunks.size(), workerCount, [&](size_t chunkIndex) {
+        const ScanChunk& chunk = chunks[chunkIndex];
+        const uint8_t* bytes = elf_.ViewBytesAtOffset(chunk.first, static_cast<size_t>(chunk.last - chunk.first + kPtrSize));
+        auto& slots = chunkSlots[chunkIndex];
+        for (uint64_t off = chunk.first; off <= chunk.last; off += kPtrSize) {
+            uint64_t value = 0;
+            if (bytes != nullptr) {
+                value = ReadLe64(bytes + (off - chunk.first));
+            } else if (!elf_.ReadU64AtOffset(off, &value)) {
+                break;
+            }
+            if (IsIndexedPointerValue(value)) {
+                slots.push_back({value, off});
+            }
+        }
+    });
+    size_t total = 0;
+    for (const auto& slots : chunkSlots) {
+        total += slots.size();
+    }
+    pointerIndex_.reserve(total);
+    for (auto& slots : chunkSlots) {
+        pointerIndex_.insert(pointerIndex_.end(), slots.begin(), slots.end());
+        std::vector<PointerSlot>().swap(slots);
+    }
+    // Stable so that equal values keep segment/offset order, the order a linear scan reports them in.
+    std::stable_sort(pointerIndex_.begin(), pointerIndex_.end(),
+                     [](const PointerSlot& a, const PointerSlot& b) { return a.value < b.value; });
+}
+
+bool RegistrationFinder::IsIndexedPointerValue(uint64_t value) const {
+    return value != 0 && value >= pointerRangeBegin_ && value <= pointerRangeEnd_;
+}
+
 std::vector<uint64_t> RegistrationFinder::FindReferencesInData(uint64_t addr) const {
+    if (!pointerIndexBuilt_) {
+        BuildPointerIndex();
+    }
+    std::vector<uint64_t> refs;
+    if (!IsIndexedPointerValue(addr)) {
+        return ScanReferencesInData(addr);
+    }
+    auto it = std::lower_bound(pointerIndex_.begin(), pointerIndex_.end(), addr,
+                               [](const PointerSlot& slot, uint64_t value) { return slot.value < value; });
+    for (; it != pointerIndex_.end() && it->value == addr; ++it) {
+        uint64_t va = 0;
+        if (elf_.TryMapOffsetToVaddr(it->fileOffset, &va)) {
+            refs.push_back(va);
+        }
+    }
+    return refs;
+}
+
+std::vector<uint64_t> RegistrationFinder::ScanReferencesInData(uint64_t addr) const {
     std::vector<uint64_t> refs;
     for (const auto& seg : elf_.Segments()) {
         if ((seg.flags & kPfX) != 0 || seg.filesz < kPtrSize) {
@@ -100,6 +317,9 @@ std::vector<uint64_t> RegistrationFinder::FindReferencesInData(uint64_t addr) co
         }
         const uint64_t end = seg.fileOffset + seg.filesz - kPtrSize;
         for (uint64_t off = seg.fileOffset; off <= end; off += kPtrSize) {
+            if (CancelPollDue(off - seg.fileOffset)) {
+                return refs;
+            }
             uint64_t value = 0;
             if (!elf_.ReadU64AtOffset(off, &value)) {
                 break;
@@ -115,18 +335,65 @@ std::vector<uint64_t> RegistrationFinder::FindReferencesInData(uint64_t addr) co
     return refs;
 }
 
-uint64_t RegistrationFinder::FindCodeRegistration(double il2cppVersion, int imageCount, bool* pointerInExec) const {
+uint64_t RegistrationFinder::FindCodeRegistration(double il2cppVersion, int imageCount, unsigned workerCount,
+                                                  bool* pointerInExec) const {
     if (il2cppVersion < 24.2) {
         return 0;
     }
-    uint64_t codeReg = FindCodeRegistrationInSegments(il2cppVersion, imageCount, true);
-    if (codeReg != 0) {
-        *pointerInExec = true;
+    if (workerCount <= 1) {
+        uint64_t codeReg = FindCodeRegistrationInSegments(il2cppVersion, imageCount, true);
+        if (codeReg != 0) {
+            *pointerInExec = true;
+            return codeReg;
+        }
+        codeReg = FindCodeRegistrationInSegments(il2cppVersion, imageCount, false);
+        *pointerInExec = false;
         return codeReg;
     }
-    codeReg = FindCodeRegistrationInSegments(il2cppVersion, imageCount, false);
-    *pointerInExec = false;
-    return codeReg;
+
+    // Every feature string is a candidate: executable segments first, then data segments, the order the
+    // sequential search tries them in. All of them are followed in parallel and the earliest success wins.
+    if (!pointerIndexBuilt_) {
+        BuildPointerIndex(workerCount);
+    }
+    std::vector<uint64_t> featureVas;
+    size_t execFeatures = 0;
+    for (const bool executableSegments : {true, false}) {
+        for (const auto& seg : elf_.Segments()) {
+            const bool isExec = (seg.flags & kPfX) != 0;
+            if (isExec != executableSegments || seg.filesz < kFeatureBytes.size()) {
+                continue;
+            }
+            const uint8_t* bytes = elf_.ViewBytesAtOffset(seg.fileOffset, static_cast<size_t>(seg.filesz));
+            if (bytes == nullptr) {
+                continue;
+            }
+            for (const size_t hit : FeatureBytesSearcher().FindAll(bytes, static_cast<size_t>(seg.filesz))) {
+                featureVas.push_back(seg.vaddr + hit);
+            }
+        }
+        if (executableSegments) {
+            execFeatures = featureVas.size();
+        }
+    }
+
+    std::vector<uint64_t> candidates(featureVas.size(), 0);
+    FirstHit firstHit;
+    ParallelForEach(featureVas.size(), workerCount, [&](size_t item) {
+        if (!firstHit.CanWin(item) || Cancellation::Requested()) {
+            return;
+        }
+        if (TryCodeRegistrationFromFeature(il2cppVersion, imageCount, featureVas[item], &candidates[item])) {
+            firstHit.Offer(item);
+        }
+    });
+    const size_t winner = firstHit.Best();
+    if (winner == FirstHit::kNone || Cancellation::Requested()) {
+        *pointerInExec = false;
+        return 0;
+    }
+    *pointerInExec = winner < execFeatures;
+    return candidates[winner];
 }
 
 uint64_t RegistrationFinder::FindCodeRegistrationInSegments(double il2cppVersion, int imageCount, bool executableSegments) const {
@@ -135,49 +402,63 @@ uint64_t RegistrationFinder::FindCodeRegistrationInSegments(double il2cppVersion
         if (isExec != executableSegments || seg.filesz < kFeatureBytes.size()) {
             continue;
         }
-        std::vector<uint8_t> bytes;
-        if (!elf_.ReadBytesAtOffset(seg.fileOffset, static_cast<size_t>(seg.filesz), &bytes)) {
+        const uint8_t* bytes = elf_.ViewBytesAtOffset(seg.fileOffset, static_cast<size_t>(seg.filesz));
+        if (bytes == nullptr) {
             continue;
         }
-        const auto hits = SearchPattern(bytes, kFeatureBytes);
+        const auto hits = FeatureBytesSearcher().FindAll(bytes, static_cast<size_t>(seg.filesz));
         for (size_t hit : hits) {
-            const uint64_t dllva = seg.vaddr + hit;
-            const auto ref1 = FindReferencesInData(dllva);
-            for (uint64_t refva : ref1) {
-                const auto ref2 = FindReferencesInData(refva);
-                for (uint64_t refva2 : ref2) {
-                    if (il2cppVersion >= 27.0) {
-                        for (int i = imageCount - 1; i >= 0; --i) {
-                            const uint64_t candidate = refva2 - static_cast<uint64_t>(i) * kPtrSize;
-                            const auto ref3 = FindReferencesInData(candidate);
-                            for (uint64_t refva3 : ref3) {
-                                uint64_t checkOffset = 0;
-                                if (!elf_.TryMapVaddrToOffset(refva3 - kPtrSize, &checkOffset)) {
-                                    continue;
-                                }
-                                uint64_t countValue = 0;
-                                if (!elf_.ReadU64AtOffset(checkOffset, &countValue)) {
-                                    continue;
-                                }
-                                if (countValue == static_cast<uint64_t>(imageCount)) {
-                                    return refva3 - ((il2cppVersion >= 29.0) ? (kPtrSize * 14) : (kPtrSize * 13));
-                                }
-                            }
+            if (Cancellation::Requested()) {
+                return 0;
+            }
+            uint64_t codeReg = 0;
+            if (TryCodeRegistrationFromFeature(il2cppVersion, imageCount, seg.vaddr + hit, &codeReg)) {
+                return codeReg;
+            }
+        }
+    }
+    return 0;
+}
+
+bool RegistrationFinder::TryCodeRegistrationFromFeature(double il2cppVersion, int imageCount, uint64_t featureVa,
+                                                        uint64_t* codeRegistration) const {
+    const auto ref1 = FindReferencesInData(featureVa);
+    for (uint64_t refva : ref1) {
+        const auto ref2 = FindReferencesInData(refva);
+        for (uint64_t refva2 : ref2) {
+            if (il2cppVersion >= 27.0) {
+                for (int i = imageCount - 1; i >= 0; --i) {
+                    const uint64_t candidate = refva2 - static_cast<uint64_t>(i) * kPtrSize;
+                    const auto ref3 = FindReferencesInData(candidate);
+                    for (uint64_t refva3 : ref3) {
+                        Profiler::Count(ProfileCounter::RegistrationCandidates);
+                        uint64_t checkOffset = 0;
+                        if (!elf_.TryMapVaddrToOffset(refva3 - kPtrSize, &checkOffset)) {
+                            continue;
+                        }
+                        uint64_t countValue = 0;
+                        if (!elf_.ReadU64AtOffset(checkOffset, &countValue)) {
+                            continue;
                         }
-                    } else {
-                        for (int i = 0; i < imageCount; ++i) {
-                            const uint64_t candidate = refva2 - static_cast<uint64_t>(i) * kPtrSize;
-                            const auto ref3 = FindReferencesInData(candidate);
-                            for (uint64_t refva3 : ref3) {
-                                return refva3 - kPtrSize * 13;
-                            }
+                        if (countValue == static_cast<uint64_t>(imageCount)) {
+                            *codeRegistration = refva3 - ((il2cppVersion >= 29.0) ? (kPtrSize * 14) : (kPtrSize * 13));
+                            return true;
                         }
                     }
                 }
+            } else {
+                for (int i = 0; i < imageCount; ++i) {
+                    const uint64_t candidate = refva2 - static_cast<uint64_t>(i) * kPtrSize;
+                    const auto ref3 = FindReferencesInData(candidate);
+                    if (!ref3.empty()) {
+                        *codeRegistration = ref3.front() - kPtrSize * 13;
+                        return true;
+                    }
+                }
             }
         }
     }
-    return 0;
+    return false;
 }
 
 uint64_t RegistrationFinder::FindMetadataRegistrationV21(int typeDefinitionsCount, bool pointerInExec) const {
@@ -187,6 +468,9 @@ uint64_t RegistrationFinder::FindMetadataRegistrationV21(int typeDefinitionsCoun
         }
         const uint64_t end = seg.fileOffset + seg.filesz - kPtrSize;
         for (uint64_t off = seg.fileOffset; off <= end; off += kPtrSize) {
+            if (CancelPollDue(off - seg.fileOffset)) {
+                return 0;
+            }
             uint64_t a = 0;
             if (!elf_.ReadU64AtOffset(off, &a)) {
                 break;
@@ -194,44 +478,11 @@ uint64_t RegistrationFinder::FindMetadataRegistrationV21(int typeDefinitionsCoun
             if (a != static_cast<uint64_t>(typeDefinitionsCount)) {
                 continue;
             }
-
-            uint64_t b = 0;
-            if (!elf_.ReadU64AtOffset(off + kPtrSize, &b) || b != static_cast<uint64_t>(typeDefinitionsCount)) {
+            uint64_t typesOffset = 0;
+            if (!ReadV21TypesTable(off, typeDefinitionsCount, &typesOffset) ||
+                !TypePointersIn(typesOffset, typeDefinitionsCount, pointerInExec)) {
                 continue;
             }
-
-            uint64_t pointerVa = 0;
-            if (!elf_.ReadU64AtOffset(off + kPtrSize * 2, &pointerVa)) {
-                continue;
-            }
-            uint64_t pointerOffset = 0;
-            if (!elf_.TryMapVaddrToOffset(pointerVa, &pointerOffset) || !IsInDataOffset(pointerOffset)) {
-                continue;
-            }
-
-            bool ok = true;
-            for (int i = 0; i < typeDefinitionsCount; ++i) {
-                uint64_t typeVa = 0;
-                if (!elf_.ReadU64AtOffset(pointerOffset + static_cast<uint64_t>(i) * kPtrSize, &typeVa)) {
-                    ok = false;
-                    break;
-                }
-                if (pointerInExec) {
-                    if (!IsInExecVaddr(typeVa)) {
-                        ok = false;
-                        break;
-                    }
-                } else {
-                    if (!IsInDataVaddr(typeVa)) {
-                        ok = false;
-                        break;
-                    }
-                }
-            }
-            if (!ok) {
-                continue;
-            }
-
             uint64_t addrVa = 0;
             if (!elf_.TryMapOffsetToVaddr(off, &addrVa)) {
                 continue;
@@ -242,38 +493,48 @@ uint64_t RegistrationFinder::FindMetadataRegistrationV21(int typeDefinitionsCoun
     return 0;
 }
 
+bool RegistrationFinder::ReadV21TypesTable(uint64_t off, int typeDefinitionsCount, uint64_t* typesOffset) const {
+    uint64_t b = 0;
+    if (!elf_.ReadU64AtOffset(off + kPtrSize, &b) || b != static_cast<uint64_t>(typeDefinitionsCount)) {
+        return false;
+    }
+    Profiler::Count(ProfileCounter::RegistrationCandidates);
+    uint64_t pointerVa = 0;
+    if (!elf_.ReadU64AtOffset(off + kPtrSize * 2, &pointerVa)) {
+        return false;
+    }
+    return elf_.TryMapVaddrToOffset(pointerVa, typesOffset) && IsInDataOffset(*typesOffset);
+}
+
+bool RegistrationFinder::TypePointersIn(uint64_t typesOffset, int typeDefinitionsCount, bool pointerInExec) const {
+    for (int i = 0; i < typeDefinitionsCount; ++i) {
+        uint64_t typeVa = 0;
+        if (!elf_.ReadU64AtOffset(typesOffset + static_cast<uint64_t>(i) * kPtrSize, &typeVa)) {
+            return false;
+        }
+        if (pointerInExec ? !IsInExecVaddr(typeVa) : !IsInDataVaddr(typeVa)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Room for safe reads past a heuristic candidate slot.
+constexpr uint64_t kHeuristicFieldsToCheck = 16;
+
 uint64_t RegistrationFinder::FindMetadataRegistrationHeuristic(int typeDefinitionsCount) const {
-    constexpr uint64_t kFieldsToCheck = 16; // room for safe reads
     for (const auto& seg : elf_.Segments()) {
-        if ((seg.flags & kPfX) != 0 || seg.filesz < kPtrSize * (kFieldsToCheck + 1)) {
+        if ((seg.flags & kPfX) != 0 || seg.filesz < kPtrSize * (kHeuristicFieldsToCheck + 1)) {
             continue;
         }
-        const uint64_t end = seg.fileOffset + seg.filesz - kPtrSize * kFieldsToCheck;
+        const uint64_t end = seg.fileOffset + seg.filesz - kPtrSize * kHeuristicFieldsToCheck;
         for (uint64_t off = seg.fileOffset; off <= end; off += kPtrSize) {
-            uint64_t typesCount = 0;
-            if (!elf_.ReadU64AtOffset(off + kPtrSize * 6, &typesCount) || typesCount != static_cast<uint64_t>(typeDefinitionsCount)) {
-                continue;
-            }
-
-            uint64_t typesPtr = 0;
-            uint64_t typesPtrOff = 0;
-            if (!elf_.ReadU64AtOffset(off + kPtrSize * 7, &typesPtr) || !elf_.TryMapVaddrToOffset(typesPtr, &typesPtrOff)) {
-                continue;
+            if (CancelPollDue(off - seg.fileOffset)) {
+                return 0;
             }
-            bool typesTableLooksValid = true;
-            const int sample = std::min(typeDefinitionsCount, 32);
-            for (int i = 0; i < sample; ++i) {
-                uint64_t p = 0;
-                if (!elf_.ReadU64AtOffset(typesPtrOff + static_cast<uint64_t>(i) * kPtrSize, &p) ||
-                    !(IsInDataVaddr(p) || IsInExecVaddr(p))) {
-                    typesTableLooksValid = false;
-                    break;
-                }
-            }
-            if (!typesTableLooksValid) {
+            if (!IsHeuristicMetadataRegistration(off, typeDefinitionsCount)) {
                 continue;
             }
-
             uint64_t va = 0;
             if (elf_.TryMapOffsetToVaddr(off, &va)) {
                 return va;
@@ -283,6 +544,102 @@ uint64_t RegistrationFinder::FindMetadataRegistrationHeuristic(int typeDefinitio
     return 0;
 }
 
+bool RegistrationFinder::IsHeuristicMetadataRegistration(uint64_t off, int typeDefinitionsCount) const {
+    uint64_t typesCount = 0;
+    if (!elf_.ReadU64AtOffset(off + kPtrSize * 6, &typesCount) || typesCount != static_cast<uint64_t>(typeDefinitionsCount)) {
+        return false;
+    }
+    Profiler::Count(ProfileCounter::RegistrationCandidates);
+    uint64_t typesPtr = 0;
+    uint64_t typesPtrOff = 0;
+    if (!elf_.ReadU64AtOffset(off + kPtrSize * 7, &typesPtr) || !elf_.TryMapVaddrToOffset(typesPtr, &typesPtrOff)) {
+        return false;
+    }
+    const int sample = std::min(typeDefinitionsCount, 32);
+    for (int i = 0; i < sample; ++i) {
+        uint64_t p = 0;
+        if (!elf_.ReadU64AtOffset(typesPtrOff + static_cast<uint64_t>(i) * kPtrSize, &p) ||
+            !(IsInDataVaddr(p) || IsInExecVaddr(p))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+RegistrationFinder::MetadataRegistrationCandidates
+RegistrationFinder::ScanMetadataRegistrationCandidates(int typeDefinitionsCount, unsigned workerCount) const {
+    enum Strategy { kExecTypes, kDataTypes, kHeuristic, kStrategyCount };
+    const auto chunks = DataSegmentChunks(elf_, kPtrSize * 3);
+    std::vector<std::array<uint64_t, kStrategyCount>> found(chunks.size());
+    std::array<FirstHit, kStrategyCount> firstHits;
+
+    ParallelForEach(chunks.size(), workerCount, [&](size_t chunkIndex) {
+        const ScanChunk& chunk = chunks[chunkIndex];
+        // Last slot the heuristic may inspect in this segment, matching FindMetadataRegistrationHeuristic.
+        const bool heuristicSegment = chunk.segmentBytes >= kPtrSize * (kHeuristicFieldsToCheck + 1);
+        const uint64_t heuristicEnd =
+            heuristicSegment ? chunk.segmentOffset + chunk.segmentBytes - kPtrSize * kHeuristicFieldsToCheck : 0;
+
+        std::array<bool, kStrategyCount> open{};
+        for (size_t strategy = 0; strategy < kStrategyCount; ++strategy) {
+            open[strategy] = firstHits[strategy].CanWin(chunkIndex);
+        }
+        open[kHeuristic] = open[kHeuristic] && heuristicSegment && chunk.first <= heuristicEnd;
+        auto record = [&](Strategy strategy, uint64_t va) {
+            found[chunkIndex][strategy] = va;
+            firstHits[strategy].Offer(chunkIndex);
+            open[strategy] = false;
+        };
+
+        for (uint64_t off = chunk.first; off <= chunk.last; off += kPtrSize) {
+            if (!open[kExecTypes] && !open[kDataTypes] && !open[kHeuristic]) {
+                return;
+            }
+            if (CancelPollDue(off - chunk.segmentOffset)) {
+                return;
+            }
+            uint64_t a = 0;
+            if (!elf_.ReadU64AtOffset(off, &a)) {
+                return;
+            }
+            uint64_t typesOffset = 0;
+            if ((open[kExecTypes] || open[kDataTypes]) && a == static_cast<uint64_t>(typeDefinitionsCount) &&
+                ReadV21TypesTable(off, typeDefinitionsCount, &typesOffset)) {
+                uint64_t addrVa = 0;
+                const bool mapped = elf_.TryMapOffsetToVaddr(off, &addrVa);
+                for (const Strategy strategy : {kExecTypes, kDataTypes}) {
+                    if (open[strategy] && mapped &&
+                        TypePointersIn(typesOffset, typeDefinitionsCount, strategy == kExecTypes)) {
+                        record(strategy, addrVa - kPtrSize * 10);
+                    }
+                }
+            }
+            if (open[kHeuristic] && off > heuristicEnd) {
+                open[kHeuristic] = false;
+            }
+            if (open[kHeuristic] && IsHeuristicMetadataRegistration(off, typeDefinitionsCount)) {
+                uint64_t va = 0;
+                if (elf_.TryMapOffsetToVaddr(off, &va)) {
+                    record(kHeuristic, va);
+                }
+            }
+        }
+    });
+
+    MetadataRegistrationCandidates candidates;
+    if (Cancellation::Requested()) {
+        return candidates;
+    }
+    auto winner = [&](Strategy strategy) {
+        const size_t chunkIndex = firstHits[strategy].Best();
+        return chunkIndex == FirstHit::kNone ? 0 : found[chunkIndex][strategy];
+    };
+    candidates.execTypes = winner(kExecTypes);
+    candidates.dataTypes = winner(kDataTypes);
+    candidates.heuristic = winner(kHeuristic);
+    return candidates;
+}
+
 uint64_t RegistrationFinder::RefineMetadataRegistrationAround(uint64_t candidate, int typeDefinitionsCount) const {
     const uint64_t window = 0x100;
     const uint64_t start = (candidate > window) ? (candidate - window) : 0;
@@ -302,6 +659,7 @@ uint64_t RegistrationFinder::RefineMetadataRegistrationAround(uint64_t candidate
         if (c1 != static_cast<uint64_t>(typeDefinitionsCount) || c2 != static_cast<uint64_t>(typeDefinitionsCount)) {
             continue;
         }
+        Profiler::Count(ProfileCounter::RegistrationCandidates);
         uint64_t ptrOff = 0;
         if (!elf_.TryMapVaddrToOffset(ptr, &ptrOff)) {
             continue;
@@ -1,18 +1,58 @@
 #include "SwitchPort/RuntimeTypeSystem.h"
 
+#include "SwitchPort/Profiler.h"
+
 namespace SwitchPort {
 
+namespace {
+
+uint32_t ReadLeU32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) | (static_cast<uint32_t>(p[2]) << 16) |
+           (static_cast<uint32_t>(p[3]) << 24);
+}
+
+int32_t ReadLeI32(const uint8_t* p) {
+    return static_cast<int32_t>(ReadLeU32(p));
+}
+
+// Il2CppType is { data (8 bytes), bits (4 bytes) }; one view covers both fields when they share a segment.
+bool ReadIl2CppType(const ElfImage& elf, uint64_t pointer, uint64_t* data, uint32_t* bits) {
+    const uint8_t* p = elf.ViewTableAtVaddr(pointer, 1, 12);
+    if (p != nullptr) {
+        *data = static_cast<uint64_t>(ReadLeU32(p)) | (static_cast<uint64_t>(ReadLeU32(p + 4)) << 32);
+        *bits = ReadLeU32(p + 8);
+        return true;
+    }
+    return elf.ReadU64AtVaddr(pointer + 0, data) && elf.ReadU32AtVaddr(pointer + 8, bits);
+}
+
+RuntimeType MakeRuntimeType(uint64_t pointer, uint64_t data, uint32_t bits) {
+    RuntimeType t{};
+    t.pointer = pointer;
+    t.data = data;
+    t.bits = bits;
+    t.attrs = static_cast<uint16_t>(bits & 0xffffu);
+    t.type = static_cast<uint8_t>((bits >> 16) & 0xffu);
+    t.byref = static_cast<uint8_t>((bits >> 29) & 1u);
+    return t;
+}
+
+} // namespace
+
 bool RuntimeTypeSystem::Load(const ElfImage& elf, uint64_t metadataRegistrationVa, double metadataVersion, std::string* error) {
     elf_ = &elf;
-    types_.clear();
     typePointers_.clear();
-    pointerToIndex_.clear();
+    typeData_.clear();
+    typeBits_.clear();
+    pointerToIndex_.Clear();
     genericInstPointers_.clear();
     methodSpecs_.clear();
     genericMethodTable_.clear();
     fieldOffsets_.clear();
     fieldOffsetsArePointers_ = false;
-    pointerTypeCache_.clear();
+    pointerTypeCache_.Clear();
+    cachedTypeData_.clear();
+    cachedTypeBits_.clear();
     metadataRegistration_ = {};
 
     if (metadataRegistrationVa == 0) {
@@ -51,24 +91,26 @@ bool RuntimeTypeSystem::Load(const ElfImage& elf, uint64_t metadataRegistrationV
 
     if (metadataRegistration_.fieldOffsetsCount > 0 && metadataRegistration_.fieldOffsets != 0) {
         fieldOffsetsArePointers_ = true; // true for modern metadata versions used by Switch targets.
-        fieldOffsets_.resize(static_cast<size_t>(metadataRegistration_.fieldOffsetsCount));
-        for (size_t i = 0; i < fieldOffsets_.size(); ++i) {
-            if (fieldOffsetsArePointers_) {
-                if (!elf.ReadU64AtVaddr(metadataRegistration_.fieldOffsets + static_cast<uint64_t>(i) * 8, &fieldOffsets_[i])) {
-                    if (error) {
-                        *error = "Failed reading field offsets pointer table";
-                    }
-                    return false;
+        if (fieldOffsetsArePointers_) {
+            if (!elf.ReadU64ArrayAtVaddr(metadataRegistration_.fieldOffsets,
+                                         static_cast<size_t>(metadataRegistration_.fieldOffsetsCount), &fieldOffsets_)) {
+                if (error) {
+                    *error = "Failed reading field offsets pointer table";
                 }
-            } else {
-                int32_t off = -1;
-                if (!elf.ReadI32AtVaddr(metadataRegistration_.fieldOffsets + static_cast<uint64_t>(i) * 4, &off)) {
-                    if (error) {
-                        *error = "Failed reading field offsets table";
-                    }
-                    return false;
+                return false;
+            }
+        } else {
+            std::vector<uint32_t> offsets;
+            if (!elf.ReadU32ArrayAtVaddr(metadataRegistration_.fieldOffsets,
+                                         static_cast<size_t>(metadataRegistration_.fieldOffsetsCount), &offsets)) {
+                if (error) {
+                    *error = "Failed reading field offsets table";
                 }
-                fieldOffsets_[i] = static_cast<uint64_t>(static_cast<int64_t>(off));
+                return false;
+            }
+            fieldOffsets_.resize(offsets.size());
+            for (size_t i = 0; i < offsets.size(); ++i) {
+                fieldOffsets_[i] = static_cast<uint64_t>(static_cast<int64_t>(static_cast<int32_t>(offsets[i])));
             }
         }
     }
@@ -80,51 +122,50 @@ bool RuntimeTypeSystem::Load(const ElfImage& elf, uint64_t metadataRegistrationV
         return false;
     }
 
-    typePointers_.resize(static_cast<size_t>(metadataRegistration_.typesCount));
-    for (size_t i = 0; i < typePointers_.size(); ++i) {
-        if (!elf.ReadU64AtVaddr(metadataRegistration_.types + static_cast<uint64_t>(i) * 8, &typePointers_[i])) {
-            if (error) {
-                *error = "Failed reading type pointer array entry";
-            }
-            return false;
+    if (!elf.ReadU64ArrayAtVaddr(metadataRegistration_.types, static_cast<size_t>(metadataRegistration_.typesCount),
+                                 &typePointers_)) {
+        if (error) {
+            *error = "Failed reading type pointer array entry";
         }
+        return false;
     }
 
-    types_.resize(typePointers_.size());
+    typeData_.resize(typePointers_.size());
+    typeBits_.resize(typePointers_.size());
+    pointerToIndex_.Reserve(typePointers_.size());
     for (size_t i = 0; i < typePointers_.size(); ++i) {
         const uint64_t p = typePointers_[i];
-        RuntimeType t{};
-        t.pointer = p;
-        if (!elf.ReadU64AtVaddr(p + 0, &t.data) || !elf.ReadU32AtVaddr(p + 8, &t.bits)) {
+        if (!ReadIl2CppType(elf, p, &typeData_[i], &typeBits_[i])) {
             if (error) {
                 *error = "Failed reading Il2CppType at pointer 0x" + std::to_string(p);
             }
             return false;
         }
-        t.attrs = static_cast<uint16_t>(t.bits & 0xffffu);
-        t.type = static_cast<uint8_t>((t.bits >> 16) & 0xffu);
-        t.byref = static_cast<uint8_t>((t.bits >> 29) & 1u);
-        types_[i] = t;
-        pointerToIndex_[p] = static_cast<int32_t>(i);
+        // Later slots win for duplicate pointers, as with the earlier map assignment.
+        pointerToIndex_.Set(p, static_cast<uint32_t>(i));
     }
 
     if (metadataRegistration_.genericInstsCount > 0 && metadataRegistration_.genericInsts != 0) {
-        genericInstPointers_.resize(static_cast<size_t>(metadataRegistration_.genericInstsCount), 0);
-        for (size_t i = 0; i < genericInstPointers_.size(); ++i) {
-            if (!elf.ReadU64AtVaddr(metadataRegistration_.genericInsts + static_cast<uint64_t>(i) * 8, &genericInstPointers_[i])) {
-                if (error) {
-                    *error = "Failed reading genericInst pointer array";
-                }
-                return false;
+        if (!elf.ReadU64ArrayAtVaddr(metadataRegistration_.genericInsts,
+                                     static_cast<size_t>(metadataRegistration_.genericInstsCount), &genericInstPointers_)) {
+            if (error) {
+                *error = "Failed reading genericInst pointer array";
             }
+            return false;
         }
     }
 
     if (metadataRegistration_.methodSpecsCount > 0 && metadataRegistration_.methodSpecs != 0) {
         methodSpecs_.resize(static_cast<size_t>(metadataRegistration_.methodSpecsCount));
+        const uint8_t* table = elf.ViewTableAtVaddr(metadataRegistration_.methodSpecs, methodSpecs_.size(), 12);
         for (size_t i = 0; i < methodSpecs_.size(); ++i) {
             MethodSpec s{};
-            if (!elf.ReadI32AtVaddr(metadataRegistration_.methodSpecs + static_cast<uint64_t>(i) * 12 + 0, &s.methodDefinitionIndex) ||
+            if (table != nullptr) {
+                const uint8_t* e = table + i * 12;
+                s.methodDefinitionIndex = ReadLeI32(e + 0);
+                s.classIndexIndex = ReadLeI32(e + 4);
+                s.methodIndexIndex = ReadLeI32(e + 8);
+            } else if (!elf.ReadI32AtVaddr(metadataRegistration_.methodSpecs + static_cast<uint64_t>(i) * 12 + 0, &s.methodDefinitionIndex) ||
                 !elf.ReadI32AtVaddr(metadataRegistration_.methodSpecs + static_cast<uint64_t>(i) * 12 + 4, &s.classIndexIndex) ||
                 !elf.ReadI32AtVaddr(metadataRegistration_.methodSpecs + static_cast<uint64_t>(i) * 12 + 8, &s.methodIndexIndex)) {
                 if (error) {
@@ -139,10 +180,15 @@ bool RuntimeTypeSystem::Load(const ElfImage& elf, uint64_t metadataRegistrationV
     if (metadataRegistration_.genericMethodTableCount > 0 && metadataRegistration_.genericMethodTable != 0) {
         const uint64_t entrySize = (metadataVersion >= 27.1) ? 16 : 12;
         genericMethodTable_.resize(static_cast<size_t>(metadataRegistration_.genericMethodTableCount));
+        const uint8_t* table =
+            elf.ViewTableAtVaddr(metadataRegistration_.genericMethodTable, genericMethodTable_.size(), entrySize);
         for (size_t i = 0; i < genericMethodTable_.size(); ++i) {
             GenericMethodTableEntry e{};
             const uint64_t base = metadataRegistration_.genericMethodTable + static_cast<uint64_t>(i) * entrySize;
-            if (!elf.ReadI32AtVaddr(base + 0, &e.genericMethodIndex) || !elf.ReadI32AtVaddr(base + 4, &e.methodIndex)) {
+            if (table != nullptr) {
+                e.genericMethodIndex = ReadLeI32(table + i * entrySize + 0);
+                e.methodIndex = ReadLeI32(table + i * entrySize + 4);
+            } else if (!elf.ReadI32AtVaddr(base + 0, &e.genericMethodIndex) || !elf.ReadI32AtVaddr(base + 4, &e.methodIndex)) {
                 if (error) {
                     *error = "Failed reading genericMethodTable";
                 }
@@ -155,44 +201,43 @@ bool RuntimeTypeSystem::Load(const ElfImage& elf, uint64_t metadataRegistrationV
     return true;
 }
 
-const RuntimeType* RuntimeTypeSystem::GetTypeByIndex(int32_t index) const {
-    if (index < 0 || static_cast<size_t>(index) >= types_.size()) {
-        return nullptr;
+std::optional<RuntimeType> RuntimeTypeSystem::GetTypeByIndex(int32_t index) const {
+    if (index < 0 || static_cast<size_t>(index) >= typePointers_.size()) {
+        return std::nullopt;
     }
-    return &types_[static_cast<size_t>(index)];
+    const size_t i = static_cast<size_t>(index);
+    return MakeRuntimeType(typePointers_[i], typeData_[i], typeBits_[i]);
 }
 
-const RuntimeType* RuntimeTypeSystem::GetTypeByPointer(uint64_t pointer) const {
+std::optional<RuntimeType> RuntimeTypeSystem::GetTypeByPointer(uint64_t pointer) const {
     const int32_t index = FindTypeIndexByPointer(pointer);
     if (index >= 0) {
-        return &types_[static_cast<size_t>(index)];
+        return GetTypeByIndex(index);
     }
-    const auto cacheIt = pointerTypeCache_.find(pointer);
-    if (cacheIt != pointerTypeCache_.end()) {
-        return &cacheIt->second;
+    std::lock_guard<std::mutex> lock(pointerTypeCacheMutex_);
+    const uint32_t cached = pointerTypeCache_.Find(pointer);
+    if (cached != FlatPointerMap::kNotFound) {
+        Profiler::Count(ProfileCounter::PointerTypeCacheHits);
+        return MakeRuntimeType(pointer, cachedTypeData_[cached], cachedTypeBits_[cached]);
     }
+    Profiler::Count(ProfileCounter::PointerTypeCacheMisses);
     if (pointer == 0 || elf_ == nullptr) {
-        return nullptr;
+        return std::nullopt;
     }
-    RuntimeType t{};
-    t.pointer = pointer;
-    if (!elf_->ReadU64AtVaddr(pointer + 0, &t.data) || !elf_->ReadU32AtVaddr(pointer + 8, &t.bits)) {
-        return nullptr;
-    }
-    t.attrs = static_cast<uint16_t>(t.bits & 0xffffu);
-    t.type = static_cast<uint8_t>((t.bits >> 16) & 0xffu);
-    t.byref = static_cast<uint8_t>((t.bits >> 29) & 1u);
-    const auto [it, inserted] = pointerTypeCache_.emplace(pointer, t);
-    (void)inserted;
-    return &it->second;
+    uint64_t data = 0;
+    uint32_t bits = 0;
+    if (!ReadIl2CppType(*elf_, pointer, &data, &bits)) {
+        return std::nullopt;
+    }
+    pointerTypeCache_.Set(pointer, static_cast<uint32_t>(cachedTypeData_.size()));
+    cachedTypeData_.push_back(data);
+    cachedTypeBits_.push_back(bits);
+    return MakeRuntimeType(pointer, data, bits);
 }
 
 int32_t RuntimeTypeSystem::FindTypeIndexByPointer(uint64_t pointer) const {
-    const auto it = pointerToIndex_.find(pointer);
-    if (it == pointerToIndex_.end()) {
-        return -1;
-    }
-    return it->second;
+    const uint32_t index = pointerToIndex_.Find(pointer);
+    return (index == FlatPointerMap::kNotFound) ? -1 : static_cast<int32_t>(index);
 }
 
 bool RuntimeTypeSystem::GetGenericInstArgTypePointers(const ElfImage& elf, int32_t genericInstIndex, std::vector<uint64_t>* out) const {
@@ -0,0 +1,127 @@
+#include "SwitchPort/TaskGraph.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include "SwitchPort/Profiler.h"
+
+namespace SwitchPort {
+
+TaskGraph::TaskId TaskGraph::Add(std::string name, std::vector<TaskId> dependencies, std::function<bool()> run) {
+    const TaskId id = tasks_.size();
+    Task task;
+    task.name = std::move(name);
+    task.dependencies = std::move(dependencies);
+    task.run = std::move(run);
+    tasks_.push_back(std::move(task));
+    return id;
+}
+
+void TaskGraph::Run(unsigned workerCount) {
+    std::mutex mutex;
+    std::condition_variable changed;
+    size_t running = 0;
+    std::exception_ptr firstError;
+
+    // Marks tasks whose dependencies can no longer succeed and returns the first one that can start, or
+    // tasks_.size() when none can right now. Called with mutex held.
+    auto nextRunnable = [&]() {
+        for (TaskId id = 0; id < tasks_.size(); ++id) {
+            Task& task = tasks_[id];
+            if (task.started || task.state != TaskState::Pending) {
+                continue;
+            }
+            bool ready = true;
+            bool blocked = false;
+            for (const TaskId dep : task.dependencies) {
+                const TaskState depState = tasks_[dep].state;
+                if (depState == TaskState::Failed || depState == TaskState::Skipped) {
+                    blocked = true;
+                    break;
+                }
+                if (depState != TaskState::Succeeded) {
+                    ready = false;
+                }
+            }
+            if (blocked) {
+                task.state = TaskState::Skipped;
+                continue;
+            }
+            if (ready) {
+                return id;
+            }
+        }
+        return tasks_.size();
+    };
+
+    auto finished = [&]() {
+        return std::all_of(tasks_.begin(), tasks_.end(),
+                           [](const Task& task) { return task.state != TaskState::Pending; });
+    };
+
+    const long long parentPhase = Profiler::CurrentPhase();
+    auto worker = [&](bool spawned) {
+        if (spawned) {
+            Profiler::SetThreadParentPhase(parentPhase);
+        }
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;) {
+            TaskId id = tasks_.size();
+            // After a task throws, nothing new starts; the remaining workers leave once the running tasks return.
+            changed.wait(lock, [&] {
+                id = (firstError == nullptr) ? nextRunnable() : tasks_.size();
+                return id < tasks_.size() || finished() || (running == 0 && firstError != nullptr);
+            });
+            if (id >= tasks_.size()) {
+                changed.notify_all();
+                return;
+            }
+            Task& task = tasks_[id];
+            task.started = true;
+            ++running;
+            lock.unlock();
+
+            TaskState result = TaskState::Failed;
+            try {
+                result = task.run() ? TaskState::Succeeded : TaskState::Failed;
+            } catch (...) {
+                lock.lock();
+                if (firstError == nullptr) {
+                    firstError = std::current_exception();
+                }
+                lock.unlock();
+            }
+
+            lock.lock();
+            task.state = result;
+            --running;
+            changed.notify_all();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    const size_t extraThreads = std::min<size_t>(workerCount > 0 ? workerCount - 1 : 0, tasks_.size());
+    threads.reserve(extraThreads);
+    for (size_t i = 0; i < extraThreads; ++i) {
+        threads.emplace_back(worker, true);
+    }
+    worker(false);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    if (firstError != nullptr) {
+        std::rethrow_exception(firstError);
+    }
+}
+
+unsigned DefaultTaskWorkerCount() {
+    // Pipeline steps are few and coarse, so a handful of threads covers every overlap the graph allows.
+    const unsigned hw = std::thread::hardware_concurrency();
+    return std::max(1u, std::min(hw, 4u));
+}
+
+} // namespace SwitchPort
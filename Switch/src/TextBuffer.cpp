@@ -0,0 +1,42 @@
+#include "SwitchPort/TextBuffer.h"
+
+#include <charconv>
+
+namespace SwitchPort {
+
+namespace {
+
+constexpr size_t kMaxIntegerChars = 20;
+
+template <typename T>
+void AppendChars(std::string& out, T value, int base) {
+    char digits[kMaxIntegerChars + 1];
+    const auto result = std::to_chars(digits, digits + sizeof(digits), value, base);
+    out.append(digits, static_cast<size_t>(result.ptr - digits));
+}
+
+} // namespace
+
+TextBuffer& TextBuffer::AppendDecimal(int64_t value) {
+    AppendChars(data_, value, 10);
+    return *this;
+}
+
+TextBuffer& TextBuffer::AppendDecimal(uint64_t value) {
+    AppendChars(data_, value, 10);
+    return *this;
+}
+
+TextBuffer& TextBuffer::AppendHex(uint64_t value) {
+    static constexpr char kDigits[] = "0123456789ABCDEF";
+    char digits[16];
+    size_t pos = sizeof(digits);
+    do {
+        digits[--pos] = kDigits[value & 0xFu];
+        value >>= 4;
+    } while (value != 0);
+    data_.append(digits + pos, sizeof(digits) - pos);
+    return *this;
+}
+
+} // namespace SwitchPort
@@ -0,0 +1,346 @@
+#include "SwitchPort/TypeIndex.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <numeric>
+
+#include "SwitchPort/DumpWriter.h"
+
+namespace SwitchPort {
+
+namespace {
+
+constexpr char kMagic[4] = {'T', 'Y', 'P', '3'};
+constexpr size_t kHeaderSize = 32;
+constexpr size_t kStringEntrySize = 8;
+constexpr size_t kTypeEntrySize = 32;
+constexpr size_t kTypeNameField = 4;
+constexpr size_t kFullNameField = 8;
+constexpr size_t kBaseNameField = 12;
+constexpr uint64_t kMaxIndexBytes = 1ull << 32;
+
+void SetError(std::string* error, const std::string& message) {
+    if (error != nullptr) {
+        *error = message;
+    }
+}
+
+uint32_t ReadLe32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) | (static_cast<uint32_t>(p[2]) << 16) |
+           (static_cast<uint32_t>(p[3]) << 24);
+}
+
+void AppendLe16(std::vector<uint8_t>* out, uint16_t value) {
+    out->push_back(static_cast<uint8_t>(value));
+    out->push_back(static_cast<uint8_t>(value >> 8));
+}
+
+void AppendLe32(std::vector<uint8_t>* out, uint32_t value) {
+    for (int shift = 0; shift < 32; shift += 8) {
+        out->push_back(static_cast<uint8_t>(value >> shift));
+    }
+}
+
+uint32_t Clamp32(uint64_t value) {
+    return static_cast<uint32_t>(std::min<uint64_t>(value, std::numeric_limits<uint32_t>::max()));
+}
+
+} // namespace
+
+uint32_t TypeIndex::TypeList::operator[](size_t index) const {
+    return ReadLe32(data_ + index * 4);
+}
+
+void TypeIndex::Reset() {
+    file_.Reset();
+    dumpSize_ = 0;
+    dumpMtime_ = 0;
+    typeCount_ = 0;
+    stringCount_ = 0;
+    derivedCount_ = 0;
+    stringBytes_ = 0;
+    strings_ = nullptr;
+    types_ = nullptr;
+    byFullName_ = nullptr;
+    byBaseName_ = nullptr;
+    derived_ = nullptr;
+    bytes_ = nullptr;
+}
+
+bool TypeIndex::Open(const std::string& path, std::string* error) {
+    Reset();
+    if (!file_.Open(path, kMaxIndexBytes, "type index", error)) {
+        return false;
+    }
+    const uint8_t* data = file_.data();
+    const uint64_t size = file_.size();
+    if (size < kHeaderSize || std::memcmp(data, kMagic, sizeof(kMagic)) != 0) {
+        Reset();
+        SetError(error, "type index magic mismatch (expected TYP3): " + path);
+        return false;
+    }
+    const uint16_t version = static_cast<uint16_t>(data[4] | (data[5] << 8));
+    if (version != kVersion) {
+        Reset();
+        SetError(error, "Unsupported type index version: " + std::to_string(version));
+        return false;
+    }
+    dumpSize_ = ReadLe32(data + 8);
+    dumpMtime_ = ReadLe32(data + 12);
+    typeCount_ = ReadLe32(data + 16);
+    stringCount_ = ReadLe32(data + 20);
+    derivedCount_ = ReadLe32(data + 24);
+    stringBytes_ = ReadLe32(data + 28);
+
+    const uint64_t stringsAt = kHeaderSize;
+    const uint64_t typesAt = stringsAt + static_cast<uint64_t>(stringCount_) * kStringEntrySize;
+    const uint64_t byFullAt = typesAt + static_cast<uint64_t>(typeCount_) * kTypeEntrySize;
+    const uint64_t byBaseAt = byFullAt + static_cast<uint64_t>(typeCount_) * 4;
+    const uint64_t derivedAt = byBaseAt + static_cast<uint64_t>(typeCount_) * 4;
+    const uint64_t bytesAt = derivedAt + static_cast<uint64_t>(derivedCount_) * 4;
+    if (bytesAt + stringBytes_ > size) {
+        Reset();
+        SetError(error, "type index is truncated: " + path);
+        return false;
+    }
+    strings_ = data + stringsAt;
+    types_ = data + typesAt;
+    byFullName_ = data + byFullAt;
+    byBaseName_ = data + byBaseAt;
+    derived_ = data + derivedAt;
+    bytes_ = data + bytesAt;
+    return true;
+}
+
+std::string_view TypeIndex::String(uint32_t id) const {
+    if (id >= stringCount_) {
+        return {};
+    }
+    const uint8_t* entry = strings_ + static_cast<size_t>(id) * kStringEntrySize;
+    const uint32_t offset = ReadLe32(entry);
+    const uint32_t length = ReadLe32(entry + 4);
+    if (static_cast<uint64_t>(offset) + length > stringBytes_) {
+        return {};
+    }
+    return std::string_view(reinterpret_cast<const char*>(bytes_ + offset), length);
+}
+
+uint32_t TypeIndex::FindString(std::string_view name) const {
+    uint32_t lo = 0;
+    uint32_t hi = stringCount_;
+    while (lo < hi) {
+        const uint32_t mid = lo + (hi - lo) / 2;
+        if (String(mid) < name) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo < stringCount_ && String(lo) == name ? lo : kNoType;
+}
+
+TypeIndex::Type TypeIndex::GetType(uint32_t index) const {
+    const uint8_t* entry = types_ + static_cast<size_t>(index) * kTypeEntrySize;
+    Type type;
+    type.dumpOffset = ReadLe32(entry);
+    type.typeName = String(ReadLe32(entry + kTypeNameField));
+    type.fullName = String(ReadLe32(entry + kFullNameField));
+    type.baseName = String(ReadLe32(entry + kBaseNameField));
+    type.namespaceName = String(ReadLe32(entry + 16));
+    type.baseType = ReadLe32(entry + 20);
+    return type;
+}
+
+TypeIndex::TypeList TypeIndex::EqualRange(const uint8_t* table, size_t fieldOffset, uint32_t id) const {
+    const auto nameIdAt = [&](uint32_t position) {
+        const uint32_t typeIndex = ReadLe32(table + static_cast<size_t>(position) * 4);
+        return typeIndex < typeCount_ ? ReadLe32(types_ + static_cast<size_t>(typeIndex) * kTypeEntrySize + fieldOffset)
+                                      : kNoType;
+    };
+    const auto lowerBound = [&](uint32_t target) {
+        uint32_t lo = 0;
+        uint32_t hi = typeCount_;
+        while (lo < hi) {
+            const uint32_t mid = lo + (hi - lo) / 2;
+            if (nameIdAt(mid) < target) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        return lo;
+    };
+    const uint32_t first = lowerBound(id);
+    const uint32_t last = lowerBound(id + 1);
+    return TypeList(table + static_cast<size_t>(first) * 4, last - first);
+}
+
+TypeIndex::TypeList TypeIndex::FindByFullName(std::string_view fullName) const {
+    const uint32_t id = types_ != nullptr ? FindString(fullName) : kNoType;
+    return id == kNoType ? TypeList() : EqualRange(byFullName_, kFullNameField, id);
+}
+
+TypeIndex::TypeList TypeIndex::FindByBaseName(std::string_view baseName) const {
+    const uint32_t id = types_ != nullptr ? FindString(baseName) : kNoType;
+    return id == kNoType ? TypeList() : EqualRange(byBaseName_, kBaseNameField, id);
+}
+
+uint32_t TypeIndex::FindTypeAtOffset(uint32_t dumpOffset) const {
+    // Types are stored in dump offset order: find the first one starting after dumpOffset.
+    uint32_t lo = 0;
+    uint32_t hi = types_ != nullptr ? typeCount_ : 0;
+    while (lo < hi) {
+        const uint32_t mid = lo + (hi - lo) / 2;
+        if (ReadLe32(types_ + static_cast<size_t>(mid) * kTypeEntrySize) <= dumpOffset) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo == 0 ? kNoType : lo - 1;
+}
+
+TypeIndex::TypeList TypeIndex::DerivedTypes(uint32_t index) const {
+    if (index >= typeCount_) {
+        return {};
+    }
+    const uint8_t* entry = types_ + static_cast<size_t>(index) * kTypeEntrySize;
+    const uint32_t first = ReadLe32(entry + 24);
+    const uint32_t count = ReadLe32(entry + 28);
+    if (static_cast<uint64_t>(first) + count > derivedCount_) {
+        return {};
+    }
+    return TypeList(derived_ + static_cast<size_t>(first) * 4, count);
+}
+
+bool WriteTypeIndex(const std::string& path, const std::vector<TypeInfoRecord>& types, uint64_t dumpSize,
+                    uint64_t dumpMtime, std::string* error) {
+    const uint32_t typeCount = static_cast<uint32_t>(types.size());
+
+    // One sorted, deduplicated string table; ids are positions in it.
+    std::vector<std::string_view> strings;
+    strings.reserve(types.size() * 4);
+    for (const TypeInfoRecord& t : types) {
+        strings.insert(strings.end(), {t.typeName, t.fullName, t.baseName, t.namespaceName});
+    }
+    std::sort(strings.begin(), strings.end());
+    strings.erase(std::unique(strings.begin(), strings.end()), strings.end());
+    const auto idOf = [&](std::string_view s) {
+        return static_cast<uint32_t>(std::lower_bound(strings.begin(), strings.end(), s) - strings.begin());
+    };
+
+    struct Ids {
+        uint32_t typeName = 0;
+        uint32_t fullName = 0;
+        uint32_t baseName = 0;
+        uint32_t namespaceName = 0;
+    };
+    std::vector<Ids> ids(types.size());
+    for (size_t i = 0; i < types.size(); ++i) {
+        ids[i] = {idOf(types[i].typeName), idOf(types[i].fullName), idOf(types[i].baseName),
+                  idOf(types[i].namespaceName)};
+    }
+
+    // Name-sorted permutations. types is in offset order, so a stable sort keeps equal names in offset order too.
+    const auto sortedBy = [&](uint32_t Ids::*field) {
+        std::vector<uint32_t> order(types.size());
+        std::iota(order.begin(), order.end(), 0u);
+        std::stable_sort(order.begin(), order.end(),
+                         [&](uint32_t a, uint32_t b) { return ids[a].*field < ids[b].*field; });
+        return order;
+    };
+    const std::vector<uint32_t> byFullName = sortedBy(&Ids::fullName);
+    const std::vector<uint32_t> byBaseName = sortedBy(&Ids::baseName);
+    const std::vector<uint32_t> byTypeName = sortedBy(&Ids::typeName);
+
+    const auto firstWith = [&](const std::vector<uint32_t>& order, uint32_t Ids::*field, uint32_t id) {
+        const auto it = std::lower_bound(order.begin(), order.end(), id,
+                                         [&](uint32_t typeIndex, uint32_t value) { return ids[typeIndex].*field < value; });
+        return it != order.end() && ids[*it].*field == id ? *it : TypeIndex::kNoType;
+    };
+    std::vector<uint32_t> baseTypes(types.size(), TypeIndex::kNoType);
+    std::vector<uint32_t> derivedStarts(types.size() + 1, 0);
+    for (uint32_t i = 0; i < typeCount; ++i) {
+        if (types[i].baseName.empty()) {
+            continue;
+        }
+        uint32_t base = firstWith(byFullName, &Ids::fullName, ids[i].baseName);
+        if (base == TypeIndex::kNoType) {
+            base = firstWith(byTypeName, &Ids::typeName, ids[i].baseName);
+        }
+        if (base != TypeIndex::kNoType && base != i) {
+            baseTypes[i] = base;
+            ++derivedStarts[base + 1];
+        }
+    }
+    std::partial_sum(derivedStarts.begin(), derivedStarts.end(), derivedStarts.begin());
+    std::vector<uint32_t> derived(derivedStarts.back());
+    {
+        std::vector<uint32_t> cursor(derivedStarts.begin(), derivedStarts.end() - 1);
+        for (uint32_t i = 0; i < typeCount; ++i) {
+            if (baseTypes[i] != TypeIndex::kNoType) {
+                derived[cursor[baseTypes[i]]++] = i;
+            }
+        }
+    }
+
+    std::vector<uint8_t> tables;
+    std::vector<uint8_t> bytes;
+    tables.reserve(kHeaderSize + strings.size() * kStringEntrySize + types.size() * (kTypeEntrySize + 8) +
+                   derived.size() * 4);
+    tables.insert(tables.end(), kMagic, kMagic + sizeof(kMagic));
+    AppendLe16(&tables, TypeIndex::kVersion);
+    AppendLe16(&tables, 0);
+    AppendLe32(&tables, Clamp32(dumpSize));
+    AppendLe32(&tables, Clamp32(dumpMtime));
+    AppendLe32(&tables, typeCount);
+    AppendLe32(&tables, static_cast<uint32_t>(strings.size()));
+    AppendLe32(&tables, static_cast<uint32_t>(derived.size()));
+    size_t stringBytes = 0;
+    for (const std::string_view s : strings) {
+        stringBytes += s.size();
+    }
+    AppendLe32(&tables, static_cast<uint32_t>(stringBytes));
+
+    bytes.reserve(stringBytes);
+    for (const std::string_view s : strings) {
+        AppendLe32(&tables, static_cast<uint32_t>(bytes.size()));
+        AppendLe32(&tables, static_cast<uint32_t>(s.size()));
+        bytes.insert(bytes.end(), s.begin(), s.end());
+    }
+    for (uint32_t i = 0; i < typeCount; ++i) {
+        AppendLe32(&tables, Clamp32(types[i].offset));
+        AppendLe32(&tables, ids[i].typeName);
+        AppendLe32(&tables, ids[i].fullName);
+        AppendLe32(&tables, ids[i].baseName);
+        AppendLe32(&tables, ids[i].namespaceName);
+        AppendLe32(&tables, baseTypes[i]);
+        AppendLe32(&tables, derivedStarts[i]);
+        AppendLe32(&tables, derivedStarts[i + 1] - derivedStarts[i]);
+    }
+    const auto appendList = [&](const std::vector<uint32_t>& list) {
+        for (const uint32_t typeIndex : list) {
+            AppendLe32(&tables, typeIndex);
+        }
+    };
+    appendList(byFullName);
+    appendList(byBaseName);
+    appendList(derived);
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        SetError(error, "Failed to write " + path);
+        return false;
+    }
+    out.write(reinterpret_cast<const char*>(tables.data()), static_cast<std::streamsize>(tables.size()));
+    out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    if (!out) {
+        SetError(error, "Failed to write " + path);
+        return false;
+    }
+    return true;
+}
+
+} // namespace SwitchPort